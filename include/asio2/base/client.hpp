@@ -34,6 +34,8 @@
 #include <asio2/base/detail/util.hpp>
 #include <asio2/base/detail/buffer_wrap.hpp>
 #include <asio2/base/detail/ecs.hpp>
+#include <asio2/base/detail/function.hpp>
+#include <asio2/base/detail/awaitable.hpp>
 
 #include <asio2/base/impl/io_context_cp.hpp>
 #include <asio2/base/impl/thread_id_cp.hpp>
@@ -52,6 +54,7 @@
 #include <asio2/base/impl/condition_event_cp.hpp>
 #include <asio2/base/impl/reconnect_timer_cp.hpp>
 #include <asio2/base/impl/send_cp.hpp>
+#include <asio2/base/impl/metrics_cp.hpp>
 
 #include <asio2/component/rdc/rdc_call_cp.hpp>
 #include <asio2/component/socks/socks5_client_cp.hpp>
@@ -91,6 +94,7 @@ namespace asio2::detail
 		, public user_timer_cp         <derived_t, args_t>
 		, public connect_timeout_cp    <derived_t, args_t>
 		, public send_cp               <derived_t, args_t>
+		, public metrics_cp            <derived_t, args_t>
 		, public post_cp               <derived_t, args_t>
 		, public condition_event_cp    <derived_t, args_t>
 		, public rdc_call_cp           <derived_t, args_t>
@@ -139,6 +143,7 @@ namespace asio2::detail
 			, user_timer_cp       <derived_t, args_t>()
 			, connect_timeout_cp  <derived_t, args_t>()
 			, send_cp             <derived_t, args_t>()
+			, metrics_cp          <derived_t, args_t>()
 			, post_cp             <derived_t, args_t>()
 			, condition_event_cp  <derived_t, args_t>()
 			, rdc_call_cp         <derived_t, args_t>()
@@ -153,6 +158,8 @@ namespace asio2::detail
 			static_assert(decltype(wallocator_)::storage_size == ASIO2_ALLOCATOR_STORAGE_SIZE);
 		#endif
 		#endif
+
+			this->io_->sessions()++;
 		}
 
 		/**
@@ -160,6 +167,9 @@ namespace asio2::detail
 		 */
 		~client_impl_t()
 		{
+			// the io_ maybe reseted by destroy()
+			if (this->io_)
+				this->io_->sessions()--;
 		}
 
 		/**
@@ -248,6 +258,10 @@ namespace asio2::detail
 			derived_t& derive = this->derived();
 
 			derive.socket_.reset();
+
+			if (derive.io_)
+				derive.io_->sessions()--;
+
 			derive.io_.reset();
 			derive.listener_.clear();
 
@@ -317,6 +331,58 @@ namespace asio2::detail
 		inline const char*                  life_id () noexcept { return this->life_id_.get(); }
 		inline void                   reset_life_id () noexcept { this->life_id_ = std::make_unique<char>(); }
 
+		inline void _fire_send_pressure(std::shared_ptr<derived_t>& this_ptr, bool paused)
+		{
+			// the _fire_send_pressure must be executed in the thread 0.
+			ASIO2_ASSERT(this->io_->running_in_this_thread());
+
+			detail::ignore_unused(this_ptr);
+
+			this->listener_.notify(event_type::send_pressure, bool(paused));
+		}
+
+		/**
+		 * @brief async start the client in a coroutine, the last one of the args is the
+		 * completion token, the others are passed to the derived async_start.
+		 * Completion signature : void(asio::error_code ec)
+		 */
+		template<typename String, typename StrOrInt, typename... Args>
+		inline auto _async_start_with_token(String&& host, StrOrInt&& port, Args&&... args)
+		{
+			return this->_async_start_with_token_impl(std::make_index_sequence<sizeof...(Args) - 1>{},
+				std::forward_as_tuple(std::forward<String>(host), std::forward<StrOrInt>(port),
+					std::forward<Args>(args)...));
+		}
+
+		template<std::size_t... I, typename Tuple>
+		inline auto _async_start_with_token_impl(std::index_sequence<I...>, Tuple&& tp)
+		{
+			using token_type = std::tuple_element_t<sizeof...(I) + 2, detail::remove_cvref_t<Tuple>>;
+
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			return asio::async_initiate<token_type, void(error_code)>(
+			[&derive](auto handler, auto&&... args) mutable
+			{
+				// the handler is moved into the connect completion by _do_connect, if the connect
+				// event isn't posted at all (eg: the iopool is not started), complete it here.
+				derive.start_handler_ = [&derive, handler = std::move(handler)](const error_code& ec) mutable
+				{
+					detail::awaitable_complete(std::move(handler), derive.io_->context().get_executor(), ec);
+				};
+
+				derive.async_start(std::move(args)...);
+
+				if (derive.start_handler_)
+				{
+					auto fn = std::move(derive.start_handler_);
+
+					fn(get_last_error());
+				}
+			}, std::get<sizeof...(I) + 2>(tp), std::get<0>(std::move(tp)), std::get<1>(std::move(tp)),
+				std::get<I + 2>(std::move(tp))...);
+		}
+
 	protected:
 		/// The memory to use for handler-based custom memory allocation. used fo recv/read.
 		handler_memory<std::true_type , assizer<args_t>>   rallocator_;
@@ -347,6 +413,10 @@ namespace asio2::detail
 		/// Whether the async_read... is called.
 		bool                                        reading_ = false;
 
+		/// The completion handler of the async_start which is called with a completion token,
+		/// it is moved into the connect completion by _do_connect.
+		detail::function<void(const error_code&)>   start_handler_;
+
 		/// Used to solve this problem:
 		/// 
 		/// client_ptr->bind_connect([client_ptr]()
@@ -33,6 +33,7 @@ namespace asio2::detail
 	                                             KEYWORD data_filter_before_helper; \
 	template <class, class>                      KEYWORD iopool_cp;                 \
 	template <class, class>                      KEYWORD alive_time_cp;             \
+	template <class, class>                      KEYWORD async_recv_cp;             \
 	template <class, class>                      KEYWORD condition_event_cp;        \
 	template <class, class>                      KEYWORD connect_cp;                \
 	template <class, class>                      KEYWORD connect_time_cp;           \
@@ -42,6 +43,7 @@ namespace asio2::detail
 	template <class, class>                      KEYWORD close_cp;                  \
 	template <class, class>                      KEYWORD disconnect_cp;             \
 	template <class, class>                      KEYWORD event_queue_cp;            \
+	template <class, class>                      KEYWORD metrics_cp;                \
 	template <class       >                      KEYWORD event_queue_guard;         \
 	template <class, class>                      KEYWORD post_cp;                   \
 	template <class, class>                      KEYWORD rdc_call_cp;               \
@@ -64,6 +66,8 @@ namespace asio2::detail
 	template <class, class>                      KEYWORD tcp_keepalive_cp;          \
 	template <class, class>                      KEYWORD tcp_recv_op;               \
 	template <class, class>                      KEYWORD tcp_send_op;               \
+	template <class, class>                      KEYWORD tcp_send_file_cp;          \
+	template <class, class>                      KEYWORD tcp_send_zerocopy_cp;      \
 	template <class, class>                      KEYWORD ws_stream_cp;              \
 	template <class, class>                      KEYWORD http_recv_op;              \
 	template <class, class>                      KEYWORD http_send_op;              \
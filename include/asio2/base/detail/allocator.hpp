@@ -15,7 +15,10 @@
 #pragma once
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
+#include <cstddef>
 #include <memory>
+#include <array>
+#include <algorithm>
 #include <type_traits>
 #include <utility>
 #include <atomic>
@@ -24,6 +27,17 @@
 #include <asio2/config.hpp>
 #include <asio2/base/log.hpp>
 
+#include <asio2/base/detail/tracer.hpp>
+#include <asio2/base/detail/metrics.hpp>
+
+/*
+ * the max bytes of the free blocks which are cached by each size class of the per thread handler
+ * memory pool, the larger blocks are freed to the heap directly, see handler_memory_pool.
+ */
+#ifndef ASIO2_HANDLER_MEMORY_POOL_CACHE_SIZE
+#define ASIO2_HANDLER_MEMORY_POOL_CACHE_SIZE (256 * 1024)
+#endif
+
 namespace asio2::detail
 {
 #if defined(ASIO2_ENABLE_LOG) && defined(ASIO2_ENABLE_LOG_STORAGE_SIZE)
@@ -286,11 +300,147 @@ namespace asio2::detail
 		}
 	}
 
+	/**
+	 * @brief The per thread free lists of the memory blocks which are used by the handler_memory
+	 * when the handler can't use the single block of storage, eg: the handler is larger than the
+	 * storage or the storage is in use. The blocks are rounded up to the power of 2 size classes
+	 * from 64 bytes to 64 KB, the larger blocks are allocated from the heap directly.
+	 * A block can be deallocated in a thread which is different from the allocating thread, it
+	 * is cached by the deallocating thread then.
+	 */
+	class handler_memory_pool
+	{
+	public:
+		static constexpr std::size_t min_class_shift = 6;
+		static constexpr std::size_t max_class_shift = 16;
+		static constexpr std::size_t class_count     = max_class_shift - min_class_shift + 1;
+
+		/**
+		 * @brief get the size class index of the size, return class_count if the size is too large.
+		 */
+		static inline std::size_t class_index(std::size_t size) noexcept
+		{
+			std::size_t i = 0;
+
+			for (std::size_t n = (std::size_t(1) << min_class_shift); n < size; n <<= 1)
+			{
+				if (++i == class_count)
+					break;
+			}
+
+			return i;
+		}
+
+		static inline constexpr std::size_t class_size(std::size_t index) noexcept
+		{
+			return (std::size_t(1) << (min_class_shift + index));
+		}
+
+		/**
+		 * @brief allocate a block, the heap is set to true if the block is allocated from the heap.
+		 */
+		static inline void* allocate(std::size_t size, bool& heap)
+		{
+			std::size_t i = class_index(size);
+
+			heap = true;
+
+			if (i == class_count)
+				return ::operator new(size);
+
+			if (handler_memory_pool* pool = handler_memory_pool::current(); pool)
+			{
+				if (node* p = pool->heads_[i]; p)
+				{
+					pool->heads_[i] = p->next;
+					pool->sizes_[i]--;
+
+					heap = false;
+
+					return p;
+				}
+			}
+
+			return ::operator new(class_size(i));
+		}
+
+		static inline void deallocate(void* pointer, std::size_t size) noexcept
+		{
+			std::size_t i = class_index(size);
+
+			if (i != class_count)
+			{
+				handler_memory_pool* pool = handler_memory_pool::current();
+
+				if (pool && pool->sizes_[i] < (std::max)(std::size_t(ASIO2_HANDLER_MEMORY_POOL_CACHE_SIZE)
+					/ class_size(i), std::size_t(1)))
+				{
+					node* p = static_cast<node*>(pointer);
+
+					p->next = pool->heads_[i];
+
+					pool->heads_[i] = p;
+					pool->sizes_[i]++;
+
+					return;
+				}
+			}
+
+			::operator delete(pointer);
+		}
+
+		~handler_memory_pool()
+		{
+			for (node* p : this->heads_)
+			{
+				while (p)
+				{
+					node* next = p->next;
+					::operator delete(p);
+					p = next;
+				}
+			}
+
+			handler_memory_pool::destroyed() = true;
+		}
+
+	protected:
+		struct node
+		{
+			node* next;
+		};
+
+		/**
+		 * @brief get the pool of the current thread, return nullptr if the thread is exiting and
+		 * the pool is destroyed already.
+		 */
+		static inline handler_memory_pool* current() noexcept
+		{
+			if (handler_memory_pool::destroyed())
+				return nullptr;
+
+			thread_local handler_memory_pool pool;
+
+			return &pool;
+		}
+
+		static inline bool& destroyed() noexcept
+		{
+			thread_local bool v = false;
+
+			return v;
+		}
+
+	protected:
+		std::array<node*      , class_count> heads_{};
+		std::array<std::size_t, class_count> sizes_{};
+	};
+
 	/**
 	 * @brief Class to manage the memory to be used for handler-based custom allocation.
 	 * It contains a single block of memory which may be returned for allocation
 	 * requests. If the memory is in use when an allocation request is made, the
-	 * allocator delegates allocation to the global heap.
+	 * allocator delegates allocation to the handler_memory_pool of the current thread.
 	 * @tparam IsLockFree - is lock free or not.
 	 * @tparam SizeN - the single block of memory size.
 	 */
@@ -303,7 +453,7 @@ namespace asio2::detail
 	 * @brief Class to manage the memory to be used for handler-based custom allocation.
 	 * It contains a single block of memory which may be returned for allocation
 	 * requests. If the memory is in use when an allocation request is made, the
-	 * allocator delegates allocation to the global heap.
+	 * allocator delegates allocation to the handler_memory_pool of the current thread.
 	 * @tparam IsLockFree - is lock free or not.
 	 * @tparam SizeN - the single block of memory size.
 	 */
@@ -330,6 +480,11 @@ namespace asio2::detail
 				log_allocator_storage_size(true, true, size);
 			#endif
 
+			#if defined(ASIO2_ENABLE_METRICS)
+				this->stats_.hits.store(this->stats_.hits.load(std::memory_order_relaxed) + 1,
+					std::memory_order_relaxed);
+			#endif
+
 				in_use_ = true;
 				return &storage_;
 			}
@@ -339,11 +494,22 @@ namespace asio2::detail
 				log_allocator_storage_size(true, false, size);
 			#endif
 
-				return ::operator new(size);
+				bool heap = false;
+				void* p = handler_memory_pool::allocate(size, heap);
+
+			#if defined(ASIO2_ENABLE_METRICS)
+				this->stats_.misses.store(this->stats_.misses.load(std::memory_order_relaxed) + 1,
+					std::memory_order_relaxed);
+				if (heap)
+					this->stats_.heap.store(this->stats_.heap.load(std::memory_order_relaxed) + 1,
+						std::memory_order_relaxed);
+			#endif
+
+				return p;
 			}
 		}
 
-		inline void deallocate(void* pointer) noexcept
+		inline void deallocate(void* pointer, std::size_t size) noexcept
 		{
 			// must erase when deallocate, otherwise if call server.stop -> server.start
 			// then the test map will incorrect.
@@ -357,23 +523,39 @@ namespace asio2::detail
 			}
 			else
 			{
-				::operator delete(pointer);
+				handler_memory_pool::deallocate(pointer, size);
 			}
 		}
 
+	#if defined(ASIO2_ENABLE_METRICS)
+		/**
+		 * @brief get the hit and miss counters of the single block of storage.
+		 */
+		inline allocator_stats stats() const noexcept
+		{
+			return this->stats_.snapshot();
+		}
+	#endif
+
 	private:
 		// Storage space used for handler-based custom memory allocation.
 		typename std::aligned_storage<storage_size + sizeof(void*)>::type storage_{};
 
 		// Whether the handler-based custom allocation storage has been used.
 		bool in_use_{};
+
+	#if defined(ASIO2_ENABLE_METRICS)
+		// Only written in the thread which uses this memory, so the counters are not incremented
+		// by the atomic read-modify-write.
+		allocator_counters stats_;
+	#endif
 	};
 
 	/**
 	 * @brief Class to manage the memory to be used for handler-based custom allocation.
 	 * It contains a single block of memory which may be returned for allocation
 	 * requests. If the memory is in use when an allocation request is made, the
-	 * allocator delegates allocation to the global heap.
+	 * allocator delegates allocation to the handler_memory_pool of the current thread.
 	 * @tparam IsLockFree - is lock free or not.
 	 * @tparam SizeN - the single block of memory size.
 	 */
@@ -396,6 +578,10 @@ namespace asio2::detail
 				log_allocator_storage_size(false, true, size);
 			#endif
 
+			#if defined(ASIO2_ENABLE_METRICS)
+				this->stats_.hits.fetch_add(1, std::memory_order_relaxed);
+			#endif
+
 				return &storage_;
 			}
 			else
@@ -404,11 +590,20 @@ namespace asio2::detail
 				log_allocator_storage_size(false, false, size);
 			#endif
 
-				return ::operator new(size);
+				bool heap = false;
+				void* p = handler_memory_pool::allocate(size, heap);
+
+			#if defined(ASIO2_ENABLE_METRICS)
+				this->stats_.misses.fetch_add(1, std::memory_order_relaxed);
+				if (heap)
+					this->stats_.heap.fetch_add(1, std::memory_order_relaxed);
+			#endif
+
+				return p;
 			}
 		}
 
-		inline void deallocate(void* pointer) noexcept
+		inline void deallocate(void* pointer, std::size_t size) noexcept
 		{
 			if (pointer == &storage_)
 			{
@@ -416,16 +611,30 @@ namespace asio2::detail
 			}
 			else
 			{
-				::operator delete(pointer);
+				handler_memory_pool::deallocate(pointer, size);
 			}
 		}
 
+	#if defined(ASIO2_ENABLE_METRICS)
+		/**
+		 * @brief get the hit and miss counters of the single block of storage.
+		 */
+		inline allocator_stats stats() const noexcept
+		{
+			return this->stats_.snapshot();
+		}
+	#endif
+
 	private:
 		// Storage space used for handler-based custom memory allocation.
 		typename std::aligned_storage<storage_size + sizeof(void*)>::type storage_{};
 
 		// Whether the handler-based custom allocation storage has been used.
 		std::atomic_flag in_use_{};
+
+	#if defined(ASIO2_ENABLE_METRICS)
+		allocator_counters stats_;
+	#endif
 	};
 
 #if defined(ASIO2_ENABLE_LOG)
@@ -467,9 +676,9 @@ namespace asio2::detail
 			return static_cast<T*>(memory_.allocate(sizeof(T) * n));
 		}
 
-		inline void deallocate(T* p, std::size_t /*n*/) const noexcept
+		inline void deallocate(T* p, std::size_t n) const noexcept
 		{
-			return memory_.deallocate(p);
+			return memory_.deallocate(p, sizeof(T) * n);
 		}
 
 	private:
@@ -503,6 +712,10 @@ namespace asio2::detail
 		template <typename ...Args>
 		inline void operator()(Args&&... args)
 		{
+		#if defined(ASIO2_ENABLE_TRACE)
+			trace_scope scope(handler_trace_site<Handler>::value);
+		#endif
+
 			handler_(std::forward<Args>(args)...);
 		}
 
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2017-2023 zhllxt
+ *
+ * author   : zhllxt
+ * email    : 37792738@qq.com
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef __ASIO2_AWAITABLE_HPP__
+#define __ASIO2_AWAITABLE_HPP__
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+
+#include <asio2/external/asio.hpp>
+
+#include <asio2/base/detail/type_traits.hpp>
+
+namespace asio2::detail
+{
+	/**
+	 * @brief Check whether the type is a completion token which turns the asynchronous function
+	 * into an awaitable, eg: asio::use_awaitable, asio::as_tuple(asio::use_awaitable) or
+	 * asio::redirect_error(asio::use_awaitable, ec). It is always false when the compiler
+	 * has no coroutine support.
+	 */
+	template<class T>
+	struct is_awaitable_token : std::false_type {};
+
+#if defined(ASIO_HAS_CO_AWAIT)
+	template<class Executor>
+	struct is_awaitable_token<asio::use_awaitable_t<Executor>> : std::true_type {};
+
+	template<class T>
+	struct is_awaitable_token<asio::as_tuple_t<T>> : is_awaitable_token<T> {};
+
+	template<class T>
+	struct is_awaitable_token<asio::redirect_error_t<T>> : is_awaitable_token<T> {};
+#endif
+
+	template<class T>
+	inline constexpr bool is_awaitable_token_v = is_awaitable_token<remove_cvref_t<T>>::value;
+
+	/**
+	 * @brief Check whether the last type of the parameter pack is an awaitable completion token.
+	 */
+	template<class... Ts>
+	struct is_last_awaitable_token : std::false_type {};
+
+	template<class T>
+	struct is_last_awaitable_token<T> : std::bool_constant<is_awaitable_token_v<T>> {};
+
+	template<class T, class... Ts>
+	struct is_last_awaitable_token<T, Ts...> : is_last_awaitable_token<Ts...> {};
+
+	template<class... Ts>
+	inline constexpr bool is_last_awaitable_token_v = is_last_awaitable_token<Ts...>::value;
+
+	/**
+	 * @brief Call the completion handler of an awaitable operation with the result.
+	 * The handler is dispatched to its associated executor, when the coroutine was spawned on
+	 * the io_context which is calling this function, the coroutine is resumed in place, without
+	 * a post to the io_context.
+	 */
+	template<class Handler, class Executor, class... Args>
+	inline void awaitable_complete(Handler&& handler, const Executor& ex, Args&&... args)
+	{
+		auto hex = asio::get_associated_executor(handler, ex);
+
+		asio::dispatch(hex,
+		[handler = std::forward<Handler>(handler), args = std::make_tuple(std::forward<Args>(args)...)]
+		() mutable
+		{
+			std::apply(std::move(handler), std::move(args));
+		});
+	}
+}
+
+#endif // !__ASIO2_AWAITABLE_HPP__
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2017-2023 zhllxt
+ *
+ * author   : zhllxt
+ * email    : 37792738@qq.com
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef __ASIO2_BUFFER_POOL_HPP__
+#define __ASIO2_BUFFER_POOL_HPP__
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <cstddef>
+#include <memory>
+
+#include <asio2/external/asio.hpp>
+
+#include <asio2/base/detail/object_pool.hpp>
+
+/*
+ * the max bytes of the free receive buffers of each size class in the buffer pool of an
+ * io_context, the buffers which exceed it are returned to the system, so the memory used
+ * by a traffic spike is not held forever.
+ */
+#ifndef ASIO2_BUFFER_POOL_MAX_BYTES
+#define ASIO2_BUFFER_POOL_MAX_BYTES (std::size_t(4) * 1024 * 1024)
+#endif
+
+namespace asio2::detail
+{
+	/**
+	 * @brief The allocator of the receive buffers, the size is rounded up to the power of two,
+	 * then the memory is allocated from the buffer pool of the io_context, if the allocator
+	 * has no pool, the memory is allocated from the system directly.
+	 */
+	template<class T>
+	class buffer_pool_allocator
+	{
+		template<class> friend class buffer_pool_allocator;
+
+	public:
+		using value_type = T;
+
+		buffer_pool_allocator() noexcept = default;
+
+		explicit buffer_pool_allocator(std::shared_ptr<object_pool> pool) noexcept : pool_(std::move(pool))
+		{
+		}
+
+		template<class U>
+		buffer_pool_allocator(const buffer_pool_allocator<U>& other) noexcept : pool_(other.pool_)
+		{
+		}
+
+		inline T* allocate(std::size_t n)
+		{
+			if (!this->pool_)
+				return std::allocator<T>().allocate(n);
+
+			return static_cast<T*>(this->pool_->allocate(size_class(n * sizeof(T)), alignof(T)));
+		}
+
+		inline void deallocate(T* p, std::size_t n) noexcept
+		{
+			if (!this->pool_)
+				return std::allocator<T>().deallocate(p, n);
+
+			this->pool_->deallocate(p, size_class(n * sizeof(T)), alignof(T));
+		}
+
+		/**
+		 * @brief get the pool which the memory is allocated from.
+		 */
+		inline const std::shared_ptr<object_pool>& pool() const noexcept
+		{
+			return this->pool_;
+		}
+
+		template<class U>
+		inline bool operator==(const buffer_pool_allocator<U>& other) const noexcept
+		{
+			return this->pool_ == other.pool_;
+		}
+
+		template<class U>
+		inline bool operator!=(const buffer_pool_allocator<U>& other) const noexcept
+		{
+			return this->pool_ != other.pool_;
+		}
+
+		/**
+		 * @brief round the size up to the power of two, the min size is 256 bytes.
+		 */
+		static inline std::size_t size_class(std::size_t size) noexcept
+		{
+			std::size_t n = 256;
+
+			while (n < size)
+				n <<= 1;
+
+			return n;
+		}
+
+	protected:
+		std::shared_ptr<object_pool> pool_;
+	};
+
+	/**
+	 * @brief The streambuf of the tcp sessions, it is the same as the asio::streambuf when the
+	 * buffer pool is not used.
+	 */
+	using pooled_streambuf = asio::basic_streambuf<buffer_pool_allocator<char>>;
+}
+
+#endif // !__ASIO2_BUFFER_POOL_HPP__
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2017-2023 zhllxt
+ *
+ * author   : zhllxt
+ * email    : 37792738@qq.com
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef __ASIO2_BUSY_POLL_HPP__
+#define __ASIO2_BUSY_POLL_HPP__
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <chrono>
+
+#include <asio2/base/error.hpp>
+
+#include <asio2/base/detail/util.hpp>
+
+namespace asio2::detail
+{
+	/**
+	 * @brief check whether the SO_BUSY_POLL socket option is supported by the current system.
+	 */
+	constexpr bool is_busy_poll_supported() noexcept
+	{
+	#if defined(SO_BUSY_POLL)
+		return true;
+	#else
+		return false;
+	#endif
+	}
+
+	/**
+	 * @brief set the SO_BUSY_POLL option, the kernel polls the device queue for the socket
+	 * for the specified time when there is no data in the receive queue, instead of waiting
+	 * for the interrupt. 0 means disable.
+	 * @note the time which is greater than /proc/sys/net/core/busy_read requires CAP_NET_ADMIN.
+	 */
+	template<class SocketT>
+	inline bool set_busy_poll(SocketT& socket, std::chrono::microseconds usec, error_code& ec) noexcept
+	{
+	#if defined(SO_BUSY_POLL)
+		socket.set_option(asio::detail::socket_option::integer<SOL_SOCKET, SO_BUSY_POLL>(
+			static_cast<int>(usec.count())), ec);
+	#else
+		detail::ignore_unused(socket, usec);
+		ec = asio::error::operation_not_supported;
+	#endif
+		return !ec;
+	}
+}
+
+#endif // !__ASIO2_BUSY_POLL_HPP__
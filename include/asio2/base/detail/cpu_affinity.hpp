@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2017-2023 zhllxt
+ *
+ * author   : zhllxt
+ * email    : 37792738@qq.com
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef __ASIO2_CPU_AFFINITY_HPP__
+#define __ASIO2_CPU_AFFINITY_HPP__
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <tuple>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+
+#include <asio2/external/predef.h>
+
+#include <asio2/base/detail/util.hpp>
+
+#if ASIO2_OS_LINUX
+#	include <sched.h>
+#	include <pthread.h>
+#elif ASIO2_OS_MACOS
+#	include <pthread.h>
+#elif ASIO2_OS_WINDOWS
+#	include <windows.h>
+#endif
+
+namespace asio2::detail
+{
+	/**
+	 * @brief the location of a logical cpu.
+	 */
+	struct cpu_info
+	{
+		int cpu     = 0;  // the logical cpu id
+		int package = 0;  // the physical socket id
+		int core    = 0;  // the physical core id in the socket
+		int node    = 0;  // the numa node id
+	};
+
+#if ASIO2_OS_LINUX
+	inline int read_cpu_topology_value(const std::string& path, int default_value) noexcept
+	{
+		std::ifstream file(path);
+
+		int value = default_value;
+
+		if (file)
+			file >> value;
+
+		return file ? value : default_value;
+	}
+#endif
+
+	/**
+	 * @brief get the location of the logical cpus which the current process is allowed to run on,
+	 * sorted by numa node, socket, physical core and logical cpu.
+	 */
+	inline std::vector<cpu_info> get_cpu_topology()
+	{
+		std::vector<cpu_info> cpus;
+
+	#if ASIO2_OS_LINUX
+		cpu_set_t set;
+		CPU_ZERO(&set);
+
+		if (sched_getaffinity(0, sizeof(set), &set) != 0)
+			return cpus;
+
+		for (int i = 0; i < CPU_SETSIZE; ++i)
+		{
+			if (!CPU_ISSET(i, &set))
+				continue;
+
+			std::string dir = "/sys/devices/system/cpu/cpu" + std::to_string(i);
+
+			cpu_info info;
+
+			info.cpu     = i;
+			info.package = read_cpu_topology_value(dir + "/topology/physical_package_id", 0);
+			info.core    = read_cpu_topology_value(dir + "/topology/core_id", i);
+
+			// the cpu directory has a "nodeN" link to the numa node which the cpu belongs to.
+			std::error_code ec;
+			for (const auto& entry : std::filesystem::directory_iterator(dir, ec))
+			{
+				std::string name = entry.path().filename().string();
+
+				if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+					std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; }))
+				{
+					info.node = std::stoi(name.substr(4));
+					break;
+				}
+			}
+
+			cpus.emplace_back(info);
+		}
+	#elif ASIO2_OS_WINDOWS
+		DWORD_PTR process_mask = 0, system_mask = 0;
+
+		if (::GetProcessAffinityMask(::GetCurrentProcess(), &process_mask, &system_mask))
+		{
+			for (int i = 0; i < int(sizeof(DWORD_PTR) * 8); ++i)
+			{
+				if (process_mask & (DWORD_PTR(1) << i))
+				{
+					cpu_info info;
+					info.cpu  = i;
+					info.core = i;
+					cpus.emplace_back(info);
+				}
+			}
+		}
+	#endif
+
+		std::sort(cpus.begin(), cpus.end(), [](const cpu_info& a, const cpu_info& b)
+		{
+			return std::tie(a.node, a.package, a.core, a.cpu) < std::tie(b.node, b.package, b.core, b.cpu);
+		});
+
+		return cpus;
+	}
+
+	/**
+	 * @brief get one logical cpu of each physical core, the hyper threads are skipped.
+	 */
+	inline std::vector<int> get_physical_core_cpus(const std::vector<cpu_info>& cpus)
+	{
+		std::vector<int> v;
+
+		for (std::size_t i = 0; i < cpus.size(); ++i)
+		{
+			if (i > 0 && cpus[i].node == cpus[i - 1].node &&
+				cpus[i].package == cpus[i - 1].package && cpus[i].core == cpus[i - 1].core)
+				continue;
+
+			v.emplace_back(cpus[i].cpu);
+		}
+
+		return v;
+	}
+
+	/**
+	 * @brief get the logical cpus of each numa node.
+	 */
+	inline std::vector<std::vector<int>> get_numa_node_cpus(const std::vector<cpu_info>& cpus)
+	{
+		std::vector<std::vector<int>> v;
+
+		for (std::size_t i = 0; i < cpus.size(); ++i)
+		{
+			if (i == 0 || cpus[i].node != cpus[i - 1].node)
+				v.emplace_back();
+
+			v.back().emplace_back(cpus[i].cpu);
+		}
+
+		return v;
+	}
+
+	/**
+	 * @brief bind the current thread to the cpus.
+	 */
+	inline bool set_current_thread_affinity(const std::vector<int>& cpus) noexcept
+	{
+		if (cpus.empty())
+			return false;
+
+	#if ASIO2_OS_LINUX
+		cpu_set_t set;
+		CPU_ZERO(&set);
+
+		for (int cpu : cpus)
+		{
+			if (cpu >= 0 && cpu < CPU_SETSIZE)
+				CPU_SET(cpu, &set);
+		}
+
+		return (sched_setaffinity(0, sizeof(set), &set) == 0);
+	#elif ASIO2_OS_WINDOWS
+		DWORD_PTR mask = 0;
+
+		for (int cpu : cpus)
+		{
+			if (cpu >= 0 && cpu < int(sizeof(DWORD_PTR) * 8))
+				mask |= (DWORD_PTR(1) << cpu);
+		}
+
+		return (mask != 0 && ::SetThreadAffinityMask(::GetCurrentThread(), mask) != 0);
+	#else
+		return false;
+	#endif
+	}
+
+	/**
+	 * @brief get the numa node of the cpu which the current thread is running on.
+	 * @return -1 if it is unknown.
+	 */
+	inline int get_current_numa_node(const std::vector<cpu_info>& cpus) noexcept
+	{
+	#if ASIO2_OS_LINUX
+		int cpu = sched_getcpu();
+
+		for (const cpu_info& info : cpus)
+		{
+			if (info.cpu == cpu)
+				return info.node;
+		}
+	#else
+		detail::ignore_unused(cpus);
+	#endif
+
+		return -1;
+	}
+
+	/**
+	 * @brief set the name of the current thread, it is displayed in the debugger, top, perf.
+	 * @note the name is truncated to 15 characters on linux.
+	 */
+	inline void set_current_thread_name(const std::string& name)
+	{
+		if (name.empty())
+			return;
+
+	#if ASIO2_OS_LINUX
+		std::string s = name.substr(0, 15);
+		pthread_setname_np(pthread_self(), s.data());
+	#elif ASIO2_OS_MACOS
+		pthread_setname_np(name.data());
+	#elif ASIO2_OS_WINDOWS
+		// the SetThreadDescription is supported since windows 10 1607.
+		using fun_type = HRESULT(WINAPI*)(HANDLE, PCWSTR);
+
+		HMODULE module = ::GetModuleHandleW(L"kernel32.dll");
+
+		if (fun_type fun = module ? reinterpret_cast<fun_type>(
+			::GetProcAddress(module, "SetThreadDescription")) : nullptr; fun)
+		{
+			std::wstring ws(name.begin(), name.end());
+			fun(::GetCurrentThread(), ws.data());
+		}
+	#endif
+	}
+
+	/**
+	 * @brief get the name of the current thread, return empty if it is unknown.
+	 */
+	inline std::string get_current_thread_name()
+	{
+	#if ASIO2_OS_LINUX || ASIO2_OS_MACOS
+		char buf[64]{};
+		if (pthread_getname_np(pthread_self(), buf, sizeof(buf)) == 0)
+			return std::string(buf);
+	#endif
+		return std::string{};
+	}
+}
+
+#endif // !__ASIO2_CPU_AFFINITY_HPP__
@@ -0,0 +1,646 @@
+/*
+ * Copyright (c) 2017-2023 zhllxt
+ *
+ * author   : zhllxt
+ * email    : 37792738@qq.com
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef __ASIO2_METRICS_HPP__
+#define __ASIO2_METRICS_HPP__
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+/*
+ * the metrics of the io_context, the session manager and the sessions and clients are only
+ * compiled when ASIO2_ENABLE_METRICS is defined, otherwise all the counters and the functions
+ * like io_t::metrics, server::get_metrics are removed completely.
+ */
+#if defined(ASIO2_ENABLE_METRICS)
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <array>
+#include <vector>
+#include <chrono>
+#include <string>
+#include <string_view>
+
+#include <asio2/base/error.hpp>
+
+namespace asio2::detail
+{
+	/**
+	 * @brief the reason why a session was disconnected, see to_disconnect_reason
+	 */
+	enum class disconnect_reason : std::uint8_t
+	{
+		/// closed by this side, eg: session.stop() or server.stop()
+		local,
+
+		/// closed by the peer gracefully.
+		eof,
+
+		/// the connection was reset or aborted.
+		reset,
+
+		/// closed by the silence timer or the connect timeout timer.
+		timeout,
+
+		/// closed by the send budget, see send_policy::disconnect
+		send_budget,
+
+		/// the other errors, eg: protocol errors.
+		error,
+
+		max,
+	};
+
+	template<typename = void>
+	inline constexpr std::string_view to_string(disconnect_reason v)
+	{
+		using namespace std::string_view_literals;
+		switch (v)
+		{
+		case disconnect_reason::local       : return "local";
+		case disconnect_reason::eof         : return "eof";
+		case disconnect_reason::reset       : return "reset";
+		case disconnect_reason::timeout     : return "timeout";
+		case disconnect_reason::send_budget : return "send_budget";
+		case disconnect_reason::error       : return "error";
+		default                             : return "none";
+		}
+		return "none";
+	}
+
+	/**
+	 * @brief classify the error code which the session was disconnected with.
+	 */
+	inline disconnect_reason to_disconnect_reason(const error_code& ec) noexcept
+	{
+		if (!ec || ec == asio::error::operation_aborted || ec == asio::error::shut_down)
+			return disconnect_reason::local;
+		if (ec == asio::error::eof)
+			return disconnect_reason::eof;
+		if (ec == asio::error::connection_reset || ec == asio::error::connection_aborted ||
+			ec == asio::error::broken_pipe)
+			return disconnect_reason::reset;
+		if (ec == asio::error::timed_out)
+			return disconnect_reason::timeout;
+		if (ec == asio::error::no_buffer_space)
+			return disconnect_reason::send_budget;
+		return disconnect_reason::error;
+	}
+
+	/**
+	 * @brief The snapshot of a latency histogram, the bucket i counts the latencies in the
+	 * range [2^i, 2^(i+1)) nanoseconds, the bucket 0 counts the latencies less than 2ns too,
+	 * and the last bucket counts all the latencies which are greater than it.
+	 */
+	struct latency_histogram
+	{
+		static constexpr std::size_t bucket_count = 40;
+
+		std::array<std::uint64_t, bucket_count> buckets{};
+
+		/// the count of all the recorded latencies.
+		std::uint64_t count    = 0;
+
+		/// the sum of all the recorded latencies in nanoseconds.
+		std::uint64_t total_ns = 0;
+
+		/// the max recorded latency in nanoseconds.
+		std::uint64_t max_ns   = 0;
+
+		/**
+		 * @brief get the upper bound of the bucket in nanoseconds.
+		 */
+		static constexpr std::uint64_t bucket_upper_ns(std::size_t i) noexcept
+		{
+			return std::uint64_t(1) << (i + 1);
+		}
+
+		/**
+		 * @brief get the average latency in nanoseconds.
+		 */
+		inline double mean_ns() const noexcept
+		{
+			return count ? double(total_ns) / double(count) : 0.0;
+		}
+
+		/**
+		 * @brief get the approximate percentile latency in nanoseconds, it is the upper bound
+		 * of the bucket which contains the percentile, and never greater than the max latency.
+		 * @param p - the percentile, in the range [0.0, 1.0], eg: 0.99
+		 */
+		inline std::uint64_t percentile_ns(double p) const noexcept
+		{
+			if (count == 0)
+				return 0;
+
+			p = (p < 0.0 ? 0.0 : (p > 1.0 ? 1.0 : p));
+
+			std::uint64_t rank = std::uint64_t(p * double(count) + 0.5);
+
+			if (rank == 0)
+				rank = 1;
+
+			std::uint64_t n = 0;
+
+			for (std::size_t i = 0; i < bucket_count; ++i)
+			{
+				n += buckets[i];
+
+				if (n >= rank)
+					return (std::min)(bucket_upper_ns(i), max_ns);
+			}
+
+			return max_ns;
+		}
+	};
+
+	/**
+	 * @brief The snapshot of the metrics of an io_context, the counters are accumulated by all
+	 * the tcp sessions and clients which are using this io_context.
+	 */
+	struct io_metrics
+	{
+		/// the count of sessions and clients which are using this io_context.
+		std::size_t       sessions = 0;
+
+		/// the count of pending send operations of this io_context, see io_t::pending()
+		std::size_t       pending  = 0;
+
+		/// the count of events in the event queues of the objects which are using this io_context.
+		std::size_t       events   = 0;
+
+		std::uint64_t     bytes_recv    = 0;
+		std::uint64_t     bytes_sent    = 0;
+		std::uint64_t     messages_recv = 0;
+		std::uint64_t     messages_sent = 0;
+
+		/// the run time of the recv handlers.
+		latency_histogram handler_latency;
+	};
+
+	/**
+	 * @brief The snapshot of the metrics of a session or a client.
+	 */
+	struct connection_metrics
+	{
+		std::uint64_t bytes_recv    = 0;
+		std::uint64_t bytes_sent    = 0;
+		std::uint64_t messages_recv = 0;
+		std::uint64_t messages_sent = 0;
+	};
+
+	/**
+	 * @brief The snapshot of the counters of a handler_memory.
+	 */
+	struct allocator_stats
+	{
+		/// the allocations which are served by the single block of storage.
+		std::uint64_t hits   = 0;
+
+		/// the allocations which are served by the per thread handler_memory_pool.
+		std::uint64_t misses = 0;
+
+		/// the misses which the handler_memory_pool has no cached block, so they are allocated
+		/// from the heap.
+		std::uint64_t heap   = 0;
+
+		inline allocator_stats& operator+=(const allocator_stats& other) noexcept
+		{
+			hits   += other.hits;
+			misses += other.misses;
+			heap   += other.heap;
+			return *this;
+		}
+	};
+
+	/**
+	 * @brief The snapshot of the counters of the allocators of a session or a client, or the
+	 * sum of them of all the sessions of a server.
+	 * @note the udp session uses the same allocator to recv and send, it is counted as wallocator.
+	 */
+	struct allocator_metrics
+	{
+		/// the recv/read allocator.
+		allocator_stats rallocator;
+
+		/// the send/write allocator.
+		allocator_stats wallocator;
+
+		inline allocator_metrics& operator+=(const allocator_metrics& other) noexcept
+		{
+			rallocator += other.rallocator;
+			wallocator += other.wallocator;
+			return *this;
+		}
+	};
+
+	/**
+	 * @brief The snapshot of the metrics of a session manager.
+	 */
+	struct session_mgr_metrics
+	{
+		/// when this snapshot was taken, it is used to calculate the rates between two snapshots.
+		std::chrono::steady_clock::time_point time{};
+
+		/// the current count of the sessions.
+		std::size_t   sessions      = 0;
+
+		/// the max count of the sessions since the session manager was created.
+		std::size_t   peak_sessions = 0;
+
+		/// the count of all the sessions which were added into the session manager.
+		std::uint64_t accepts       = 0;
+
+		/// the count of the disconnected sessions of each disconnect_reason.
+		std::array<std::uint64_t, std::size_t(disconnect_reason::max)> disconnects{};
+
+		/**
+		 * @brief get the count of the disconnected sessions of the reason.
+		 */
+		inline std::uint64_t get_disconnects(disconnect_reason reason) const noexcept
+		{
+			return disconnects[std::size_t(reason)];
+		}
+
+		/**
+		 * @brief get the accepts per second between the previous snapshot and this snapshot.
+		 */
+		inline double accept_rate(const session_mgr_metrics& prev) const noexcept
+		{
+			double sec = std::chrono::duration<double>(time - prev.time).count();
+
+			return (sec > 0.0 && accepts >= prev.accepts) ? double(accepts - prev.accepts) / sec : 0.0;
+		}
+	};
+
+	/**
+	 * @brief The snapshot of the metrics of a server, include the session manager and each
+	 * io_context of the server.
+	 */
+	struct server_metrics
+	{
+		session_mgr_metrics     sessions;
+
+		std::vector<io_metrics> ios;
+
+		/**
+		 * @brief get the sum of the metrics of all the io_contexts.
+		 */
+		inline io_metrics total() const noexcept
+		{
+			io_metrics r;
+
+			for (const io_metrics& m : ios)
+			{
+				r.sessions      += m.sessions;
+				r.pending       += m.pending;
+				r.events        += m.events;
+				r.bytes_recv    += m.bytes_recv;
+				r.bytes_sent    += m.bytes_sent;
+				r.messages_recv += m.messages_recv;
+				r.messages_sent += m.messages_sent;
+
+				r.handler_latency.count    += m.handler_latency.count;
+				r.handler_latency.total_ns += m.handler_latency.total_ns;
+				r.handler_latency.max_ns    = (std::max)(r.handler_latency.max_ns, m.handler_latency.max_ns);
+
+				for (std::size_t i = 0; i < latency_histogram::bucket_count; ++i)
+				{
+					r.handler_latency.buckets[i] += m.handler_latency.buckets[i];
+				}
+			}
+
+			return r;
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+
+	/**
+	 * @brief The latency histogram which is written by one thread and read by any thread.
+	 */
+	class latency_recorder
+	{
+	public:
+		latency_recorder() noexcept = default;
+
+		/**
+		 * @brief get the bucket index of the latency, same as floor(log2(ns)).
+		 */
+		static inline std::size_t bucket_index(std::uint64_t ns) noexcept
+		{
+			std::size_t n = 0;
+
+			if (ns >= (std::uint64_t(1) << 32)) { ns >>= 32; n += 32; }
+			if (ns >= (std::uint64_t(1) << 16)) { ns >>= 16; n += 16; }
+			if (ns >= (std::uint64_t(1) <<  8)) { ns >>=  8; n +=  8; }
+			if (ns >= (std::uint64_t(1) <<  4)) { ns >>=  4; n +=  4; }
+			if (ns >= (std::uint64_t(1) <<  2)) { ns >>=  2; n +=  2; }
+			if (ns >= (std::uint64_t(1) <<  1)) {            n +=  1; }
+
+			return (std::min)(n, latency_histogram::bucket_count - 1);
+		}
+
+		inline void record(std::chrono::steady_clock::duration d) noexcept
+		{
+			auto v = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+
+			std::uint64_t ns = v > 0 ? std::uint64_t(v) : std::uint64_t(0);
+
+			this->buckets_[bucket_index(ns)].fetch_add(1, std::memory_order_relaxed);
+			this->count_.fetch_add(1, std::memory_order_relaxed);
+			this->total_ns_.fetch_add(ns, std::memory_order_relaxed);
+
+			// only the io_context thread writes it, so the load and store don't need a cas loop.
+			if (ns > this->max_ns_.load(std::memory_order_relaxed))
+				this->max_ns_.store(ns, std::memory_order_relaxed);
+		}
+
+		inline latency_histogram snapshot() const noexcept
+		{
+			latency_histogram h;
+
+			for (std::size_t i = 0; i < latency_histogram::bucket_count; ++i)
+			{
+				h.buckets[i] = this->buckets_[i].load(std::memory_order_relaxed);
+			}
+
+			h.count    = this->count_   .load(std::memory_order_relaxed);
+			h.total_ns = this->total_ns_.load(std::memory_order_relaxed);
+			h.max_ns   = this->max_ns_  .load(std::memory_order_relaxed);
+
+			return h;
+		}
+
+	protected:
+		std::array<std::atomic<std::uint64_t>, latency_histogram::bucket_count> buckets_{};
+
+		std::atomic<std::uint64_t> count_   { 0 };
+		std::atomic<std::uint64_t> total_ns_{ 0 };
+		std::atomic<std::uint64_t> max_ns_  { 0 };
+	};
+
+	/**
+	 * @brief The counters of a session or a client, or the sum of all the sessions and clients
+	 * of an io_context. They are only written in the io_context thread, so the relaxed atomics
+	 * are just plain adds on the hot path.
+	 */
+	struct connection_counters
+	{
+		std::atomic<std::uint64_t> bytes_recv    { 0 };
+		std::atomic<std::uint64_t> bytes_sent    { 0 };
+		std::atomic<std::uint64_t> messages_recv { 0 };
+		std::atomic<std::uint64_t> messages_sent { 0 };
+
+		inline void on_recv(std::size_t bytes) noexcept
+		{
+			this->bytes_recv   .fetch_add(bytes, std::memory_order_relaxed);
+			this->messages_recv.fetch_add(1    , std::memory_order_relaxed);
+		}
+
+		inline void on_send(std::size_t messages) noexcept
+		{
+			this->messages_sent.fetch_add(messages, std::memory_order_relaxed);
+		}
+
+		inline void on_sent(std::size_t bytes) noexcept
+		{
+			this->bytes_sent.fetch_add(bytes, std::memory_order_relaxed);
+		}
+
+		inline connection_metrics snapshot() const noexcept
+		{
+			return connection_metrics{
+				this->bytes_recv   .load(std::memory_order_relaxed),
+				this->bytes_sent   .load(std::memory_order_relaxed),
+				this->messages_recv.load(std::memory_order_relaxed),
+				this->messages_sent.load(std::memory_order_relaxed) };
+		}
+	};
+
+	/**
+	 * @brief The counters of a handler_memory.
+	 */
+	struct allocator_counters
+	{
+		std::atomic<std::uint64_t> hits   { 0 };
+		std::atomic<std::uint64_t> misses { 0 };
+		std::atomic<std::uint64_t> heap   { 0 };
+
+		inline allocator_stats snapshot() const noexcept
+		{
+			return allocator_stats{
+				this->hits  .load(std::memory_order_relaxed),
+				this->misses.load(std::memory_order_relaxed),
+				this->heap  .load(std::memory_order_relaxed) };
+		}
+	};
+
+	/**
+	 * @brief The counters of an io_context, it is aligned to the cache line, beacuse the
+	 * other members of the io_t, like the pending(), are written by the other threads.
+	 */
+	struct alignas(64) io_counters : public connection_counters
+	{
+		/// the count of events in the event queues, see event_queue_cp
+		std::atomic<std::size_t> events{ 0 };
+
+		latency_recorder         handler_latency;
+	};
+
+	/**
+	 * @brief The counters of a session manager, they are only written in the thread of the
+	 * session manager's io_context.
+	 */
+	struct session_mgr_counters
+	{
+		std::atomic<std::uint64_t> accepts      { 0 };
+		std::atomic<std::size_t>   peak_sessions{ 0 };
+
+		std::array<std::atomic<std::uint64_t>, std::size_t(disconnect_reason::max)> disconnects{};
+
+		inline void on_accept(std::size_t sessions) noexcept
+		{
+			this->accepts.fetch_add(1, std::memory_order_relaxed);
+
+			if (sessions > this->peak_sessions.load(std::memory_order_relaxed))
+				this->peak_sessions.store(sessions, std::memory_order_relaxed);
+		}
+
+		inline void on_disconnect(const error_code& ec) noexcept
+		{
+			this->disconnects[std::size_t(to_disconnect_reason(ec))].fetch_add(1, std::memory_order_relaxed);
+		}
+
+		inline session_mgr_metrics snapshot(std::size_t sessions) const noexcept
+		{
+			session_mgr_metrics m;
+
+			m.time          = std::chrono::steady_clock::now();
+			m.sessions      = sessions;
+			m.peak_sessions = this->peak_sessions.load(std::memory_order_relaxed);
+			m.accepts       = this->accepts.load(std::memory_order_relaxed);
+
+			for (std::size_t i = 0; i < m.disconnects.size(); ++i)
+			{
+				m.disconnects[i] = this->disconnects[i].load(std::memory_order_relaxed);
+			}
+
+			return m;
+		}
+	};
+
+	//-------------------------------------------------------------------------------------------------
+
+	namespace metrics_json
+	{
+		inline void append(std::string& s, std::string_view name, std::uint64_t v)
+		{
+			s += '"';
+			s += name;
+			s += "\":";
+			s += std::to_string(v);
+		}
+
+		inline void append(std::string& s, const latency_histogram& h)
+		{
+			append(s, "count"   , h.count   ); s += ',';
+			append(s, "total_ns", h.total_ns); s += ',';
+			append(s, "max_ns"  , h.max_ns  ); s += ',';
+			append(s, "p50_ns"  , h.percentile_ns(0.50)); s += ',';
+			append(s, "p99_ns"  , h.percentile_ns(0.99)); s += ',';
+			append(s, "p999_ns" , h.percentile_ns(0.999)); s += ',';
+
+			// only the non-empty buckets, as "upper bound in nanoseconds":count
+			s += "\"buckets\":{";
+			bool first = true;
+			for (std::size_t i = 0; i < latency_histogram::bucket_count; ++i)
+			{
+				if (h.buckets[i] == 0)
+					continue;
+				if (!first)
+					s += ',';
+				first = false;
+				append(s, std::to_string(latency_histogram::bucket_upper_ns(i)), h.buckets[i]);
+			}
+			s += '}';
+		}
+
+		inline void append(std::string& s, const io_metrics& m)
+		{
+			s += '{';
+			append(s, "sessions"     , m.sessions     ); s += ',';
+			append(s, "pending"      , m.pending      ); s += ',';
+			append(s, "events"       , m.events       ); s += ',';
+			append(s, "bytes_recv"   , m.bytes_recv   ); s += ',';
+			append(s, "bytes_sent"   , m.bytes_sent   ); s += ',';
+			append(s, "messages_recv", m.messages_recv); s += ',';
+			append(s, "messages_sent", m.messages_sent); s += ',';
+			s += "\"handler_latency\":{";
+			append(s, m.handler_latency);
+			s += "}}";
+		}
+
+		inline void append(std::string& s, const connection_metrics& m)
+		{
+			s += '{';
+			append(s, "bytes_recv"   , m.bytes_recv   ); s += ',';
+			append(s, "bytes_sent"   , m.bytes_sent   ); s += ',';
+			append(s, "messages_recv", m.messages_recv); s += ',';
+			append(s, "messages_sent", m.messages_sent);
+			s += '}';
+		}
+
+		inline void append(std::string& s, const allocator_stats& m)
+		{
+			s += '{';
+			append(s, "hits"  , m.hits  ); s += ',';
+			append(s, "misses", m.misses); s += ',';
+			append(s, "heap"  , m.heap  );
+			s += '}';
+		}
+
+		inline void append(std::string& s, const allocator_metrics& m)
+		{
+			s += "{\"rallocator\":";
+			append(s, m.rallocator);
+			s += ",\"wallocator\":";
+			append(s, m.wallocator);
+			s += '}';
+		}
+
+		inline void append(std::string& s, const session_mgr_metrics& m)
+		{
+			s += '{';
+			append(s, "sessions"     , m.sessions     ); s += ',';
+			append(s, "peak_sessions", m.peak_sessions); s += ',';
+			append(s, "accepts"      , m.accepts      ); s += ',';
+			s += "\"disconnects\":{";
+			for (std::size_t i = 0; i < m.disconnects.size(); ++i)
+			{
+				if (i)
+					s += ',';
+				append(s, to_string(disconnect_reason(i)), m.disconnects[i]);
+			}
+			s += "}}";
+		}
+
+		inline void append(std::string& s, const server_metrics& m)
+		{
+			s += "{\"sessions\":";
+			append(s, m.sessions);
+			s += ",\"ios\":[";
+			for (std::size_t i = 0; i < m.ios.size(); ++i)
+			{
+				if (i)
+					s += ',';
+				append(s, m.ios[i]);
+			}
+			s += "]}";
+		}
+	}
+
+	/**
+	 * @brief export the metrics snapshot as a json string, the latencies are in nanoseconds.
+	 */
+	template<class Metrics>
+	inline std::string to_json(const Metrics& m)
+	{
+		std::string s;
+
+		s.reserve(256);
+
+		metrics_json::append(s, m);
+
+		return s;
+	}
+}
+
+namespace asio2
+{
+	using disconnect_reason   = detail::disconnect_reason;
+	using latency_histogram   = detail::latency_histogram;
+	using io_metrics          = detail::io_metrics;
+	using connection_metrics  = detail::connection_metrics;
+	using allocator_stats     = detail::allocator_stats;
+	using allocator_metrics   = detail::allocator_metrics;
+	using session_mgr_metrics = detail::session_mgr_metrics;
+	using server_metrics      = detail::server_metrics;
+
+	using detail::to_disconnect_reason;
+	using detail::to_json;
+}
+
+#endif // ASIO2_ENABLE_METRICS
+
+#endif // !__ASIO2_METRICS_HPP__
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2017-2023 zhllxt
+ *
+ * author   : zhllxt
+ * email    : 37792738@qq.com
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef __ASIO2_MPSC_QUEUE_HPP__
+#define __ASIO2_MPSC_QUEUE_HPP__
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <cstddef>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <utility>
+
+#include <asio2/external/assert.hpp>
+
+namespace asio2::detail
+{
+	/**
+	 * @brief An intrusive lock-free multiple producers single consumer queue.
+	 * The push is wait-free : one atomic exchange and one atomic increment, the queue doesn't
+	 * allocate memory, the nodes are owned by the caller.
+	 * The push returns true when the queue changes from empty to non-empty, only the producer
+	 * which got true should wake up the consumer, and the consumer should pop all the nodes
+	 * with consume_all, then the next push will return true again.
+	 * @note the node type must be derived from mpsc_queue::node.
+	 */
+	class mpsc_queue
+	{
+	public:
+		struct node
+		{
+			std::atomic<node*> next{ nullptr };
+		};
+
+		/**
+		 * @brief constructor
+		 */
+		mpsc_queue() noexcept
+		{
+			this->head_.store(std::addressof(this->stub_), std::memory_order_relaxed);
+			this->tail_ = std::addressof(this->stub_);
+		}
+
+		/**
+		 * @brief destructor
+		 */
+		~mpsc_queue() noexcept
+		{
+			ASIO2_ASSERT(this->size_.load(std::memory_order_relaxed) == 0);
+		}
+
+		mpsc_queue(const mpsc_queue&) = delete;
+		mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+		/**
+		 * @brief push a node to the tail of the queue, can be called in any thread.
+		 * @return true if the queue was empty, the caller should wake up the consumer.
+		 */
+		inline bool push(node* n) noexcept
+		{
+			this->link(n);
+
+			// the node must be linked before the size is increased, so when the consumer see
+			// the size, the node is reachable, or will be reachable very soon.
+			return (this->size_.fetch_add(1, std::memory_order_acq_rel) == 0);
+		}
+
+		/**
+		 * @brief pop all the nodes in the FIFO order, and call the fun with each node, the nodes
+		 * pushed while consuming are popped too. must be called in the consumer thread only.
+		 * Function signature : void(node* n)
+		 * @return the count of the popped nodes.
+		 */
+		template<class Function>
+		inline std::size_t consume_all(Function&& fun)
+		{
+			std::size_t total = 0;
+
+			std::size_t count = this->size_.load(std::memory_order_acquire);
+
+			while (count > 0)
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					node* n = this->pop();
+
+					// a producer has exchanged the head but hasn't linked the previous node yet,
+					// it will be completed within a few instructions.
+					while (n == nullptr)
+					{
+						std::this_thread::yield();
+
+						n = this->pop();
+					}
+
+					fun(n);
+				}
+
+				total += count;
+
+				count = this->size_.fetch_sub(count, std::memory_order_acq_rel) - count;
+			}
+
+			return total;
+		}
+
+		/**
+		 * @brief get the count of the nodes in the queue.
+		 */
+		inline std::size_t size() const noexcept
+		{
+			return this->size_.load(std::memory_order_acquire);
+		}
+
+		/**
+		 * @brief check whether the queue is empty.
+		 */
+		inline bool empty() const noexcept
+		{
+			return (this->size() == 0);
+		}
+
+	protected:
+		inline void link(node* n) noexcept
+		{
+			n->next.store(nullptr, std::memory_order_relaxed);
+
+			node* prev = this->head_.exchange(n, std::memory_order_acq_rel);
+
+			prev->next.store(n, std::memory_order_release);
+		}
+
+		/**
+		 * @brief pop a node from the front of the queue.
+		 * @return nullptr if the queue is empty, or a push is in progress.
+		 */
+		inline node* pop() noexcept
+		{
+			node* tail = this->tail_;
+			node* next = tail->next.load(std::memory_order_acquire);
+
+			if (tail == std::addressof(this->stub_))
+			{
+				if (next == nullptr)
+					return nullptr;
+
+				this->tail_ = next;
+				tail = next;
+				next = next->next.load(std::memory_order_acquire);
+			}
+
+			if (next)
+			{
+				this->tail_ = next;
+				return tail;
+			}
+
+			if (tail != this->head_.load(std::memory_order_acquire))
+				return nullptr;
+
+			// the tail is the last node, push the stub back, so the tail node can be popped.
+			this->link(std::addressof(this->stub_));
+
+			next = tail->next.load(std::memory_order_acquire);
+
+			if (next)
+			{
+				this->tail_ = next;
+				return tail;
+			}
+
+			return nullptr;
+		}
+
+	protected:
+		/// only the consumer read/write the tail, keep it away from the producers's cache line.
+		node*                                tail_;
+
+		node                                 stub_;
+
+		alignas(64) std::atomic<node*>       head_;
+
+		std::atomic<std::size_t>             size_{ 0 };
+	};
+}
+
+#endif // !__ASIO2_MPSC_QUEUE_HPP__
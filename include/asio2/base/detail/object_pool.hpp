@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2017-2023 zhllxt
+ *
+ * author   : zhllxt
+ * email    : 37792738@qq.com
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef __ASIO2_OBJECT_POOL_HPP__
+#define __ASIO2_OBJECT_POOL_HPP__
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <cstddef>
+#include <new>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <limits>
+
+/*
+ * the max count of the free memory blocks of each size in an object pool, the blocks
+ * which exceed this count are returned to the system.
+ */
+#ifndef ASIO2_OBJECT_POOL_MAX_FREE
+#define ASIO2_OBJECT_POOL_MAX_FREE 1024
+#endif
+
+namespace asio2::detail
+{
+	/**
+	 * @brief A thread safe pool of memory blocks for the large objects which are created and
+	 * destroyed frequently, like the sessions. the freed blocks are grouped by the size and
+	 * the alignment, and reused by the next allocation of the same size and alignment.
+	 * @note the object is always constructed and destroyed normally, only the memory is reused.
+	 */
+	class object_pool
+	{
+	public:
+		/**
+		 * @brief constructor
+		 * @param max_free  - the max count of the free blocks of each size.
+		 * @param max_bytes - the max bytes of the free blocks of each size, so the large blocks
+		 *                    which are allocated by a spike are returned to the system.
+		 */
+		explicit object_pool(
+			std::size_t max_free  = ASIO2_OBJECT_POOL_MAX_FREE,
+			std::size_t max_bytes = (std::numeric_limits<std::size_t>::max)()) noexcept
+			: max_free_(max_free), max_bytes_(max_bytes)
+		{
+		}
+
+		/**
+		 * @brief destructor
+		 */
+		~object_pool() noexcept
+		{
+			this->clear();
+		}
+
+		object_pool(const object_pool&) = delete;
+		object_pool& operator=(const object_pool&) = delete;
+
+		/**
+		 * @brief allocate a memory block, reuse a freed block if possible.
+		 */
+		inline void* allocate(std::size_t size, std::size_t align)
+		{
+			{
+				std::lock_guard<std::mutex> guard(this->mutex_);
+
+				if (bucket* b = this->find(size, align); b && !b->blocks.empty())
+				{
+					void* p = b->blocks.back();
+					b->blocks.pop_back();
+					this->hits_.fetch_add(1, std::memory_order_relaxed);
+					return p;
+				}
+			}
+
+			this->misses_.fetch_add(1, std::memory_order_relaxed);
+
+			return ::operator new(size, std::align_val_t(align));
+		}
+
+		/**
+		 * @brief return a memory block to the pool, the block is freed if the pool is full.
+		 */
+		inline void deallocate(void* p, std::size_t size, std::size_t align) noexcept
+		{
+			{
+				std::lock_guard<std::mutex> guard(this->mutex_);
+
+				bucket* b = this->find(size, align);
+
+			#if !defined(ASIO_NO_EXCEPTIONS) && !defined(BOOST_ASIO_NO_EXCEPTIONS)
+				try
+				{
+			#endif
+					if (!b)
+					{
+						b = std::addressof(this->buckets_.emplace_back());
+						b->size  = size;
+						b->align = align;
+					}
+
+					if (b->blocks.size() < this->max_free_ && (b->blocks.size() + 1) * size <= this->max_bytes_)
+					{
+						b->blocks.emplace_back(p);
+						return;
+					}
+			#if !defined(ASIO_NO_EXCEPTIONS) && !defined(BOOST_ASIO_NO_EXCEPTIONS)
+				}
+				catch (std::bad_alloc const&)
+				{
+				}
+			#endif
+			}
+
+			::operator delete(p, std::align_val_t(align));
+		}
+
+		/**
+		 * @brief free all the cached blocks.
+		 */
+		inline void clear() noexcept
+		{
+			std::lock_guard<std::mutex> guard(this->mutex_);
+
+			for (bucket& b : this->buckets_)
+			{
+				for (void* p : b.blocks)
+				{
+					::operator delete(p, std::align_val_t(b.align));
+				}
+			}
+
+			this->buckets_.clear();
+		}
+
+		/**
+		 * @brief get the count of the cached blocks.
+		 */
+		inline std::size_t free_count() const noexcept
+		{
+			std::lock_guard<std::mutex> guard(this->mutex_);
+
+			std::size_t n = 0;
+
+			for (const bucket& b : this->buckets_)
+			{
+				n += b.blocks.size();
+			}
+
+			return n;
+		}
+
+		/**
+		 * @brief get the count of the allocations which reused a cached block.
+		 */
+		inline std::size_t hits() const noexcept { return this->hits_.load(std::memory_order_relaxed); }
+
+		/**
+		 * @brief get the count of the allocations which allocated a new block from the system.
+		 */
+		inline std::size_t misses() const noexcept { return this->misses_.load(std::memory_order_relaxed); }
+
+	protected:
+		struct bucket
+		{
+			std::size_t        size  = 0;
+			std::size_t        align = 0;
+			std::vector<void*> blocks;
+		};
+
+		// there are only a few kinds of sessions in a process, so a linear search is enough.
+		inline bucket* find(std::size_t size, std::size_t align) noexcept
+		{
+			for (bucket& b : this->buckets_)
+			{
+				if (b.size == size && b.align == align)
+					return std::addressof(b);
+			}
+
+			return nullptr;
+		}
+
+	protected:
+		mutable std::mutex                   mutex_;
+
+		std::vector<bucket>                  buckets_;
+
+		std::size_t                          max_free_;
+		std::size_t                          max_bytes_;
+
+		std::atomic<std::size_t>             hits_{ 0 };
+		std::atomic<std::size_t>             misses_{ 0 };
+	};
+
+	/**
+	 * @brief The allocator which allocates the memory from an object pool, it is used with
+	 * std::allocate_shared, so the object and the control block are in one pooled block, and
+	 * the pool is kept alive by the control block until the block is returned.
+	 */
+	template<class T>
+	class object_pool_allocator
+	{
+		template<class> friend class object_pool_allocator;
+
+	public:
+		using value_type = T;
+
+		explicit object_pool_allocator(std::shared_ptr<object_pool> pool) noexcept : pool_(std::move(pool))
+		{
+		}
+
+		template<class U>
+		object_pool_allocator(const object_pool_allocator<U>& other) noexcept : pool_(other.pool_)
+		{
+		}
+
+		inline T* allocate(std::size_t n)
+		{
+			return static_cast<T*>(this->pool_->allocate(n * sizeof(T), alignof(T)));
+		}
+
+		inline void deallocate(T* p, std::size_t n) noexcept
+		{
+			this->pool_->deallocate(p, n * sizeof(T), alignof(T));
+		}
+
+		template<class U>
+		inline bool operator==(const object_pool_allocator<U>& other) const noexcept
+		{
+			return this->pool_ == other.pool_;
+		}
+
+		template<class U>
+		inline bool operator!=(const object_pool_allocator<U>& other) const noexcept
+		{
+			return this->pool_ != other.pool_;
+		}
+
+	protected:
+		std::shared_ptr<object_pool> pool_;
+	};
+}
+
+#endif // !__ASIO2_OBJECT_POOL_HPP__
@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2017-2023 zhllxt
+ *
+ * author   : zhllxt
+ * email    : 37792738@qq.com
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef __ASIO2_RECV_CHUNK_HPP__
+#define __ASIO2_RECV_CHUNK_HPP__
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <limits>
+#include <string_view>
+#include <stdexcept>
+
+#include <asio2/external/asio.hpp>
+
+#include <asio2/base/detail/object_pool.hpp>
+#include <asio2/base/detail/buffer_pool.hpp>
+
+namespace asio2
+{
+	/**
+	 * @brief A ref-counted handle of the received data, the data is kept alive as long as any
+	 * handle of it is alive, so it can be processed asynchronously without a copy.
+	 * The memory is returned to the buffer pool of the io_context when the last handle is destroyed.
+	 */
+	class recv_chunk
+	{
+	public:
+		recv_chunk() noexcept = default;
+
+		recv_chunk(std::shared_ptr<const char> data, std::size_t size) noexcept
+			: data_(std::move(data)), size_(size)
+		{
+		}
+
+		recv_chunk(recv_chunk&&) noexcept = default;
+		recv_chunk(recv_chunk const&) noexcept = default;
+
+		recv_chunk& operator=(recv_chunk&&) noexcept = default;
+		recv_chunk& operator=(recv_chunk const&) noexcept = default;
+
+		/**
+		 * @brief get the pointer of the data.
+		 */
+		inline const char* data() const noexcept { return this->data_.get(); }
+
+		/**
+		 * @brief get the size of the data.
+		 */
+		inline std::size_t size() const noexcept { return this->size_; }
+
+		/**
+		 * @brief check whether the chunk is empty.
+		 */
+		inline bool empty() const noexcept { return this->size_ == 0; }
+
+		/**
+		 * @brief get the data as a string_view, it is valid as long as this chunk is alive.
+		 */
+		inline std::string_view view() const noexcept
+		{
+			return std::string_view{ this->data_.get(), this->size_ };
+		}
+
+		inline operator std::string_view() const noexcept { return this->view(); }
+
+		/**
+		 * @brief get the count of the handles which share the memory of this chunk, include the
+		 * other chunks which are in the same memory block.
+		 */
+		inline long use_count() const noexcept { return this->data_.use_count(); }
+
+		/**
+		 * @brief release the reference of the memory.
+		 */
+		inline void reset() noexcept
+		{
+			this->data_.reset();
+			this->size_ = 0;
+		}
+
+	protected:
+		std::shared_ptr<const char> data_;
+		std::size_t                 size_ = 0;
+	};
+}
+
+namespace asio2::detail
+{
+	/**
+	 * @brief The receive buffer of the recv chunk mode, the memory block is borrowed from the
+	 * buffer pool of the io_context. the received data can be shared as a recv_chunk, then the
+	 * shared bytes are never moved or overwritten, the buffer continues to read into the free
+	 * tail of the block, or into a new block when the tail is not enough.
+	 */
+	class chunk_buffer
+	{
+	public:
+		using size_type            = std::size_t;
+
+		// same as the asio::streambuf, then the match condition functions can be used for both.
+		using const_buffers_type   = asio::streambuf::const_buffers_type;
+		using mutable_buffers_type = asio::streambuf::mutable_buffers_type;
+
+		chunk_buffer() noexcept = default;
+
+		explicit chunk_buffer(std::shared_ptr<object_pool> pool,
+			size_type pre = 512, size_type max = (std::numeric_limits<size_type>::max)()) noexcept
+			: pool_(std::move(pool)), pre_(pre), max_(max)
+		{
+		}
+
+		chunk_buffer(chunk_buffer&&) noexcept = default;
+		chunk_buffer& operator=(chunk_buffer&&) noexcept = default;
+
+		/// Returns the size of the input sequence.
+		inline size_type size    () const noexcept { return (this->wpos_ - this->rpos_); }
+
+		/// Return the maximum sum of the input and output sequence sizes.
+		inline size_type max_size() const noexcept { return this->max_; }
+
+		/// Return the maximum sum of input and output sizes that can be held without an allocation.
+		inline size_type capacity() const noexcept { return this->cap_; }
+
+		/// Get a list of buffers that represent the input sequence.
+		inline const_buffers_type data() const noexcept
+		{
+			return const_buffers_type{ this->block_.get() + this->rpos_, this->wpos_ - this->rpos_ };
+		}
+
+		/**
+		 * @brief Get a list of buffers that represent the output sequence, with the given size.
+		 * @throws std::length_error if `size() + n` exceeds `max_size()`.
+		 */
+		inline mutable_buffers_type prepare(size_type n)
+		{
+			if (this->block_ && n <= this->cap_ - this->wpos_)
+			{
+				return mutable_buffers_type{ this->block_.get() + this->wpos_, n };
+			}
+
+			size_type const size = this->size();
+
+			// the shared bytes before the rpos must not be overwritten.
+			if (this->block_ && !this->is_shared() && n <= this->cap_ - size)
+			{
+				if (size > 0)
+					std::memmove(this->block_.get(), this->block_.get() + this->rpos_, size);
+
+				this->rpos_ = 0;
+				this->wpos_ = size;
+
+				return mutable_buffers_type{ this->block_.get() + this->wpos_, n };
+			}
+
+			if (n > this->max_ - size)
+				asio::detail::throw_exception(std::length_error{ "chunk_buffer overflow" });
+
+			size_type cap = (std::max<size_type>)((std::max<size_type>)(size + n, 2 * this->cap_), this->pre_);
+
+			cap = buffer_pool_allocator<char>::size_class(cap);
+
+			std::shared_ptr<char> block = chunk_buffer::allocate(this->pool_, cap);
+
+			if (size > 0)
+				std::memcpy(block.get(), this->block_.get() + this->rpos_, size);
+
+			this->block_ = std::move(block);
+			this->cap_   = cap;
+			this->rpos_  = 0;
+			this->wpos_  = size;
+
+			return mutable_buffers_type{ this->block_.get() + this->wpos_, n };
+		}
+
+		/// Move bytes from the output sequence to the input sequence.
+		inline void commit(size_type n) noexcept
+		{
+			this->wpos_ += (std::min<size_type>)(n, this->cap_ - this->wpos_);
+		}
+
+		/// Remove bytes from the input sequence.
+		inline void consume(size_type n) noexcept
+		{
+			if (n < this->wpos_ - this->rpos_)
+			{
+				this->rpos_ += n;
+				return;
+			}
+
+			this->rpos_ = 0;
+			this->wpos_ = 0;
+
+			// the block is held by the user, the next read uses a new block.
+			if (this->is_shared())
+			{
+				this->block_.reset();
+				this->cap_ = 0;
+			}
+		}
+
+		/**
+		 * @brief return the memory block to the pool if the buffer is empty.
+		 */
+		inline void release() noexcept
+		{
+			if (this->size() == 0)
+			{
+				this->block_.reset();
+				this->cap_  = 0;
+				this->rpos_ = 0;
+				this->wpos_ = 0;
+			}
+		}
+
+		/**
+		 * @brief check whether the memory block is shared by any recv_chunk.
+		 */
+		inline bool is_shared() const noexcept
+		{
+			return this->block_.use_count() > 1;
+		}
+
+		/**
+		 * @brief share the data as a recv_chunk, the data is copied into a new chunk if it is not
+		 * in the memory block of this buffer.
+		 */
+		inline asio2::recv_chunk share(std::string_view data)
+		{
+			if (data.empty())
+				return asio2::recv_chunk{};
+
+			const char* p = this->block_.get();
+
+			if (p && data.data() >= p && data.data() + data.size() <= p + this->cap_)
+			{
+				return asio2::recv_chunk{ std::shared_ptr<const char>(this->block_, data.data()), data.size() };
+			}
+
+			return chunk_buffer::copy(this->pool_, data);
+		}
+
+		/**
+		 * @brief copy the data into a new chunk which is allocated from the pool.
+		 */
+		static inline asio2::recv_chunk copy(const std::shared_ptr<object_pool>& pool, std::string_view data)
+		{
+			if (data.empty())
+				return asio2::recv_chunk{};
+
+			std::shared_ptr<char> block = chunk_buffer::allocate(pool,
+				buffer_pool_allocator<char>::size_class(data.size()));
+
+			std::memcpy(block.get(), data.data(), data.size());
+
+			return asio2::recv_chunk{ std::move(block), data.size() };
+		}
+
+	protected:
+		struct block_deleter
+		{
+			std::shared_ptr<object_pool> pool;
+			std::size_t                  size;
+
+			inline void operator()(char* p) const noexcept
+			{
+				this->pool->deallocate(p, this->size, alignof(char));
+			}
+		};
+
+		/**
+		 * @brief allocate a block from the pool, the control block of the shared_ptr is allocated
+		 * from the pool too.
+		 */
+		static inline std::shared_ptr<char> allocate(const std::shared_ptr<object_pool>& pool, size_type size)
+		{
+			if (!pool)
+				return std::shared_ptr<char>(new char[size], std::default_delete<char[]>());
+
+			char* p = static_cast<char*>(pool->allocate(size, alignof(char)));
+
+		#if !defined(ASIO_NO_EXCEPTIONS) && !defined(BOOST_ASIO_NO_EXCEPTIONS)
+			try
+			{
+		#endif
+				return std::shared_ptr<char>(p, block_deleter{ pool, size }, object_pool_allocator<char>(pool));
+		#if !defined(ASIO_NO_EXCEPTIONS) && !defined(BOOST_ASIO_NO_EXCEPTIONS)
+			}
+			catch (...)
+			{
+				pool->deallocate(p, size, alignof(char));
+				throw;
+			}
+		#endif
+		}
+
+	protected:
+		std::shared_ptr<object_pool> pool_;
+		std::shared_ptr<char>        block_;
+
+		size_type                    cap_  = 0;
+		size_type                    rpos_ = 0;
+		size_type                    wpos_ = 0;
+		size_type                    pre_  = 512;
+		size_type                    max_  = (std::numeric_limits<size_type>::max)();
+	};
+
+	/**
+	 * @brief The reference of the chunk_buffer, it is passed to the asio read functions which
+	 * take the dynamic buffer by value, like the asio::basic_streambuf_ref.
+	 */
+	class chunk_buffer_ref
+	{
+	public:
+		using size_type            = std::size_t;
+		using const_buffers_type   = chunk_buffer::const_buffers_type;
+		using mutable_buffers_type = chunk_buffer::mutable_buffers_type;
+
+		explicit chunk_buffer_ref(chunk_buffer& b) noexcept : b_(b) {}
+
+		chunk_buffer_ref(const chunk_buffer_ref& other) noexcept = default;
+
+		inline size_type            size    ()      const noexcept { return b_.size    ( ); }
+		inline size_type            max_size()      const noexcept { return b_.max_size( ); }
+		inline size_type            capacity()      const noexcept { return b_.capacity( ); }
+		inline const_buffers_type   data    ()      const noexcept { return b_.data    ( ); }
+		inline mutable_buffers_type prepare (size_type n)          { return b_.prepare (n); }
+		inline void                 commit  (size_type n) noexcept {        b_.commit  (n); }
+		inline void                 consume (size_type n) noexcept {        b_.consume (n); }
+
+	protected:
+		chunk_buffer& b_;
+	};
+}
+
+#endif // !__ASIO2_RECV_CHUNK_HPP__
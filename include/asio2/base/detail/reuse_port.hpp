@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2017-2023 zhllxt
+ *
+ * author   : zhllxt
+ * email    : 37792738@qq.com
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef __ASIO2_REUSE_PORT_HPP__
+#define __ASIO2_REUSE_PORT_HPP__
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <asio2/base/error.hpp>
+
+#include <asio2/base/detail/util.hpp>
+
+namespace asio2::detail
+{
+	/**
+	 * @brief check whether the SO_REUSEPORT socket option is supported by the current system.
+	 */
+	constexpr bool is_reuse_port_supported() noexcept
+	{
+	#if defined(SO_REUSEPORT)
+		return true;
+	#else
+		return false;
+	#endif
+	}
+
+	/**
+	 * @brief set the SO_REUSEPORT option, multiple sockets can be bound to the same address
+	 * and port, and the kernel will distribute the incoming connections or datagrams to them.
+	 * @note the option must be set before bind.
+	 */
+	template<class SocketT>
+	inline bool set_reuse_port(SocketT& socket, bool onoff, error_code& ec) noexcept
+	{
+	#if defined(SO_REUSEPORT)
+		socket.set_option(asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>(onoff), ec);
+	#else
+		detail::ignore_unused(socket, onoff);
+		ec = asio::error::operation_not_supported;
+	#endif
+		return !ec;
+	}
+}
+
+#endif // !__ASIO2_REUSE_PORT_HPP__
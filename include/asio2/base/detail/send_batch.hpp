@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2017-2023 zhllxt
+ *
+ * author   : zhllxt
+ * email    : 37792738@qq.com
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef __ASIO2_SEND_BATCH_HPP__
+#define __ASIO2_SEND_BATCH_HPP__
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include <asio2/external/asio.hpp>
+
+#include <asio2/base/error.hpp>
+
+#include <asio2/base/detail/function.hpp>
+
+#ifndef ASIO2_SEND_BATCH_MAX_CACHED_ENTRIES
+#define ASIO2_SEND_BATCH_MAX_CACHED_ENTRIES 1024
+#endif
+
+namespace asio2::detail
+{
+	/**
+	 * @brief A group of messages queued while a write was in flight, they will be written
+	 * to the socket with a single gather write, and every message's callback will be called
+	 * with its own bytes count when the write is completed.
+	 */
+	struct send_batch
+	{
+		using callback_type = detail::function<void(const error_code&, std::size_t)>;
+
+		struct entry
+		{
+			// the persisted data, empty when the data is a user owned buffer.
+			std::string        data;
+
+			// user owned buffer, like async_send(asio::buffer(...)), or the buffer of a shared_buffer.
+			asio::const_buffer extern_buffer;
+
+			// keeps the memory of the shared_buffer alive until the message is sent.
+			std::shared_ptr<const void> owner;
+
+			// the bytes of the frame header which was written before this message, the tcp
+			// dgram mode use it, it is used to calc the sent bytes of each message.
+			std::size_t        head_size = 0;
+
+			callback_type      callback;
+
+			inline asio::const_buffer buffer() const noexcept
+			{
+				return extern_buffer.size() ? extern_buffer : asio::buffer(data);
+			}
+		};
+
+		/**
+		 * @brief A non owning view of the gather write buffers, used to avoid the copy of the
+		 * std::vector when the buffer sequence is passed to asio::async_write.
+		 */
+		struct buffers_view
+		{
+			using value_type     = asio::const_buffer;
+			using const_iterator = const asio::const_buffer*;
+
+			inline const_iterator begin() const noexcept { return first; }
+			inline const_iterator end  () const noexcept { return last;  }
+
+			const_iterator first = nullptr;
+			const_iterator last  = nullptr;
+		};
+
+		/**
+		 * @brief append a message which will be sent with this batch.
+		 */
+		inline void append(std::string&& data, asio::const_buffer buffer,
+			std::shared_ptr<const void>&& owner, callback_type&& callback)
+		{
+			entry& e = this->entries.emplace_back();
+
+			e.data          = std::move(data);
+			e.extern_buffer = buffer;
+			e.owner         = std::move(owner);
+			e.callback      = std::move(callback);
+
+			this->total_bytes += e.buffer().size();
+		}
+
+		/**
+		 * @brief call the callback of every message with its own sent bytes.
+		 * the bytes_sent contains the frame header bytes.
+		 */
+		inline void complete(const error_code& ec, std::size_t bytes_sent)
+		{
+			for (entry& e : this->entries)
+			{
+				std::size_t head = (std::min)(bytes_sent, e.head_size);
+				bytes_sent -= head;
+
+				std::size_t size = e.buffer().size();
+				std::size_t sent = ec ? (std::min)(bytes_sent, size) : size;
+				bytes_sent -= sent;
+
+				if (e.callback)
+				{
+					set_last_error(ec);
+
+					e.callback(ec, std::size_t(sent));
+				}
+			}
+
+			this->clear();
+		}
+
+		/**
+		 * @brief clear the messages, but keep the memory for the next batch.
+		 */
+		inline void clear() noexcept
+		{
+			this->entries.clear();
+			this->buffers.clear();
+			this->scratch.clear();
+
+			this->total_bytes = 0;
+		}
+
+		/**
+		 * @brief get the view of the gather write buffers.
+		 */
+		inline buffers_view view() const noexcept
+		{
+			return buffers_view{ this->buffers.data(), this->buffers.data() + this->buffers.size() };
+		}
+
+		/**
+		 * @brief whether this batch is small enough to be cached for reuse.
+		 */
+		inline bool cacheable() const noexcept
+		{
+			return this->entries.capacity() <= std::size_t(ASIO2_SEND_BATCH_MAX_CACHED_ENTRIES);
+		}
+
+		std::vector<entry>              entries;
+
+		// the gather write buffers, reused between batches.
+		std::vector<asio::const_buffer> buffers;
+
+		// used to save the frame headers or the linearized data of ssl stream.
+		std::string                     scratch;
+
+		std::size_t                     total_bytes = 0;
+
+		// the bytes and count of the messages which are counted by the send watermark and budget,
+		// they are released when the batch is completed.
+		std::size_t                     counted_bytes = 0;
+		std::size_t                     counted_count = 0;
+	};
+}
+
+#endif // !__ASIO2_SEND_BATCH_HPP__
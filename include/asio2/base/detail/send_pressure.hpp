@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2017-2023 zhllxt
+ *
+ * author   : zhllxt
+ * email    : 37792738@qq.com
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef __ASIO2_SEND_PRESSURE_HPP__
+#define __ASIO2_SEND_PRESSURE_HPP__
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include <string_view>
+
+#include <asio2/external/asio.hpp>
+
+namespace asio2
+{
+	/**
+	 * @brief What to do with a new send when the send budget is exhausted.
+	 */
+	enum class send_policy : std::uint8_t
+	{
+		/// the new send is rejected, its callback is called with asio::error::no_buffer_space.
+		reject,
+
+		/// the new send is queued, and the same bytes of the oldest queued sends of the session
+		/// are dropped, the dropped sends are completed with asio::error::no_buffer_space.
+		drop_oldest,
+
+		/// the new send is rejected and the session is disconnected.
+		disconnect,
+	};
+
+	template<typename = void>
+	inline constexpr std::string_view to_string(send_policy v)
+	{
+		using namespace std::string_view_literals;
+		switch (v)
+		{
+		case send_policy::reject      : return "reject";
+		case send_policy::drop_oldest : return "drop_oldest";
+		case send_policy::disconnect  : return "disconnect";
+		default                       : return "none";
+		}
+		return "none";
+	}
+}
+
+namespace asio2::detail
+{
+	/**
+	 * @brief The max bytes of the queued sends, it is shared by all the sessions of a server.
+	 */
+	struct send_budget
+	{
+		explicit send_budget(std::size_t bytes, send_policy p) noexcept : limit(bytes), policy(p)
+		{
+		}
+
+		/// the bytes of the sends which are queued or being sent.
+		std::atomic<std::size_t> used{ 0 };
+
+		const std::size_t        limit;
+
+		const send_policy        policy;
+	};
+
+	template<class, class = std::void_t<>>
+	struct is_asio_bufferable : std::false_type {};
+
+	template<class T>
+	struct is_asio_bufferable<T, std::void_t<decltype(asio::buffer(std::declval<const T&>()))>>
+		: std::true_type {};
+
+	/**
+	 * @brief get the bytes of the data which will be sent, the data which can't be converted to
+	 * a asio buffer (eg: the http message) is counted as 0 bytes, but it is still counted as a message.
+	 */
+	template<class T>
+	inline std::size_t send_size(const T& data) noexcept
+	{
+		if constexpr (is_asio_bufferable<T>::value)
+		{
+			return asio::buffer(data).size();
+		}
+		else
+		{
+			std::ignore = data;
+			return 0;
+		}
+	}
+
+	/**
+	 * @brief The accounting of a queued send, it is held by the send event, and the bytes are
+	 * released when the event is destroyed, that is, after the data is sent or discarded.
+	 * It holds the derived object too, so the derived object is still valid when releasing.
+	 */
+	template<class derived_t>
+	class send_ticket
+	{
+	public:
+		send_ticket() noexcept = default;
+
+		send_ticket(derived_t& derive, std::shared_ptr<derived_t> p, std::size_t bytes, bool counted) noexcept
+			: derive_(std::addressof(derive)), p_(std::move(p)), bytes_(bytes), counted_(counted)
+		{
+		}
+
+		send_ticket(send_ticket&& o) noexcept
+			: derive_(o.derive_), p_(std::move(o.p_)), bytes_(o.bytes_), counted_(std::exchange(o.counted_, false))
+		{
+		}
+
+		send_ticket(const send_ticket&) = delete;
+		send_ticket& operator=(const send_ticket&) = delete;
+		send_ticket& operator=(send_ticket&&) = delete;
+
+		~send_ticket() noexcept
+		{
+			if (this->counted_)
+			{
+				this->derive_->_send_release(this->bytes_, 1);
+			}
+		}
+
+		/**
+		 * @brief whether the send is admitted.
+		 */
+		inline explicit operator bool() const noexcept { return this->derive_ != nullptr; }
+
+		inline std::size_t bytes() const noexcept { return this->bytes_; }
+
+		/**
+		 * @brief whether the bytes of the send are counted by the send watermark and budget.
+		 */
+		inline bool counted() const noexcept { return this->counted_; }
+
+		/**
+		 * @brief the accounting is taken over by the send batch, don't release it when destroyed.
+		 */
+		inline void dismiss() noexcept { this->counted_ = false; }
+
+	protected:
+		derived_t                * derive_  = nullptr;
+
+		/// the client maybe not created by std::shared_ptr, then the selfptr is empty.
+		std::shared_ptr<derived_t> p_;
+
+		std::size_t                bytes_   = 0;
+
+		bool                       counted_ = false;
+	};
+}
+
+#endif // !__ASIO2_SEND_PRESSURE_HPP__
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2017-2023 zhllxt
+ *
+ * author   : zhllxt
+ * email    : 37792738@qq.com
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef __ASIO2_SHARED_BUFFER_HPP__
+#define __ASIO2_SHARED_BUFFER_HPP__
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <type_traits>
+
+#include <asio2/external/asio.hpp>
+
+#include <asio2/base/detail/type_traits.hpp>
+
+namespace asio2
+{
+	/**
+	 * @brief A reference counted immutable buffer, copying it only increases the reference count.
+	 * It is used to send the same data to many sessions without copying the data for each session,
+	 * eg: server.async_send(...) will make the data into a shared_buffer once, and then all the
+	 * sessions' send queues will hold the same memory.
+	 * @note the data_filter_before_send is not called for the shared_buffer, the content of the
+	 * shared_buffer is treated as the final bytes which will be written to the socket.
+	 */
+	class shared_buffer
+	{
+	public:
+		/**
+		 * @brief constructor an empty buffer
+		 */
+		shared_buffer() noexcept = default;
+
+		/**
+		 * @brief constructor, the data will be copied into the shared buffer.
+		 */
+		shared_buffer(const void* data, std::size_t size)
+		{
+			this->assign(data, size);
+		}
+
+		/**
+		 * @brief constructor
+		 * The rvalue std::basic_string and std::vector will be moved into the shared buffer without
+		 * copying, other types like std::string_view, char*, asio::const_buffer will be copied.
+		 */
+		template<class T, std::enable_if_t<
+			!std::is_same_v<detail::remove_cvref_t<T>, shared_buffer>, int> = 0>
+		explicit shared_buffer(T&& data)
+		{
+			using data_type = detail::remove_cvref_t<T>;
+
+			if constexpr (!std::is_lvalue_reference_v<T> && (
+				detail::is_template_instance_of_v<std::basic_string, data_type> ||
+				detail::is_template_instance_of_v<std::vector      , data_type>))
+			{
+				std::shared_ptr<data_type> p = std::make_shared<data_type>(std::move(data));
+
+				this->buffer_ = asio::const_buffer(asio::buffer(*p));
+				this->owner_  = std::move(p);
+			}
+			// char* , const char* , char[] , std::string_view
+			else if constexpr (std::is_convertible_v<const data_type&, std::string_view>)
+			{
+				std::string_view sv = data;
+
+				this->assign(sv.data(), sv.size());
+			}
+			else
+			{
+				asio::const_buffer buffer = asio::const_buffer(asio::buffer(data));
+
+				this->assign(buffer.data(), buffer.size());
+			}
+		}
+
+		shared_buffer(shared_buffer&&) noexcept = default;
+		shared_buffer(shared_buffer const&) noexcept = default;
+		shared_buffer& operator=(shared_buffer&&) noexcept = default;
+		shared_buffer& operator=(shared_buffer const&) noexcept = default;
+
+		/**
+		 * @brief get the buffer of the data
+		 */
+		inline asio::const_buffer buffer() const noexcept { return this->buffer_; }
+
+		/**
+		 * @brief get the pointer of the data
+		 */
+		inline const void* data() const noexcept { return this->buffer_.data(); }
+
+		/**
+		 * @brief get the bytes of the data
+		 */
+		inline std::size_t size() const noexcept { return this->buffer_.size(); }
+
+		/**
+		 * @brief check whether the buffer is empty
+		 */
+		inline bool empty() const noexcept { return this->buffer_.size() == 0; }
+
+		/**
+		 * @brief get the number of shared_buffer objects which are sharing the same memory.
+		 */
+		inline long use_count() const noexcept { return this->owner_.use_count(); }
+
+		/**
+		 * @brief get the owner of the memory, the memory is valid while the owner is alive.
+		 */
+		inline const std::shared_ptr<const void>& owner() const noexcept { return this->owner_; }
+
+		/**
+		 * @brief convert the data to std::string_view
+		 */
+		inline std::string_view to_string_view() const noexcept
+		{
+			return std::string_view(static_cast<std::string_view::const_pointer>(
+				this->buffer_.data()), this->buffer_.size());
+		}
+
+	protected:
+		inline void assign(const void* data, std::size_t size)
+		{
+			std::shared_ptr<std::string> p = std::make_shared<std::string>(
+				static_cast<std::string::const_pointer>(data), size);
+
+			this->buffer_ = asio::buffer(*p);
+			this->owner_  = std::move(p);
+		}
+
+	protected:
+		std::shared_ptr<const void> owner_;
+
+		asio::const_buffer          buffer_;
+	};
+}
+
+#ifdef ASIO_STANDALONE
+namespace asio
+#else
+namespace boost::asio
+#endif
+{
+	/*
+	 * used for async_send(asio2::shared_buffer), all the send functions use asio::buffer(data)
+	 * to get the buffer of the data.
+	 */
+	inline asio::const_buffer buffer(const asio2::shared_buffer& data) noexcept
+	{
+		return data.buffer();
+	}
+}
+
+#endif // !__ASIO2_SHARED_BUFFER_HPP__
@@ -0,0 +1,451 @@
+/*
+ * Copyright (c) 2017-2023 zhllxt
+ *
+ * author   : zhllxt
+ * email    : 37792738@qq.com
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef __ASIO2_TIMING_WHEEL_HPP__
+#define __ASIO2_TIMING_WHEEL_HPP__
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <unordered_set>
+
+#include <asio2/external/asio.hpp>
+#include <asio2/external/assert.hpp>
+
+#include <asio2/base/error.hpp>
+
+#include <asio2/base/detail/function.hpp>
+
+/*
+ * the tick of the timing wheel, in milliseconds, the timers which use the timing wheel will
+ * be expired with the precision of the tick.
+ */
+#ifndef ASIO2_TIMING_WHEEL_TICK
+#define ASIO2_TIMING_WHEEL_TICK 100
+#endif
+
+namespace asio2::detail
+{
+	/**
+	 * @brief A hierarchical timing wheel, used for the housekeeping timers of the sessions and
+	 * clients, like the silence timer and the connect timeout timer.
+	 * The wheel has 4 levels of 64 slots, the timers are saved in intrusive lists, so arm and
+	 * cancel are O(1) and don't allocate memory, and only one asio::steady_timer is used to
+	 * drive the whole wheel, instead of one asio::steady_timer for each session.
+	 * With the default 100 milliseconds tick, the wheel can hold timers up to 19 days, a longer
+	 * timer will be expired at the max duration, the caller should check the time and arm again.
+	 * @note all the functions must be called in the io_context thread, and the wheel must be
+	 * created by std::make_shared.
+	 */
+	class timing_wheel : public std::enable_shared_from_this<timing_wheel>
+	{
+	public:
+		using clock_type    = std::chrono::steady_clock;
+		using callback_type = detail::function<void(const error_code&)>;
+
+		static constexpr std::size_t   level_count = 4;
+		static constexpr std::size_t   slot_bits   = 6;
+		static constexpr std::size_t   slot_count  = std::size_t(1) << slot_bits;
+		static constexpr std::size_t   slot_mask   = slot_count - 1;
+		static constexpr std::uint64_t max_ticks   = (std::uint64_t(1) << (slot_bits * level_count)) - 1;
+
+		/**
+		 * @brief A timer of the timing wheel, it is embedded in the object which owns the timer.
+		 * The object must be alive until the callback is called, the callback usually holds the
+		 * shared_ptr of the object.
+		 */
+		struct node
+		{
+			node() noexcept = default;
+			~node() noexcept
+			{
+				ASIO2_ASSERT(!this->linked());
+			}
+
+			node(const node&) = delete;
+			node& operator=(const node&) = delete;
+
+			/**
+			 * @brief check whether the timer is waiting in the wheel.
+			 */
+			inline bool linked() const noexcept { return this->next != nullptr; }
+
+			node*          prev   = nullptr;
+			node*          next   = nullptr;
+			std::uint64_t  expire = 0;
+			callback_type  callback;
+		};
+
+		/**
+		 * @brief constructor
+		 * @param timers - the timers of the io_t, the driving timer is saved into it while it
+		 * is waiting, so the iopool can cancel it when stopping.
+		 */
+		explicit timing_wheel(asio::io_context& ioc, std::unordered_set<asio::steady_timer*>& timers,
+			std::chrono::milliseconds tick = std::chrono::milliseconds(ASIO2_TIMING_WHEEL_TICK))
+			: timer_(ioc)
+			, timers_(timers)
+			, tick_((std::max)(tick, std::chrono::milliseconds(1)))
+			, start_(clock_type::now())
+		{
+			for (auto& level : this->slots_)
+			{
+				for (node& head : level)
+				{
+					head.prev = head.next = std::addressof(head);
+				}
+			}
+		}
+
+		/**
+		 * @brief destructor
+		 */
+		~timing_wheel() noexcept
+		{
+			ASIO2_ASSERT(this->size_ == 0);
+
+			if (this->armed_)
+			{
+				this->timers_.erase(std::addressof(this->timer_));
+			}
+
+			for (auto& level : this->slots_)
+			{
+				for (node& head : level)
+				{
+					while (head.next != std::addressof(head))
+					{
+						node* p = head.next;
+						this->unlink(*p);
+						p->callback.reset();
+					}
+					head.prev = head.next = nullptr;
+				}
+			}
+		}
+
+		timing_wheel(const timing_wheel&) = delete;
+		timing_wheel& operator=(const timing_wheel&) = delete;
+
+		/**
+		 * @brief arm the timer, the callback will be called with an empty error_code after the
+		 * duration elapsed, or with operation_aborted when the timer is canceled.
+		 * if the timer is waiting already, it will be canceled first.
+		 */
+		template<class Rep, class Period, class Fun>
+		inline void add(node& n, std::chrono::duration<Rep, Period> duration, Fun&& fun)
+		{
+			if (n.linked())
+				this->cancel(n);
+
+			clock_type::time_point now = clock_type::now();
+
+			// the wheel has no timers, so no slot need to be processed, jump to current time.
+			if (this->size_ == 0)
+				this->current_ = (std::max)(this->current_, this->ticks_of(now - this->start_) + 1);
+
+			clock_type::duration d = std::chrono::duration_cast<clock_type::duration>(
+				this->tick_ * std::int64_t(max_ticks));
+
+			// avoid overflow, eg: the silence timeout is steady_clock::duration::max()
+			if (duration < d)
+				d = std::chrono::duration_cast<clock_type::duration>(duration);
+
+			std::uint64_t ticks = this->ticks_of(d + (now - this->start_), true);
+
+			n.expire   = (std::max)(ticks, this->current_);
+			n.callback = std::forward<Fun>(fun);
+
+			this->place(n);
+
+			++this->size_;
+
+			this->arm();
+		}
+
+		/**
+		 * @brief cancel the timer, the callback will be posted with operation_aborted.
+		 * @return false if the timer is not waiting in the wheel.
+		 */
+		inline bool cancel(node& n)
+		{
+			if (!n.linked())
+				return false;
+
+			this->unlink(n);
+
+			--this->size_;
+
+			// don't call the callback directly, beacuse the callback maybe holds the last shared_ptr
+			// of the object which is calling the cancel function, the canceled callbacks are called
+			// in one posted handler, to avoid a post for each timer when many sessions are stopped.
+			this->canceled_.emplace_back(std::move(n.callback));
+
+			n.callback.reset();
+
+			if (!this->draining_)
+			{
+				this->draining_ = true;
+
+				asio::post(this->timer_.get_executor(), [wptr = this->weak_from_this()]() mutable
+				{
+					if (std::shared_ptr<timing_wheel> p = wptr.lock())
+					{
+						p->drain();
+					}
+				});
+			}
+
+			return true;
+		}
+
+		/**
+		 * @brief cancel all the timers.
+		 */
+		inline void cancel_all()
+		{
+			for (auto& level : this->slots_)
+			{
+				for (node& head : level)
+				{
+					while (head.next != std::addressof(head))
+					{
+						this->cancel(*head.next);
+					}
+				}
+			}
+		}
+
+		/**
+		 * @brief get the count of the waiting timers.
+		 */
+		inline std::size_t size() const noexcept { return this->size_; }
+
+		/**
+		 * @brief get the tick of the wheel.
+		 */
+		inline std::chrono::milliseconds get_tick() const noexcept { return this->tick_; }
+
+	protected:
+		inline std::uint64_t ticks_of(clock_type::duration d, bool round_up = false) const noexcept
+		{
+			if (d <= clock_type::duration::zero())
+				return 0;
+
+			clock_type::duration tick = std::chrono::duration_cast<clock_type::duration>(this->tick_);
+
+			std::uint64_t ticks = std::uint64_t(d / tick);
+
+			if (round_up && (d % tick) != clock_type::duration::zero())
+				++ticks;
+
+			return ticks;
+		}
+
+		inline void place(node& n) noexcept
+		{
+			std::uint64_t delta = n.expire - this->current_;
+
+			if (delta > max_ticks)
+			{
+				n.expire = this->current_ + max_ticks;
+				delta = max_ticks;
+			}
+
+			std::size_t level = 0;
+
+			while (level + 1 < level_count && delta >= (std::uint64_t(1) << (slot_bits * (level + 1))))
+			{
+				++level;
+			}
+
+			node& head = this->slots_[level][(n.expire >> (slot_bits * level)) & slot_mask];
+
+			n.prev = head.prev;
+			n.next = std::addressof(head);
+			head.prev->next = std::addressof(n);
+			head.prev = std::addressof(n);
+		}
+
+		inline void unlink(node& n) noexcept
+		{
+			n.prev->next = n.next;
+			n.next->prev = n.prev;
+			n.prev = n.next = nullptr;
+		}
+
+		/**
+		 * @brief move the timers of the slot of the upper level to the lower levels.
+		 * @return the index of the slot.
+		 */
+		inline std::size_t cascade(std::size_t level) noexcept
+		{
+			std::size_t index = (this->current_ >> (slot_bits * level)) & slot_mask;
+
+			node& head = this->slots_[level][index];
+
+			while (head.next != std::addressof(head))
+			{
+				node& n = *head.next;
+				this->unlink(n);
+				this->place(n);
+			}
+
+			return index;
+		}
+
+		/**
+		 * @brief process the slot of the current tick, and go to the next tick.
+		 */
+		inline void step()
+		{
+			std::size_t index = this->current_ & slot_mask;
+
+			for (std::size_t level = 1; index == 0 && level < level_count; ++level)
+			{
+				index = this->cascade(level);
+			}
+
+			node& head = this->slots_[0][this->current_ & slot_mask];
+
+			// move the expired timers into a local list first, beacuse the callback maybe arm
+			// a new timer or cancel another timer of this slot.
+			node expired;
+			expired.prev = expired.next = std::addressof(expired);
+
+			if (head.next != std::addressof(head))
+			{
+				expired.next = head.next;
+				expired.prev = head.prev;
+				expired.next->prev = std::addressof(expired);
+				expired.prev->next = std::addressof(expired);
+				head.prev = head.next = std::addressof(head);
+			}
+
+			++this->current_;
+
+			while (expired.next != std::addressof(expired))
+			{
+				node& n = *expired.next;
+
+				this->unlink(n);
+
+				--this->size_;
+
+				callback_type callback = std::move(n.callback);
+
+				n.callback.reset();
+
+				callback(error_code{});
+			}
+
+			expired.prev = expired.next = nullptr;
+		}
+
+		inline void drain()
+		{
+			std::vector<callback_type> callbacks;
+
+			callbacks.swap(this->canceled_);
+
+			this->draining_ = false;
+
+			for (callback_type& callback : callbacks)
+			{
+				callback(asio::error::operation_aborted);
+			}
+
+			// reuse the memory.
+			if (this->canceled_.empty())
+			{
+				callbacks.clear();
+				callbacks.swap(this->canceled_);
+			}
+		}
+
+		inline void arm()
+		{
+			if (this->armed_ || this->size_ == 0)
+				return;
+
+			this->armed_ = true;
+
+			this->timers_.emplace(std::addressof(this->timer_));
+
+			this->timer_.expires_at(this->start_ + this->tick_ * std::int64_t(this->current_));
+			this->timer_.async_wait([wptr = this->weak_from_this()](const error_code& ec) mutable
+			{
+				if (std::shared_ptr<timing_wheel> p = wptr.lock())
+				{
+					p->handle_timer(ec);
+				}
+			});
+		}
+
+		inline void handle_timer(const error_code& ec)
+		{
+			this->armed_ = false;
+
+			this->timers_.erase(std::addressof(this->timer_));
+
+			// the iopool is stopping.
+			if (ec == asio::error::operation_aborted)
+			{
+				this->cancel_all();
+				return;
+			}
+
+			std::uint64_t now = this->ticks_of(clock_type::now() - this->start_);
+
+			while (this->size_ > 0 && this->current_ <= now)
+			{
+				this->step();
+			}
+
+			if (this->size_ == 0)
+				this->current_ = now + 1;
+
+			this->arm();
+		}
+
+	protected:
+		asio::steady_timer                        timer_;
+
+		std::unordered_set<asio::steady_timer*> & timers_;
+
+		std::chrono::milliseconds                 tick_;
+
+		clock_type::time_point                    start_;
+
+		/// the next tick which will be processed.
+		std::uint64_t                             current_ = 1;
+
+		std::size_t                               size_    = 0;
+
+		bool                                      armed_   = false;
+
+		bool                                      draining_ = false;
+
+		/// the callbacks of the canceled timers, they are called in the drain function.
+		std::vector<callback_type>                canceled_;
+
+		node                                      slots_[level_count][slot_count];
+	};
+}
+
+#endif // !__ASIO2_TIMING_WHEEL_HPP__
@@ -0,0 +1,527 @@
+/*
+ * Copyright (c) 2017-2023 zhllxt
+ *
+ * author   : zhllxt
+ * email    : 37792738@qq.com
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef __ASIO2_TRACER_HPP__
+#define __ASIO2_TRACER_HPP__
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+/*
+ * the tracing of the internal completion handlers (the handlers wrapped by make_allocator) and
+ * the user callbacks (bind_recv, bind_connect, ...) is only compiled when ASIO2_ENABLE_TRACE is
+ * defined, and it is disabled at runtime until asio2::tracer::enable is called.
+ */
+#if defined(ASIO2_ENABLE_TRACE)
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <atomic>
+#include <array>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <unordered_map>
+#include <fstream>
+
+#if defined(__GNUG__) || defined(__clang__)
+#	include <cxxabi.h>
+#	include <cstdlib>
+#endif
+
+#include <asio2/base/detail/cpu_affinity.hpp>
+
+/*
+ * the count of the trace events which are kept for each thread, the oldest events are overwritten
+ * when the buffer is full, it must be power of 2.
+ */
+#ifndef ASIO2_TRACE_BUFFER_SIZE
+#define ASIO2_TRACE_BUFFER_SIZE 16384
+#endif
+
+namespace asio2::detail
+{
+	/**
+	 * @brief The static information of a traced code, the name of the trace event is the prefix
+	 * plus the name, or the shortened name of the type if the name is empty.
+	 */
+	struct trace_site
+	{
+		std::string_view      prefix;
+		std::string_view      name;
+		const std::type_info* type = nullptr;
+	};
+
+	template<class Handler>
+	struct handler_trace_site
+	{
+		static inline const trace_site value{ {}, {}, &typeid(Handler) };
+	};
+
+	/**
+	 * @brief The trace events of a thread, only the owner thread writes it, and the dump reads
+	 * it from any thread, the events which are overwritten while reading are skipped.
+	 */
+	class trace_buffer
+	{
+	public:
+		static constexpr std::size_t capacity = std::size_t(ASIO2_TRACE_BUFFER_SIZE);
+
+		static_assert(capacity > 0 && (capacity & (capacity - 1)) == 0,
+			"ASIO2_TRACE_BUFFER_SIZE must be power of 2");
+
+		struct event
+		{
+			const trace_site* site;
+			std::int64_t      start;
+			std::int64_t      end;
+		};
+
+		explicit trace_buffer(std::uint32_t tid, std::string thread_name)
+			: tid_(tid), thread_name_(std::move(thread_name))
+		{
+		}
+
+		inline void push(const trace_site* site, std::int64_t start, std::int64_t end) noexcept
+		{
+			std::uint64_t h = this->head_.load(std::memory_order_relaxed);
+
+			slot& s = this->slots_[h & (capacity - 1)];
+
+			s.site .store(site , std::memory_order_relaxed);
+			s.start.store(start, std::memory_order_relaxed);
+			s.end  .store(end  , std::memory_order_relaxed);
+
+			this->head_.store(h + 1, std::memory_order_release);
+		}
+
+		/**
+		 * @brief copy the events which are not overwritten.
+		 */
+		inline void read(std::vector<event>& events) const
+		{
+			std::uint64_t h1 = this->head_.load(std::memory_order_acquire);
+			std::uint64_t first = h1 > capacity ? h1 - capacity : 0;
+
+			std::size_t offset = events.size();
+
+			for (std::uint64_t i = first; i < h1; ++i)
+			{
+				const slot& s = this->slots_[i & (capacity - 1)];
+
+				events.push_back(event{
+					s.site .load(std::memory_order_relaxed),
+					s.start.load(std::memory_order_relaxed),
+					s.end  .load(std::memory_order_relaxed) });
+			}
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			// the events before h2 - capacity maybe overwritten by the writer while reading.
+			std::uint64_t h2 = this->head_.load(std::memory_order_relaxed);
+
+			if (h2 > first + capacity)
+			{
+				std::size_t n = std::size_t((std::min)(h2 - capacity - first, h1 - first));
+
+				events.erase(events.begin() + offset, events.begin() + offset + n);
+			}
+		}
+
+		inline void clear() noexcept
+		{
+			this->head_.store(0, std::memory_order_release);
+		}
+
+		inline std::uint32_t             tid        () const noexcept { return this->tid_;         }
+		inline std::string        const& thread_name() const noexcept { return this->thread_name_; }
+
+	protected:
+		struct slot
+		{
+			std::atomic<const trace_site*> site { nullptr };
+			std::atomic<std::int64_t>      start{ 0 };
+			std::atomic<std::int64_t>      end  { 0 };
+		};
+
+		std::array<slot, capacity> slots_;
+
+		std::atomic<std::uint64_t> head_{ 0 };
+
+		std::uint32_t              tid_;
+
+		std::string                thread_name_;
+	};
+
+	/**
+	 * @brief Record the run time of the handlers into the buffers of each thread, and export
+	 * them as the chrome trace event json, it can be opened by chrome://tracing or perfetto.
+	 */
+	class tracer
+	{
+	public:
+		/**
+		 * @brief start recording.
+		 * @param sample_rate - record one of every sample_rate handlers of each thread, the
+		 * nested handlers and user callbacks are recorded together with the outermost handler.
+		 */
+		static inline void enable(std::uint32_t sample_rate = 1) noexcept
+		{
+			tracer::sample_rate_.store(sample_rate ? sample_rate : 1, std::memory_order_relaxed);
+			tracer::enabled_.store(true, std::memory_order_release);
+		}
+
+		/**
+		 * @brief stop recording, the recorded events are kept.
+		 */
+		static inline void disable() noexcept
+		{
+			tracer::enabled_.store(false, std::memory_order_release);
+		}
+
+		static inline bool is_enabled() noexcept
+		{
+			return tracer::enabled_.load(std::memory_order_relaxed);
+		}
+
+		static inline std::uint32_t get_sample_rate() noexcept
+		{
+			return tracer::sample_rate_.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief discard all the recorded events.
+		 */
+		static inline void clear()
+		{
+			std::lock_guard<std::mutex> guard(tracer::mutex());
+
+			for (std::shared_ptr<trace_buffer>& p : tracer::buffers())
+			{
+				p->clear();
+			}
+		}
+
+		/**
+		 * @brief get the recorded events as the chrome trace event json.
+		 */
+		static inline std::string dump()
+		{
+			std::vector<std::shared_ptr<trace_buffer>> buffers;
+
+			{
+				std::lock_guard<std::mutex> guard(tracer::mutex());
+
+				buffers = tracer::buffers();
+			}
+
+			std::unordered_map<const trace_site*, std::string> names;
+
+			std::vector<trace_buffer::event> events;
+
+			std::string s;
+
+			s.reserve(4096);
+
+			s += "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+			bool first = true;
+
+			for (std::shared_ptr<trace_buffer>& p : buffers)
+			{
+				std::string tid = std::to_string(p->tid());
+
+				if (!first)
+					s += ',';
+				first = false;
+
+				s += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+				s += tid;
+				s += ",\"args\":{\"name\":\"";
+				tracer::_append_escaped(s, p->thread_name().empty() ?
+					std::string("thread-") + tid : p->thread_name());
+				s += "\"}}";
+
+				events.clear();
+
+				p->read(events);
+
+				for (trace_buffer::event& e : events)
+				{
+					if (!e.site)
+						continue;
+
+					auto it = names.find(e.site);
+					if (it == names.end())
+						it = names.emplace(e.site, tracer::_site_name(*e.site)).first;
+
+					s += ",{\"name\":\"";
+					tracer::_append_escaped(s, it->second);
+					s += "\",\"cat\":\"asio2\",\"ph\":\"X\",\"ts\":";
+					tracer::_append_us(s, e.start);
+					s += ",\"dur\":";
+					tracer::_append_us(s, e.end - e.start);
+					s += ",\"pid\":1,\"tid\":";
+					s += tid;
+					s += '}';
+				}
+			}
+
+			s += "]}";
+
+			return s;
+		}
+
+		/**
+		 * @brief write the recorded events into the file as the chrome trace event json.
+		 */
+		static inline bool dump(const std::string& filepath)
+		{
+			std::ofstream file(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
+
+			if (!file)
+				return false;
+
+			std::string s = tracer::dump();
+
+			file.write(s.data(), std::streamsize(s.size()));
+
+			return bool(file);
+		}
+
+		/**
+		 * @brief get the nanoseconds since the tracer epoch.
+		 */
+		static inline std::int64_t now() noexcept
+		{
+			static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - epoch).count();
+		}
+
+	protected:
+		friend class trace_scope;
+
+		struct thread_state
+		{
+			std::uint32_t                 depth     = 0;
+			std::uint32_t                 countdown = 0;
+			bool                          sampled   = false;
+			std::shared_ptr<trace_buffer> buffer;
+		};
+
+		static inline thread_state& _thread_state() noexcept
+		{
+			thread_local thread_state state;
+
+			return state;
+		}
+
+		/**
+		 * @brief whether the outermost handler should be recorded.
+		 */
+		static inline bool _sample(thread_state& st) noexcept
+		{
+			if (st.countdown > 0)
+			{
+				--st.countdown;
+				return false;
+			}
+
+			st.countdown = tracer::sample_rate_.load(std::memory_order_relaxed) - 1;
+
+			return true;
+		}
+
+		static inline trace_buffer& _buffer(thread_state& st)
+		{
+			if (!st.buffer)
+			{
+				std::lock_guard<std::mutex> guard(tracer::mutex());
+
+				std::vector<std::shared_ptr<trace_buffer>>& buffers = tracer::buffers();
+
+				st.buffer = std::make_shared<trace_buffer>(
+					std::uint32_t(buffers.size() + 1), detail::get_current_thread_name());
+
+				// the buffer is kept after the thread is exited, then its events can be dumped.
+				buffers.emplace_back(st.buffer);
+			}
+
+			return *st.buffer;
+		}
+
+		static inline std::mutex& mutex() noexcept
+		{
+			static std::mutex m;
+			return m;
+		}
+
+		static inline std::vector<std::shared_ptr<trace_buffer>>& buffers() noexcept
+		{
+			static std::vector<std::shared_ptr<trace_buffer>> v;
+			return v;
+		}
+
+		/**
+		 * @brief get the readable name of the trace site, the template arguments and the function
+		 * parameters of the handler type name are removed, eg :
+		 * tcp_send_op::_tcp_send_general()::{lambda()#1}
+		 */
+		static inline std::string _site_name(const trace_site& site)
+		{
+			if (!site.name.empty() || !site.type)
+			{
+				std::string r(site.prefix);
+				r += site.name;
+				return r;
+			}
+
+			std::string name = site.type->name();
+
+		#if defined(__GNUG__) || defined(__clang__)
+			int status = 0;
+			char* p = abi::__cxa_demangle(name.data(), nullptr, nullptr, &status);
+			if (p)
+			{
+				if (status == 0)
+					name = p;
+				std::free(p);
+			}
+		#endif
+
+			std::string r;
+
+			r.reserve(name.size());
+
+			int angle = 0, paren = 0;
+
+			for (char c : name)
+			{
+				if /**/ (c == '<') { ++angle; continue; }
+				else if (c == '>') { if (angle > 0) --angle; continue; }
+
+				if (angle > 0)
+					continue;
+
+				if /**/ (c == '(') { if (paren++ == 0) r += c; continue; }
+				else if (c == ')') { if (paren > 0 && --paren == 0) r += c; continue; }
+
+				if (paren > 0)
+					continue;
+
+				r += c;
+			}
+
+			for (std::string_view prefix : { "asio2::detail::", "class ", "struct " })
+			{
+				for (std::size_t pos = r.find(prefix); pos != std::string::npos; pos = r.find(prefix, pos))
+				{
+					r.erase(pos, prefix.size());
+				}
+			}
+
+			return r;
+		}
+
+		static inline void _append_escaped(std::string& s, std::string_view v)
+		{
+			for (char c : v)
+			{
+				if /**/ (c == '"' || c == '\\') { s += '\\'; s += c; }
+				else if (static_cast<unsigned char>(c) < 0x20) { s += ' '; }
+				else { s += c; }
+			}
+		}
+
+		/**
+		 * @brief append the nanoseconds as the microseconds with 3 decimals.
+		 */
+		static inline void _append_us(std::string& s, std::int64_t ns)
+		{
+			if (ns < 0)
+				ns = 0;
+
+			char buf[32];
+
+			std::snprintf(buf, sizeof(buf), "%lld.%03lld",
+				static_cast<long long>(ns / 1000), static_cast<long long>(ns % 1000));
+
+			s += buf;
+		}
+
+	protected:
+		static inline std::atomic<bool>          enabled_    { false };
+		static inline std::atomic<std::uint32_t> sample_rate_{ 1 };
+	};
+
+	/**
+	 * @brief Record the run time from the construction to the destruction of this object.
+	 */
+	class trace_scope
+	{
+	public:
+		explicit trace_scope(const trace_site& site) noexcept
+		{
+			if (!tracer::is_enabled())
+				return;
+
+			tracer::thread_state& st = tracer::_thread_state();
+
+			if (st.depth++ == 0)
+				st.sampled = tracer::_sample(st);
+
+			this->state_ = &st;
+
+			if (st.sampled)
+			{
+				this->site_  = &site;
+				this->start_ = tracer::now();
+			}
+		}
+
+		~trace_scope()
+		{
+			if (!this->state_)
+				return;
+
+			--(this->state_->depth);
+
+			if (this->site_)
+			{
+				tracer::_buffer(*this->state_).push(this->site_, this->start_, tracer::now());
+			}
+		}
+
+		trace_scope(const trace_scope&) = delete;
+		trace_scope& operator=(const trace_scope&) = delete;
+
+	protected:
+		tracer::thread_state* state_ = nullptr;
+		const trace_site*     site_  = nullptr;
+		std::int64_t          start_ = 0;
+	};
+}
+
+namespace asio2
+{
+	using tracer = detail::tracer;
+}
+
+#endif // ASIO2_ENABLE_TRACE
+
+#endif // !__ASIO2_TRACER_HPP__
@@ -40,6 +40,7 @@
 #include <asio2/base/detail/filesystem.hpp>
 #include <asio2/base/detail/shared_mutex.hpp>
 #include <asio2/base/detail/type_traits.hpp>
+#include <asio2/base/detail/shared_buffer.hpp>
 
 #include <asio2/util/string.hpp>
 
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2017-2023 zhllxt
+ *
+ * author   : zhllxt
+ * email    : 37792738@qq.com
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef __ASIO2_ASYNC_RECV_COMPONENT_HPP__
+#define __ASIO2_ASYNC_RECV_COMPONENT_HPP__
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <string>
+#include <string_view>
+#include <deque>
+
+#include <asio2/base/error.hpp>
+
+#include <asio2/base/detail/function.hpp>
+#include <asio2/base/detail/awaitable.hpp>
+
+namespace asio2::detail
+{
+	/**
+	 * @brief Receive the messages in a coroutine with co_await async_recv(asio::use_awaitable),
+	 * as the other way beside the bind_recv callback. The messages are queued only after the
+	 * async_recv is called the first time or set_async_recv(true) is called, so the objects
+	 * which never use it pay nothing.
+	 * Only the tcp/udp session and client support it, the derived protocols (rpc, http,
+	 * websocket, mqtt ...) deliver their messages by their own callbacks.
+	 */
+	template<class derived_t, class args_t = void>
+	class async_recv_cp
+	{
+	public:
+		using recv_handler_type = detail::function<void(const error_code&, std::string)>;
+
+		/**
+		 * @brief constructor
+		 */
+		async_recv_cp() = default;
+
+		/**
+		 * @brief destructor
+		 */
+		~async_recv_cp() = default;
+
+	public:
+		/**
+		 * @brief set whether queue the received messages for the async_recv.
+		 * It is enabled automatically when the async_recv is called the first time, enable it
+		 * before the start if the first message maybe received before the async_recv is called,
+		 * eg: co_await async_send(request); co_await async_recv(...);
+		 * Note : This function should be called before the start.
+		 */
+		inline derived_t& set_async_recv(bool enabled) noexcept
+		{
+			this->recv_queue_enabled_ = enabled;
+			return static_cast<derived_t&>(*this);
+		}
+
+		/**
+		 * @brief get whether queue the received messages for the async_recv.
+		 */
+		inline bool is_async_recv() const noexcept
+		{
+			return this->recv_queue_enabled_;
+		}
+
+		/**
+		 * @brief Asynchronous receive a message in a coroutine, the message is the same as the
+		 * data of the bind_recv callback, and the bind_recv callback is still called.
+		 * The messages which are received but not taken by async_recv yet are queued, and
+		 * they are discarded when the connection is closed.
+		 * You can call this function on the communication thread and anywhere,it's multi thread safed.
+		 * use like this : auto [ec, msg] = co_await async_recv(asio::as_tuple(asio::use_awaitable));
+		 * Completion signature : void(asio::error_code ec, std::string data)
+		 */
+		template<class CompletionToken,
+			std::enable_if_t<detail::is_awaitable_token_v<CompletionToken>, int> = 0>
+		inline auto async_recv(CompletionToken&& token)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			return asio::async_initiate<CompletionToken, void(error_code, std::string)>(
+			[&derive](auto handler) mutable
+			{
+				recv_handler_type fn = [&derive, handler = std::move(handler)]
+				(const error_code& ec, std::string data) mutable
+				{
+					detail::awaitable_complete(std::move(handler), derive.io_->context().get_executor(),
+						ec, std::move(data));
+				};
+
+				asio::dispatch(derive.io_->context(),
+				[&derive, this_ptr = derive.selfptr(), fn = std::move(fn)]() mutable
+				{
+					detail::ignore_unused(this_ptr);
+
+					derive._async_recv_wait(std::move(fn));
+				});
+			}, token);
+		}
+
+	protected:
+		inline void _async_recv_wait(recv_handler_type&& fn)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			ASIO2_ASSERT(derive.io_->running_in_this_thread());
+
+			this->recv_queue_enabled_ = true;
+
+			if (!this->recv_queue_.empty())
+			{
+				std::string data = std::move(this->recv_queue_.front());
+
+				this->recv_queue_.pop_front();
+
+				fn(error_code{}, std::move(data));
+			}
+			else if (!derive.is_started())
+			{
+				fn(asio::error::not_connected, std::string{});
+			}
+			else
+			{
+				this->recv_handlers_.emplace_back(std::move(fn));
+			}
+		}
+
+		/**
+		 * @brief called by the _fire_recv, after the bind_recv callback is called.
+		 */
+		inline void _async_recv_notify(std::string_view data)
+		{
+			if (!this->recv_queue_enabled_)
+				return;
+
+			if (this->recv_handlers_.empty())
+			{
+				this->recv_queue_.emplace_back(data);
+				return;
+			}
+
+			recv_handler_type fn = std::move(this->recv_handlers_.front());
+
+			this->recv_handlers_.pop_front();
+
+			fn(error_code{}, std::string(data));
+		}
+
+		/**
+		 * @brief called by the _handle_disconnect, complete all the waiting async_recv.
+		 */
+		inline void _async_recv_stop(const error_code& ec)
+		{
+			this->recv_queue_.clear();
+
+			while (!this->recv_handlers_.empty())
+			{
+				recv_handler_type fn = std::move(this->recv_handlers_.front());
+
+				this->recv_handlers_.pop_front();
+
+				fn(ec ? ec : error_code(asio::error::operation_aborted), std::string{});
+			}
+		}
+
+	protected:
+		/// the messages which are received but not taken by the async_recv yet.
+		std::deque<std::string>         recv_queue_;
+
+		/// the handlers of the async_recv which are waiting for a message.
+		std::deque<recv_handler_type>   recv_handlers_;
+
+		/// whether the async_recv is called, the messages are queued only after it.
+		bool                            recv_queue_enabled_ = false;
+	};
+}
+
+#endif // !__ASIO2_ASYNC_RECV_COMPONENT_HPP__
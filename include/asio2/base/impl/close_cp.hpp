@@ -218,6 +218,11 @@ namespace asio2::detail
 					{
 						set_last_error(ec);
 
+					#if defined(ASIO2_ENABLE_METRICS)
+						if (erased)
+							derive.sessions_.metrics_.on_disconnect(ec);
+					#endif
+
 						state_t expected = state_t::stopping;
 						if (derive.state_.compare_exchange_strong(expected, state_t::stopped))
 						{
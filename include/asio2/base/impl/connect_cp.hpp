@@ -24,6 +24,7 @@
 #include <asio2/base/listener.hpp>
 #include <asio2/base/detail/ecs.hpp>
 #include <asio2/base/detail/keepalive_options.hpp>
+#include <asio2/base/detail/busy_poll.hpp>
 
 #include <asio2/base/impl/event_queue_cp.hpp>
 
@@ -414,6 +415,12 @@ namespace asio2::detail
 				// open succeeded. set the keeplive values
 				detail::set_keepalive_options(socket);
 
+				// the io_context thread is in busy poll mode, let the kernel busy poll the socket too.
+				if (std::chrono::microseconds usec = derive.io_->get_socket_busy_poll(); usec.count() > 0)
+				{
+					detail::set_busy_poll(socket, usec, ec_ignore);
+				}
+
 				// We don't call the bind function, beacuse it will be called internally in asio
 				//socket.bind(endpoint);
 
@@ -75,6 +75,29 @@ namespace asio2::detail
 					this->connect_timeout_timer_->cancel();
 				}
 
+				// the client use the connect_timeout_timer_ to check whether the connect is timed
+				// out, so only the session use the timing wheel.
+				if constexpr (derived_t::is_session())
+				{
+					if (derive.io_->is_timing_wheel_enabled())
+					{
+						this->connect_timeout_timer_.reset();
+
+						derive.io_->timing_wheel().add(this->connect_timeout_node_, duration,
+						[&derive, this_ptr = std::move(this_ptr)](const error_code& ec) mutable
+						{
+							ASIO2_ASSERT((!ec) || ec == asio::error::operation_aborted);
+
+							if (ec == asio::error::operation_aborted)
+								return;
+
+							derive._do_disconnect(asio::error::timed_out, std::move(this_ptr));
+						});
+
+						return;
+					}
+				}
+
 				this->connect_timeout_timer_ = std::make_shared<safe_timer>(derive.io_->context());
 
 				derive._post_connect_timeout_timer(std::move(this_ptr), this->connect_timeout_timer_, duration);
@@ -188,10 +211,17 @@ namespace asio2::detail
 
 			derive.dispatch([this]() mutable
 			{
+				derived_t& derive = static_cast<derived_t&>(*this);
+
 			#if defined(_DEBUG) || defined(DEBUG)
 				this->is_stop_connect_timeout_timer_called_ = true;
 			#endif
 
+				if (this->connect_timeout_node_.linked())
+				{
+					derive.io_->timing_wheel().cancel(this->connect_timeout_node_);
+				}
+
 				if (this->connect_timeout_timer_)
 				{
 					this->connect_timeout_timer_->cancel();
@@ -204,6 +234,9 @@ namespace asio2::detail
 		/// to reduce memory space occupied when running
 		std::shared_ptr<safe_timer>                 connect_timeout_timer_;
 
+		/// used instead of the connect_timeout_timer_ for the session when the timing wheel is enabled
+		timing_wheel::node                          connect_timeout_node_;
+
 		std::chrono::steady_clock::duration         connect_timeout_         = std::chrono::seconds(30);
 
 	#if defined(_DEBUG) || defined(DEBUG)
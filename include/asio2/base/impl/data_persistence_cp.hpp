@@ -26,6 +26,7 @@
 #include <asio2/base/detail/util.hpp>
 #include <asio2/base/detail/function_traits.hpp>
 #include <asio2/base/detail/buffer_wrap.hpp>
+#include <asio2/base/detail/shared_buffer.hpp>
 
 namespace asio2::detail
 {
@@ -109,6 +110,38 @@ namespace asio2::detail
 				std::basic_string<value_type>(s, std::size_t(count)));
 		}
 
+		/**
+		 * @brief make the data into a shared buffer, the data_filter_before_send is called once here,
+		 * then the shared buffer can be sent to many sessions without copying.
+		 */
+		template<class... Args>
+		inline asio2::shared_buffer _make_shared_buffer(Args&&... args)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			return asio2::shared_buffer(derive._data_persistence(std::forward<Args>(args)...));
+		}
+
+		// the shared buffer is immutable and it's memory is shared by many sessions, so it can't be
+		// passed to the data_filter_before_send, see shared_buffer.hpp
+		template<typename = void>
+		inline asio2::shared_buffer _data_persistence(asio2::shared_buffer& data) noexcept
+		{
+			return data;
+		}
+
+		template<typename = void>
+		inline asio2::shared_buffer _data_persistence(const asio2::shared_buffer& data) noexcept
+		{
+			return data;
+		}
+
+		template<typename = void>
+		inline asio2::shared_buffer _data_persistence(asio2::shared_buffer&& data) noexcept
+		{
+			return std::move(data);
+		}
+
 		template<typename = void>
 		inline auto _data_persistence(asio::const_buffer& data) noexcept
 		{
@@ -21,6 +21,7 @@
 #include <string>
 #include <future>
 #include <queue>
+#include <vector>
 #include <tuple>
 #include <utility>
 #include <string_view>
@@ -31,6 +32,7 @@
 #include <asio2/base/detail/function_traits.hpp>
 #include <asio2/base/detail/buffer_wrap.hpp>
 #include <asio2/base/detail/function.hpp>
+#include <asio2/base/detail/mpsc_queue.hpp>
 
 #ifndef ASIO2_EVENT_QUEUE_STACK_MAX_SIZE
 #define ASIO2_EVENT_QUEUE_STACK_MAX_SIZE 256
@@ -397,7 +399,7 @@ namespace asio2::detail
 		 */
 		inline std::size_t get_pending_event_count() const noexcept
 		{
-			return this->events_.size();
+			return this->events_.size() + this->inbox_.size();
 		}
 
 		/**
@@ -421,20 +423,7 @@ namespace asio2::detail
 			};
 
 			// Make sure we run on the io_context thread
-			// beacuse the callback "fn" hold the derived_ptr already,
-			// so this callback for asio::dispatch don't need hold the derived_ptr again.
-			asio::post(derive.io_->context(), make_allocator(derive.wallocator(),
-			[this, fn = std::move(fn)]() mutable
-			{
-				ASIO2_ASSERT(this->events_.size() < std::size_t(32767));
-
-				bool empty = this->events_.empty();
-				this->events_.emplace(std::move(fn));
-				if (empty)
-				{
-					(this->events_.front())(event_queue_guard<derived_t>{static_cast<derived_t&>(*this)});
-				}
-			}));
+			this->_post_to_inbox(std::move(fn));
 
 			return derive;
 		}
@@ -463,20 +452,7 @@ namespace asio2::detail
 			};
 
 			// Make sure we run on the io_context thread
-			// beacuse the callback "fn" hold the derived_ptr already,
-			// so this callback for asio::dispatch don't need hold the derived_ptr again.
-			asio::post(derive.io_->context(), make_allocator(derive.wallocator(),
-			[this, fn = std::move(fn)]() mutable
-			{
-				ASIO2_ASSERT(this->events_.size() < std::size_t(32767));
-
-				bool empty = this->events_.empty();
-				this->events_.emplace(std::move(fn));
-				if (empty)
-				{
-					(this->events_.front())(event_queue_guard<derived_t>{static_cast<derived_t&>(*this)});
-				}
-			}));
+			this->_post_to_inbox(std::move(fn));
 
 			return future;
 		}
@@ -509,6 +485,10 @@ namespace asio2::detail
 
 				bool empty = this->events_.empty();
 				this->events_.emplace(std::forward<Callback>(func));
+				this->events_pushed_++;
+			#if defined(ASIO2_ENABLE_METRICS)
+				derive.io_->counters().events.fetch_add(1, std::memory_order_relaxed);
+			#endif
 				if (empty)
 				{
 					(this->events_.front())(event_queue_guard<derived_t>{derive});
@@ -518,20 +498,7 @@ namespace asio2::detail
 			}
 		#endif
 
-			// beacuse the callback "func" hold the derived_ptr already,
-			// so this callback for asio::dispatch don't need hold the derived_ptr again.
-			asio::post(derive.io_->context(), make_allocator(derive.wallocator(),
-			[this, func = std::forward<Callback>(func)]() mutable
-			{
-				ASIO2_ASSERT(this->events_.size() < std::size_t(32767));
-
-				bool empty = this->events_.empty();
-				this->events_.emplace(std::move(func));
-				if (empty)
-				{
-					(this->events_.front())(event_queue_guard<derived_t>{static_cast<derived_t&>(*this)});
-				}
-			}));
+			this->_post_to_inbox(std::forward<Callback>(func));
 
 			return derive;
 		}
@@ -548,20 +515,7 @@ namespace asio2::detail
 			derived_t& derive = static_cast<derived_t&>(*this);
 
 			// Make sure we run on the io_context thread
-			// beacuse the callback "func" hold the derived_ptr already,
-			// so this callback for asio::dispatch don't need hold the derived_ptr again.
-			asio::post(derive.io_->context(), make_allocator(derive.wallocator(),
-			[this, func = std::forward<Callback>(func)]() mutable
-			{
-				ASIO2_ASSERT(this->events_.size() < std::size_t(32767));
-
-				bool empty = this->events_.empty();
-				this->events_.emplace(std::move(func));
-				if (empty)
-				{
-					(this->events_.front())(event_queue_guard<derived_t>{static_cast<derived_t&>(*this)});
-				}
-			}));
+			this->_post_to_inbox(std::forward<Callback>(func));
 
 			return derive;
 		}
@@ -623,6 +577,9 @@ namespace asio2::detail
 					if (!this->events_.empty())
 					{
 						this->events_.pop();
+					#if defined(ASIO2_ENABLE_METRICS)
+						derive.io_->counters().events.fetch_sub(1, std::memory_order_relaxed);
+					#endif
 
 						if (!this->events_.empty())
 						{
@@ -660,6 +617,9 @@ namespace asio2::detail
 				if (!this->events_.empty())
 				{
 					this->events_.pop();
+				#if defined(ASIO2_ENABLE_METRICS)
+					static_cast<derived_t&>(*this).io_->counters().events.fetch_sub(1, std::memory_order_relaxed);
+				#endif
 
 					if (!this->events_.empty())
 					{
@@ -679,11 +639,139 @@ namespace asio2::detail
 			return derive;
 		}
 
+	protected:
+		using event_type = detail::function<
+			void(event_queue_guard<derived_t>), detail::function_size_traits<args_t>::value>;
+
+		/// The node of the inbox, it holds the event which was posted by other threads.
+		struct inbox_node : public mpsc_queue::node
+		{
+			template<class Callback>
+			explicit inbox_node(Callback&& f) : event(std::forward<Callback>(f)) {}
+
+			event_type event;
+		};
+
+		/**
+		 * The handler which was posted to the io_context to drain the inbox, if the handler is
+		 * destroyed without invoked (eg: the io_context is destroyed), the events in the inbox
+		 * will be destroyed, otherwise the events and this object will never be released,
+		 * beacuse the events hold the derived_ptr.
+		 */
+		struct inbox_waker
+		{
+			explicit inbox_waker(event_queue_cp* p) noexcept : queue(p) {}
+
+			inbox_waker(inbox_waker&& o) noexcept : queue(std::exchange(o.queue, nullptr)) {}
+
+			inbox_waker(const inbox_waker&) = delete;
+			inbox_waker& operator=(const inbox_waker&) = delete;
+			inbox_waker& operator=(inbox_waker&&) = delete;
+
+			~inbox_waker()
+			{
+				if (queue)
+				{
+					std::exchange(queue, nullptr)->_discard_inbox();
+				}
+			}
+
+			inline void operator()()
+			{
+				std::exchange(queue, nullptr)->_drain_inbox();
+			}
+
+			event_queue_cp* queue = nullptr;
+		};
+
+		/**
+		 * push the event into the inbox, only the first event after the inbox become non-empty
+		 * post a handler to the io_context, the following events will be drained by the same
+		 * handler, so the events of a burst only need one post and one wakeup.
+		 * note : the event must hold the derived_ptr itself
+		 */
+		template<class Callback>
+		inline void _post_to_inbox(Callback&& func)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			inbox_node* n = new inbox_node(std::forward<Callback>(func));
+
+			if (this->inbox_.push(n))
+			{
+				// beacuse the event in the inbox hold the derived_ptr already, and the inbox can't
+				// be empty before the handler is called, so the handler don't need hold the 
+				// derived_ptr again.
+				asio::post(derive.io_->context(), make_allocator(derive.wallocator(), inbox_waker{ this }));
+			}
+		}
+
+		/**
+		 * move all the events of the inbox into the event queue, and execute the front event if
+		 * the event queue was empty.
+		 */
+		inline void _drain_inbox()
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			ASIO2_ASSERT(derive.io_->running_in_this_thread());
+
+			bool empty = this->events_.empty();
+
+			this->inbox_.consume_all([this](mpsc_queue::node* p) mutable
+			{
+				inbox_node* n = static_cast<inbox_node*>(p);
+
+				ASIO2_ASSERT(this->events_.size() < std::size_t(32767));
+
+				this->events_.emplace(std::move(n->event));
+				this->events_pushed_++;
+			#if defined(ASIO2_ENABLE_METRICS)
+				static_cast<derived_t&>(*this).io_->counters().events.fetch_add(1, std::memory_order_relaxed);
+			#endif
+
+				delete n;
+			});
+
+			// the events_ hold the derived_ptr, so "this" is still valid here.
+			if (empty && !this->events_.empty())
+			{
+				(this->events_.front())(event_queue_guard<derived_t>{derive});
+			}
+		}
+
+		/**
+		 * destroy all the events of the inbox without execute them.
+		 */
+		inline void _discard_inbox()
+		{
+			std::vector<event_type> events;
+
+			this->inbox_.consume_all([&events](mpsc_queue::node* p) mutable
+			{
+				inbox_node* n = static_cast<inbox_node*>(p);
+
+				events.emplace_back(std::move(n->event));
+
+				delete n;
+			});
+
+			// the events maybe hold the last derived_ptr, so destroy them after the inbox is empty.
+			events.clear();
+		}
+
 	protected:
 		std::int16_t event_stack_size_{ std::int16_t(0) };
 
-		std::queue<detail::function<
-			void(event_queue_guard<derived_t>), detail::function_size_traits<args_t>::value>> events_;
+		/// How many events were pushed into the event queue, it is used to check whether
+		/// a event was pushed after the specified event. Only read/write it in the io thread.
+		std::size_t  events_pushed_{ 0 };
+
+		std::queue<event_type> events_;
+
+		/// The events which were posted by other threads, they are moved into the events_ in
+		/// batch by the io thread.
+		mpsc_queue             inbox_;
 	};
 }
 
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2017-2023 zhllxt
+ *
+ * author   : zhllxt
+ * email    : 37792738@qq.com
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef __ASIO2_METRICS_COMPONENT_HPP__
+#define __ASIO2_METRICS_COMPONENT_HPP__
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <chrono>
+
+#include <asio2/base/detail/metrics.hpp>
+
+namespace asio2::detail
+{
+	/**
+	 * @brief the metrics of a session or a client, it is empty if ASIO2_ENABLE_METRICS is not defined.
+	 */
+	template<class derived_t, class args_t>
+	class metrics_cp
+	{
+	public:
+		/**
+		 * @brief constructor
+		 */
+		metrics_cp() = default;
+
+		/**
+		 * @brief destructor
+		 */
+		~metrics_cp() = default;
+
+	#if defined(ASIO2_ENABLE_METRICS)
+	public:
+		/**
+		 * @brief get the metrics of this session or client, the counters of a client are
+		 * accumulated across the reconnections.
+		 */
+		inline asio2::connection_metrics get_metrics() const noexcept
+		{
+			return this->metrics_.snapshot();
+		}
+
+		/**
+		 * @brief get the hit and miss counters of the handler allocators of this session or client.
+		 */
+		inline asio2::allocator_metrics get_allocator_metrics() const noexcept
+		{
+			derived_t& derive = const_cast<derived_t&>(static_cast<const derived_t&>(*this));
+
+			asio2::allocator_metrics m;
+
+			if (static_cast<const void*>(&derive.rallocator()) == static_cast<const void*>(&derive.wallocator()))
+			{
+				m.wallocator = derive.wallocator().stats();
+			}
+			else
+			{
+				m.rallocator = derive.rallocator().stats();
+				m.wallocator = derive.wallocator().stats();
+			}
+
+			return m;
+		}
+
+	protected:
+		/**
+		 * @brief count a received message, and the run time of its recv handler.
+		 */
+		inline void _metrics_recv(std::size_t bytes, std::chrono::steady_clock::duration elapsed) noexcept
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			this->metrics_.on_recv(bytes);
+
+			io_counters& c = derive.io_->counters();
+
+			c.on_recv(bytes);
+			c.handler_latency.record(elapsed);
+		}
+
+		/**
+		 * @brief count the messages which are handed to the socket.
+		 */
+		inline void _metrics_send(std::size_t messages) noexcept
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			this->metrics_.on_send(messages);
+
+			derive.io_->counters().on_send(messages);
+		}
+
+		/**
+		 * @brief count the bytes which are written to the socket.
+		 */
+		inline void _metrics_sent(std::size_t bytes) noexcept
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			this->metrics_.on_sent(bytes);
+
+			derive.io_->counters().on_sent(bytes);
+		}
+
+	protected:
+		/// the counters of this session or client.
+		connection_counters metrics_;
+	#endif
+	};
+}
+
+#endif // !__ASIO2_METRICS_COMPONENT_HPP__
@@ -30,6 +30,8 @@
 #include <tuple>
 #include <utility>
 #include <string_view>
+#include <atomic>
+#include <limits>
 
 #include <asio2/base/iopool.hpp>
 #include <asio2/base/define.hpp>
@@ -37,6 +39,9 @@
 #include <asio2/base/detail/util.hpp>
 #include <asio2/base/detail/function_traits.hpp>
 #include <asio2/base/detail/buffer_wrap.hpp>
+#include <asio2/base/detail/send_batch.hpp>
+#include <asio2/base/detail/send_pressure.hpp>
+#include <asio2/base/detail/awaitable.hpp>
 
 #include <asio2/base/impl/data_persistence_cp.hpp>
 
@@ -49,6 +54,8 @@ namespace asio2::detail
 	{
 		ASIO2_CLASS_FRIEND_DECLARE_BASE;
 
+		template<class> friend class send_ticket;
+
 	public:
 		/**
 		 * @brief constructor
@@ -60,6 +67,116 @@ namespace asio2::detail
 		 */
 		~send_cp() = default;
 
+	protected:
+		template<class, class = std::void_t<>>
+		struct has_member_send_batch : std::false_type {};
+
+		template<class T>
+		struct has_member_send_batch<T, std::void_t<decltype(std::declval<T&>()._do_send_batch(
+			std::declval<send_batch&>(), std::declval<send_batch::callback_type>()))>> : std::true_type {};
+
+		template<class, class = std::void_t<>>
+		struct is_tcp_socket : std::false_type {};
+
+		template<class T>
+		struct is_tcp_socket<T, std::void_t<typename T::protocol_type>>
+			: std::is_same<typename T::protocol_type, asio::ip::tcp> {};
+
+	public:
+		/**
+		 * @brief set whether coalesce the queued sends into a single gather write.
+		 * When enabled, all the datas passed to async_send/send while a write is in flight are
+		 * written together with one scatter/gather write (writev), and the callback of each
+		 * async_send is still called with its own sent bytes.
+		 * Only the tcp/tcps session and client (general and dgram mode) support it, for the
+		 * others (udp, http, websocket, mqtt ...) this option is ignored.
+		 * Note : when enabled, the data which is not std::string or asio::buffer(...) will
+		 *        be copied into a std::string.
+		 */
+		inline derived_t& set_send_coalesce(bool enabled) noexcept
+		{
+			this->send_coalesce_ = enabled;
+			return static_cast<derived_t&>(*this);
+		}
+
+		/**
+		 * @brief get whether coalesce the queued sends into a single gather write.
+		 */
+		inline bool is_send_coalesce() const noexcept
+		{
+			return this->send_coalesce_;
+		}
+
+		/**
+		 * @brief set the high and low watermark of the bytes of the queued sends.
+		 * When the queued bytes exceed the high watermark, the send pressure notification is called
+		 * with paused = true, and when the queued bytes fall to the low watermark again, it is called
+		 * with paused = false, so the producer can stop and resume sending.
+		 * The queued sends are the datas which are passed to async_send/send and not sent yet.
+		 * Note : This function should be called before the start.
+		 */
+		inline derived_t& set_send_watermark(std::size_t high_bytes, std::size_t low_bytes) noexcept
+		{
+			ASIO2_ASSERT(low_bytes <= high_bytes);
+
+			this->send_high_bytes_ = high_bytes;
+			this->send_low_bytes_  = (std::min)(low_bytes, high_bytes);
+			this->send_pressure_   = true;
+			return static_cast<derived_t&>(*this);
+		}
+
+		/**
+		 * @brief set the high and low watermark of the count of the queued sends.
+		 * Note : This function should be called before the start.
+		 */
+		inline derived_t& set_send_watermark_count(std::size_t high_count, std::size_t low_count) noexcept
+		{
+			ASIO2_ASSERT(low_count <= high_count);
+
+			this->send_high_count_ = high_count;
+			this->send_low_count_  = (std::min)(low_count, high_count);
+			this->send_pressure_   = true;
+			return static_cast<derived_t&>(*this);
+		}
+
+		/**
+		 * @brief set the max bytes of the queued sends, and what to do with a new send when the
+		 * queued bytes would exceed it, see asio2::send_policy.
+		 * Note : This function should be called before the start.
+		 */
+		inline derived_t& set_send_budget(std::size_t bytes, send_policy policy = send_policy::reject)
+		{
+			this->send_budget_   = std::make_shared<send_budget>(bytes, policy);
+			this->send_pressure_ = true;
+			return static_cast<derived_t&>(*this);
+		}
+
+		/**
+		 * @brief get the bytes of the queued sends, it is always 0 if neither the watermark nor
+		 * the budget is setted.
+		 */
+		inline std::size_t get_send_queued_bytes() const noexcept
+		{
+			return this->send_queued_bytes_.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief get the count of the queued sends, it is always 0 if neither the watermark nor
+		 * the budget is setted.
+		 */
+		inline std::size_t get_send_queued_count() const noexcept
+		{
+			return this->send_queued_count_.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief check whether the queued sends are above the high watermark.
+		 */
+		inline bool is_send_paused() const noexcept
+		{
+			return this->send_paused_.load(std::memory_order_relaxed);
+		}
+
 	public:
 		/**
 		 * @brief Asynchronous send data, support multiple data formats,
@@ -94,8 +211,26 @@ namespace asio2::detail
 			// 7. beacuse the iopool is stopped alreadly, so the "derive.push_event(" and
 			//    "derive._do_send(..." will can't be executed.
 
+			if constexpr (has_member_send_batch<derived_t>::value)
+			{
+				if (derive.is_send_coalesce())
+				{
+					derive._send_coalesce(derive._data_persistence(std::forward<DataT>(data)),
+						send_batch::callback_type{});
+					return;
+				}
+			}
+
+			// the send is rejected if the send budget is exhausted.
+			auto t = derive._send_admit(detail::send_size(data));
+			if (!t)
+			{
+				set_last_error(asio::error::no_buffer_space);
+				return;
+			}
+
 			derive.push_event(
-			[&derive, p = derive.selfptr(), id = derive.life_id(),
+			[&derive, t = std::move(t), id = derive.life_id(),
 				data = derive._data_persistence(std::forward<DataT>(data))]
 			(event_queue_guard<derived_t> g) mutable
 			{
@@ -111,6 +246,13 @@ namespace asio2::detail
 					return;
 				}
 
+				// the oldest sends are dropped by the drop_oldest policy of the send budget.
+				if (derive._send_dropped(t.bytes()))
+				{
+					set_last_error(asio::error::no_buffer_space);
+					return;
+				}
+
 				clear_last_error();
 
 				derive._do_send(data, [g = std::move(g)](const error_code&, std::size_t) mutable {});
@@ -149,11 +291,27 @@ namespace asio2::detail
 
 			detail::integer_add_sub_guard asg(derive.io_->pending());
 
+			if constexpr (has_member_send_batch<derived_t>::value)
+			{
+				if (derive.is_send_coalesce())
+				{
+					derive._send_coalesce(derive._data_persistence(s, count), send_batch::callback_type{});
+					return;
+				}
+			}
+
 			// We must ensure that there is only one operation to send data
 			// at the same time,otherwise may be cause crash.
 
+			auto t = derive._send_admit(std::size_t(count) * sizeof(CharT));
+			if (!t)
+			{
+				set_last_error(asio::error::no_buffer_space);
+				return;
+			}
+
 			derive.push_event(
-			[&derive, p = derive.selfptr(), id = derive.life_id(), data = derive._data_persistence(s, count)]
+			[&derive, t = std::move(t), id = derive.life_id(), data = derive._data_persistence(s, count)]
 			(event_queue_guard<derived_t> g) mutable
 			{
 				if (!derive.is_started())
@@ -168,6 +326,12 @@ namespace asio2::detail
 					return;
 				}
 
+				if (derive._send_dropped(t.bytes()))
+				{
+					set_last_error(asio::error::no_buffer_space);
+					return;
+				}
+
 				clear_last_error();
 
 				derive._do_send(data, [g = std::move(g)](const error_code&, std::size_t) mutable {});
@@ -209,8 +373,29 @@ namespace asio2::detail
 
 			detail::integer_add_sub_guard asg(derive.io_->pending());
 
+			if constexpr (has_member_send_batch<derived_t>::value)
+			{
+				if (derive.is_send_coalesce())
+				{
+					derive._send_coalesce(derive._data_persistence(std::forward<DataT>(data)),
+					[promise = std::move(promise)](const error_code& ec, std::size_t bytes_sent) mutable
+					{
+						promise.set_value(std::pair<error_code, std::size_t>(ec, bytes_sent));
+					});
+					return future;
+				}
+			}
+
+			auto t = derive._send_admit(detail::send_size(data));
+			if (!t)
+			{
+				set_last_error(asio::error::no_buffer_space);
+				promise.set_value(std::pair<error_code, std::size_t>(asio::error::no_buffer_space, 0));
+				return future;
+			}
+
 			derive.push_event(
-			[&derive, p = derive.selfptr(), id = derive.life_id(), promise = std::move(promise),
+			[&derive, t = std::move(t), id = derive.life_id(), promise = std::move(promise),
 				data = derive._data_persistence(std::forward<DataT>(data))]
 			(event_queue_guard<derived_t> g) mutable
 			{
@@ -228,6 +413,13 @@ namespace asio2::detail
 					return;
 				}
 
+				if (derive._send_dropped(t.bytes()))
+				{
+					set_last_error(asio::error::no_buffer_space);
+					promise.set_value(std::pair<error_code, std::size_t>(asio::error::no_buffer_space, 0));
+					return;
+				}
+
 				clear_last_error();
 
 				derive._do_send(data, [&promise, g = std::move(g)]
@@ -284,8 +476,29 @@ namespace asio2::detail
 
 			detail::integer_add_sub_guard asg(derive.io_->pending());
 
+			if constexpr (has_member_send_batch<derived_t>::value)
+			{
+				if (derive.is_send_coalesce())
+				{
+					derive._send_coalesce(derive._data_persistence(s, count),
+					[promise = std::move(promise)](const error_code& ec, std::size_t bytes_sent) mutable
+					{
+						promise.set_value(std::pair<error_code, std::size_t>(ec, bytes_sent));
+					});
+					return future;
+				}
+			}
+
+			auto t = derive._send_admit(std::size_t(count) * sizeof(CharT));
+			if (!t)
+			{
+				set_last_error(asio::error::no_buffer_space);
+				promise.set_value(std::pair<error_code, std::size_t>(asio::error::no_buffer_space, 0));
+				return future;
+			}
+
 			derive.push_event(
-			[&derive, p = derive.selfptr(), id = derive.life_id(), promise = std::move(promise),
+			[&derive, t = std::move(t), id = derive.life_id(), promise = std::move(promise),
 				data = derive._data_persistence(s, count)]
 			(event_queue_guard<derived_t> g) mutable
 			{
@@ -303,6 +516,13 @@ namespace asio2::detail
 					return;
 				}
 
+				if (derive._send_dropped(t.bytes()))
+				{
+					set_last_error(asio::error::no_buffer_space);
+					promise.set_value(std::pair<error_code, std::size_t>(asio::error::no_buffer_space, 0));
+					return;
+				}
+
 				clear_last_error();
 
 				derive._do_send(data, [&promise, g = std::move(g)]
@@ -334,11 +554,32 @@ namespace asio2::detail
 
 			detail::integer_add_sub_guard asg(derive.io_->pending());
 
+			if constexpr (has_member_send_batch<derived_t>::value)
+			{
+				if (derive.is_send_coalesce())
+				{
+					derive._send_coalesce(derive._data_persistence(std::forward<DataT>(data)),
+					[fn = std::forward<Callback>(fn)](const error_code&, std::size_t bytes_sent) mutable
+					{
+						callback_helper::call(fn, bytes_sent);
+					});
+					return;
+				}
+			}
+
 			// We must ensure that there is only one operation to send data
 			// at the same time,otherwise may be cause crash.
 
+			auto t = derive._send_admit(detail::send_size(data));
+			if (!t)
+			{
+				set_last_error(asio::error::no_buffer_space);
+				callback_helper::call(fn, 0);
+				return;
+			}
+
 			derive.push_event(
-			[&derive, p = derive.selfptr(), id = derive.life_id(), fn = std::forward<Callback>(fn),
+			[&derive, t = std::move(t), id = derive.life_id(), fn = std::forward<Callback>(fn),
 				data = derive._data_persistence(std::forward<DataT>(data))]
 			(event_queue_guard<derived_t> g) mutable
 			{
@@ -356,6 +597,13 @@ namespace asio2::detail
 					return;
 				}
 
+				if (derive._send_dropped(t.bytes()))
+				{
+					set_last_error(asio::error::no_buffer_space);
+					callback_helper::call(fn, 0);
+					return;
+				}
+
 				clear_last_error();
 
 				derive._do_send(data, [&fn, g = std::move(g)]
@@ -397,11 +645,32 @@ namespace asio2::detail
 
 			detail::integer_add_sub_guard asg(derive.io_->pending());
 
+			if constexpr (has_member_send_batch<derived_t>::value)
+			{
+				if (derive.is_send_coalesce() && s)
+				{
+					derive._send_coalesce(derive._data_persistence(s, count),
+					[fn = std::forward<Callback>(fn)](const error_code&, std::size_t bytes_sent) mutable
+					{
+						callback_helper::call(fn, bytes_sent);
+					});
+					return;
+				}
+			}
+
 			// We must ensure that there is only one operation to send data
 			// at the same time,otherwise may be cause crash.
 
+			auto t = derive._send_admit(s ? std::size_t(count) * sizeof(CharT) : std::size_t(0));
+			if (!t)
+			{
+				set_last_error(asio::error::no_buffer_space);
+				callback_helper::call(fn, 0);
+				return;
+			}
+
 			derive.push_event(
-			[&derive, p = derive.selfptr(), id = derive.life_id(), fn = std::forward<Callback>(fn),
+			[&derive, t = std::move(t), id = derive.life_id(), fn = std::forward<Callback>(fn),
 				s, data = derive._data_persistence(s, count)]
 			(event_queue_guard<derived_t> g) mutable
 			{
@@ -426,6 +695,13 @@ namespace asio2::detail
 					return;
 				}
 
+				if (derive._send_dropped(t.bytes()))
+				{
+					set_last_error(asio::error::no_buffer_space);
+					callback_helper::call(fn, 0);
+					return;
+				}
+
 				clear_last_error();
 
 				derive._do_send(data, [&fn, g = std::move(g)]
@@ -436,6 +712,61 @@ namespace asio2::detail
 			});
 		}
 
+	public:
+		/**
+		 * @brief Asynchronous send data in a coroutine, the data formats are the same as the
+		 *        async_send(data, callback).
+		 * You can call this function on the communication thread and anywhere,it's multi thread safed.
+		 * use like this : auto [ec, bytes] = co_await async_send("abc", asio::as_tuple(asio::use_awaitable));
+		 * The token can be asio::use_awaitable, asio::as_tuple(asio::use_awaitable) or
+		 * asio::redirect_error(asio::use_awaitable, ec).
+		 * Completion signature : void(asio::error_code ec, std::size_t bytes_sent)
+		 * When the coroutine runs on the io_context of this object, it is resumed on the io
+		 * thread directly after the data is sent, without an additional post.
+		 */
+		template<class DataT, class CompletionToken,
+			std::enable_if_t<detail::is_awaitable_token_v<CompletionToken>, int> = 0>
+		inline auto async_send(DataT&& data, CompletionToken&& token)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			return asio::async_initiate<CompletionToken, void(error_code, std::size_t)>(
+			[&derive](auto handler, auto data) mutable
+			{
+				derive.async_send(std::move(data),
+				[&derive, handler = std::move(handler)](std::size_t bytes_sent) mutable
+				{
+					detail::awaitable_complete(std::move(handler), derive.io_->context().get_executor(),
+						get_last_error(), bytes_sent);
+				});
+			}, token, std::forward<DataT>(data));
+		}
+
+		/**
+		 * @brief Asynchronous send data in a coroutine
+		 * You can call this function on the communication thread and anywhere,it's multi thread safed.
+		 * PodType (&data)[N] : double m[10]; co_await async_send(m, 5, asio::use_awaitable);
+		 * Completion signature : void(asio::error_code ec, std::size_t bytes_sent)
+		 */
+		template<class CharT, class SizeT, class CompletionToken,
+			std::enable_if_t<detail::is_awaitable_token_v<CompletionToken> &&
+			std::is_integral_v<detail::remove_cvref_t<SizeT>>, int> = 0>
+		inline auto async_send(CharT * s, SizeT count, CompletionToken&& token)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			return asio::async_initiate<CompletionToken, void(error_code, std::size_t)>(
+			[&derive, s, count](auto handler) mutable
+			{
+				derive.async_send(s, count,
+				[&derive, handler = std::move(handler)](std::size_t bytes_sent) mutable
+				{
+					detail::awaitable_complete(std::move(handler), derive.io_->context().get_executor(),
+						get_last_error(), bytes_sent);
+				});
+			}, token);
+		}
+
 	public:
 		/**
 		 * @brief Synchronous send data, support multiple data formats,
@@ -677,6 +1008,429 @@ namespace asio2::detail
 				});
 			}, std::move(g));
 		}
+
+	protected:
+		/**
+		 * @brief Put the persisted data into the send batch of the io_context thread.
+		 * You can call this function on the communication thread and anywhere,it's multi thread safed.
+		 */
+		template<class Data>
+		inline void _send_coalesce(Data&& data, send_batch::callback_type&& callback)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			using data_type = detail::remove_cvref_t<Data>;
+
+			std::string                 str;
+			asio::const_buffer          buf;
+			std::shared_ptr<const void> own;
+
+			// the memory of asio::buffer(...) is owned by the user, don't copy it.
+			if /**/ constexpr (std::is_same_v<data_type, std::string>)
+			{
+				str = std::move(data);
+			}
+			else if constexpr (std::is_same_v<data_type, asio::const_buffer>)
+			{
+				buf = data;
+			}
+			else if constexpr (std::is_same_v<data_type, asio2::shared_buffer>)
+			{
+				buf = data.buffer();
+				own = data.owner();
+			}
+			else
+			{
+				auto buffer = asio::buffer(data);
+				str.assign(reinterpret_cast<std::string::const_pointer>(buffer.data()), buffer.size());
+			}
+
+			auto t = derive._send_admit(str.size() + buf.size());
+			if (!t)
+			{
+				set_last_error(asio::error::no_buffer_space);
+				if (callback)
+					callback(asio::error::no_buffer_space, 0);
+				return;
+			}
+
+		#ifndef ASIO2_STRONG_EVENT_ORDER
+			if (derive.io_->running_in_this_thread())
+			{
+				derive._send_coalesce_append(derive.life_id(), std::move(str), buf, std::move(own),
+					std::move(callback), std::move(t));
+				return;
+			}
+		#endif
+
+			asio::post(derive.io_->context(), make_allocator(derive.wallocator(),
+			[&derive, t = std::move(t), id = derive.life_id(), str = std::move(str), buf,
+				own = std::move(own), callback = std::move(callback)]() mutable
+			{
+				derive._send_coalesce_append(std::move(id), std::move(str), buf, std::move(own),
+					std::move(callback), std::move(t));
+			}));
+		}
+
+		template<class LifeId>
+		inline void _send_coalesce_append(
+			LifeId id, std::string&& data, asio::const_buffer buffer, std::shared_ptr<const void>&& owner,
+			send_batch::callback_type&& callback, send_ticket<derived_t>&& ticket)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			ASIO2_ASSERT(derive.io_->running_in_this_thread());
+
+			if (!derive.is_started())
+			{
+				set_last_error(asio::error::not_connected);
+				if (callback)
+					callback(asio::error::not_connected, 0);
+				return;
+			}
+
+			if (id != derive.life_id())
+			{
+				set_last_error(asio::error::operation_aborted);
+				if (callback)
+					callback(asio::error::operation_aborted, 0);
+				return;
+			}
+
+			// The batch is still waiting in the event queue and no other event was pushed after it,
+			// so append the data to it directly, this will not change the order of the events.
+			if (this->send_batch_ && this->send_batch_seq_ == derive.events_pushed_)
+			{
+				this->send_batch_->append(std::move(data), buffer, std::move(owner), std::move(callback));
+				this->_send_ticket_to_batch(*(this->send_batch_), ticket);
+				return;
+			}
+
+			std::unique_ptr<send_batch> batch = std::move(this->send_batch_cache_);
+			if (!batch)
+				batch = std::make_unique<send_batch>();
+
+			batch->append(std::move(data), buffer, std::move(owner), std::move(callback));
+			this->_send_ticket_to_batch(*batch, ticket);
+
+			this->send_batch_ = batch.get();
+
+			// if the event queue is empty, the event will be executed immediately, and the
+			// send_batch_ will be set to nullptr in the event.
+			derive.push_event(
+			[&derive, p = derive.selfptr(), id = derive.life_id(), batch = std::move(batch)]
+			(event_queue_guard<derived_t> g) mutable
+			{
+				// the batch is being sent, the later datas will be put into a new batch.
+				if (derive.send_batch_ == batch.get())
+					derive.send_batch_ = nullptr;
+
+				if (!derive.is_started())
+				{
+					derive._send_release_batch(*batch);
+					batch->complete(asio::error::not_connected, 0);
+					set_last_error(asio::error::not_connected);
+					return;
+				}
+
+				if (id != derive.life_id())
+				{
+					derive._send_release_batch(*batch);
+					batch->complete(asio::error::operation_aborted, 0);
+					set_last_error(asio::error::operation_aborted);
+					return;
+				}
+
+				if (derive._send_dropped(batch->total_bytes))
+				{
+					derive._send_release_batch(*batch);
+					batch->complete(asio::error::no_buffer_space, 0);
+					set_last_error(asio::error::no_buffer_space);
+					return;
+				}
+
+				clear_last_error();
+
+				send_batch& b = *batch;
+
+				derive._do_send_batch(b, [&derive, batch = std::move(batch), g = std::move(g)]
+				(const error_code& ec, std::size_t bytes_sent) mutable
+				{
+					derive._send_release_batch(*batch);
+					batch->complete(ec, bytes_sent);
+
+					// reuse the batch object and its memory for the next batch.
+					if (!derive.send_batch_cache_ && batch->cacheable())
+						derive.send_batch_cache_ = std::move(batch);
+				});
+			});
+
+			this->send_batch_seq_ = derive.events_pushed_;
+		}
+
+	protected:
+		/**
+		 * @brief count a new send into the send watermark and budget.
+		 * @return the ticket of the send, it is empty if the send is rejected by the budget.
+		 */
+		inline send_ticket<derived_t> _send_admit(std::size_t bytes)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			// neither the watermark nor the budget is setted, don't count anything.
+			if (!this->send_pressure_)
+				return send_ticket<derived_t>(derive, derive.selfptr(), bytes, false);
+
+			if (!this->_send_acquire(bytes, 1))
+				return send_ticket<derived_t>{};
+
+			return send_ticket<derived_t>(derive, derive.selfptr(), bytes, true);
+		}
+
+		inline bool _send_acquire(std::size_t bytes, std::size_t count)
+		{
+			if (send_budget* budget = this->send_budget_.get(); budget && bytes)
+			{
+				std::size_t used = budget->used.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+				if (used > budget->limit && !this->_send_over_budget(*budget, bytes))
+				{
+					budget->used.fetch_sub(bytes, std::memory_order_relaxed);
+					return false;
+				}
+			}
+
+			std::size_t queued_bytes = this->send_queued_bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+			std::size_t queued_count = this->send_queued_count_.fetch_add(count, std::memory_order_relaxed) + count;
+
+			if ((queued_bytes > this->send_high_bytes_ || queued_count > this->send_high_count_) &&
+				!this->send_paused_.load(std::memory_order_relaxed))
+			{
+				this->_send_pressure_update();
+			}
+
+			return true;
+		}
+
+		inline void _send_release(std::size_t bytes, std::size_t count)
+		{
+			if (send_budget* budget = this->send_budget_.get(); budget && bytes)
+			{
+				budget->used.fetch_sub(bytes, std::memory_order_relaxed);
+			}
+
+			std::size_t queued_bytes = this->send_queued_bytes_.fetch_sub(bytes, std::memory_order_relaxed) - bytes;
+			std::size_t queued_count = this->send_queued_count_.fetch_sub(count, std::memory_order_relaxed) - count;
+
+			if ((queued_bytes <= this->send_low_bytes_ && queued_count <= this->send_low_count_) &&
+				this->send_paused_.load(std::memory_order_relaxed))
+			{
+				this->_send_pressure_update();
+			}
+		}
+
+		/**
+		 * @brief apply the policy of the budget when a new send would exceed it.
+		 * @return whether the new send is accepted.
+		 */
+		inline bool _send_over_budget(send_budget& budget, std::size_t bytes)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			switch (budget.policy)
+			{
+			case send_policy::drop_oldest:
+			{
+				// drop the same bytes of the older sends of this session, the dropped sends are
+				// skipped when they reach the head of the event queue.
+				std::size_t queued = this->send_queued_bytes_.load(std::memory_order_relaxed);
+				std::size_t dropped = this->send_drop_bytes_.load(std::memory_order_relaxed);
+
+				while (dropped + bytes <= queued)
+				{
+					if (this->send_drop_bytes_.compare_exchange_weak(
+						dropped, dropped + bytes, std::memory_order_relaxed))
+						return true;
+				}
+
+				return false;
+			}
+			case send_policy::disconnect:
+			{
+				asio::post(derive.io_->context(), make_allocator(derive.wallocator(),
+				[&derive, p = derive.selfptr()]() mutable
+				{
+					// the session is being disconnected by the budget already.
+					if (derive.send_aborted_.load(std::memory_order_relaxed))
+						return;
+
+					// the disconnect event is queued after the sends which are blocked by the slow
+					// consumer, so drop the queued sends, and shutdown the sending side to fail the
+					// sending one, then the disconnect event can be executed.
+					derive.send_aborted_.store(true, std::memory_order_relaxed);
+
+					if constexpr (is_tcp_socket<typename derived_t::socket_type>::value)
+					{
+						error_code ec_ignore{};
+
+						// the peer doesn't read the data, don't wait for the graceful shutdown, close
+						// the connection with RST.
+						derive.socket().lowest_layer().set_option(asio::socket_base::linger(true, 0), ec_ignore);
+
+						derive.socket().shutdown(asio::socket_base::shutdown_send, ec_ignore);
+					}
+
+					derive._do_disconnect(asio::error::no_buffer_space, p);
+
+					// the events are executed in order, so this event is executed after the
+					// disconnect is completed, then the client can send again after reconnected.
+					derive.push_event([&derive, p = std::move(p)](event_queue_guard<derived_t> g) mutable
+					{
+						detail::ignore_unused(p, g);
+
+						derive.send_aborted_.store(false, std::memory_order_relaxed);
+					});
+				}));
+
+				return false;
+			}
+			default:
+				return false;
+			}
+		}
+
+		/**
+		 * @brief check whether the send should be dropped by the drop_oldest policy.
+		 */
+		inline bool _send_dropped(std::size_t bytes) noexcept
+		{
+			// the session is being disconnected by the budget, drop all the queued sends.
+			if (this->send_aborted_.load(std::memory_order_relaxed))
+				return true;
+
+			std::size_t dropped = this->send_drop_bytes_.load(std::memory_order_relaxed);
+
+			while (dropped > 0)
+			{
+				if (this->send_drop_bytes_.compare_exchange_weak(
+					dropped, dropped - (std::min)(dropped, bytes), std::memory_order_relaxed))
+					return true;
+			}
+
+			return false;
+		}
+
+		/**
+		 * @brief switch the paused state by the watermarks, the state may be changed by many
+		 * threads at the same time, so recheck it until it is consistent with the queued sends.
+		 */
+		inline void _send_pressure_update()
+		{
+			bool paused = this->send_paused_.load();
+
+			for (;;)
+			{
+				std::size_t queued_bytes = this->send_queued_bytes_.load();
+				std::size_t queued_count = this->send_queued_count_.load();
+
+				bool should_pause = paused ?
+					(queued_bytes > this->send_low_bytes_  || queued_count > this->send_low_count_ ) :
+					(queued_bytes > this->send_high_bytes_ || queued_count > this->send_high_count_);
+
+				if (should_pause == paused)
+					return;
+
+				if (this->send_paused_.compare_exchange_strong(paused, should_pause))
+				{
+					this->_send_pressure_notify();
+
+					paused = should_pause;
+				}
+			}
+		}
+
+		/**
+		 * @brief call the send pressure notification in the io_context thread, only the latest
+		 * state is notified, so the pause and resume are always called alternately.
+		 */
+		inline void _send_pressure_notify()
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			asio::post(derive.io_->context(), make_allocator(derive.wallocator(),
+			[&derive, p = derive.selfptr()]() mutable
+			{
+				bool paused = derive.send_paused_.load();
+
+				if (paused == derive.send_paused_notified_)
+					return;
+
+				derive.send_paused_notified_ = paused;
+
+				derive._fire_send_pressure(p, paused);
+			}));
+		}
+
+		inline void _send_ticket_to_batch(send_batch& batch, send_ticket<derived_t>& ticket) noexcept
+		{
+			if (ticket.counted())
+			{
+				batch.counted_bytes += ticket.bytes();
+				batch.counted_count += 1;
+
+				ticket.dismiss();
+			}
+		}
+
+		inline void _send_release_batch(send_batch& batch)
+		{
+			if (batch.counted_count)
+			{
+				this->_send_release(batch.counted_bytes, batch.counted_count);
+
+				batch.counted_bytes = 0;
+				batch.counted_count = 0;
+			}
+		}
+
+	protected:
+		/// Whether coalesce the queued sends into a single gather write.
+		bool                        send_coalesce_    = false;
+
+		/// The batch which is waiting in the event queue, new datas can be appended to it.
+		send_batch                * send_batch_       = nullptr;
+
+		/// The events_pushed_ of event queue when the send_batch_ was pushed into the event queue.
+		std::size_t                 send_batch_seq_   = 0;
+
+		/// Used to reuse the batch object and its memory.
+		std::unique_ptr<send_batch> send_batch_cache_;
+
+		/// The high and low watermarks of the queued sends.
+		std::size_t                 send_high_bytes_  = (std::numeric_limits<std::size_t>::max)();
+		std::size_t                 send_low_bytes_   = 0;
+		std::size_t                 send_high_count_  = (std::numeric_limits<std::size_t>::max)();
+		std::size_t                 send_low_count_   = 0;
+
+		/// The max bytes of the queued sends, it is shared by all the sessions of a server.
+		std::shared_ptr<send_budget> send_budget_;
+
+		/// Whether the watermark or the budget is setted, the sends are counted only if it is true.
+		bool                        send_pressure_    = false;
+
+		/// The paused state which was notified to the user last time, used in io_context thread only.
+		bool                        send_paused_notified_ = false;
+
+		std::atomic<bool>           send_paused_      { false };
+
+		std::atomic<std::size_t>    send_queued_bytes_{ 0 };
+		std::atomic<std::size_t>    send_queued_count_{ 0 };
+
+		/// The bytes of the queued sends which should be dropped by the drop_oldest policy.
+		std::atomic<std::size_t>    send_drop_bytes_  { 0 };
+
+		/// Whether all the queued sends should be dropped by the disconnect policy.
+		std::atomic<bool>           send_aborted_     { false };
 	};
 }
 
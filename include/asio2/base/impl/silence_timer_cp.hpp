@@ -81,6 +81,17 @@ namespace asio2::detail
 				// start the timer of check silence timeout
 				if (duration > std::chrono::duration<Rep, Period>::zero())
 				{
+					if (derive.io_->is_timing_wheel_enabled())
+					{
+						derive.io_->timing_wheel().add(this->silence_timer_node_, duration,
+						[&derive, this_ptr = std::move(this_ptr)](const error_code & ec) mutable
+						{
+							derive._handle_silence_timer(ec, std::move(this_ptr));
+						});
+
+						return;
+					}
+
 					if (this->silence_timer_ == nullptr)
 					{
 						this->silence_timer_ = std::make_unique<asio::steady_timer>(derive.io_->context());
@@ -139,12 +150,19 @@ namespace asio2::detail
 
 			derive.dispatch([this]() mutable
 			{
+				derived_t& derive = static_cast<derived_t&>(*this);
+
 			#if defined(_DEBUG) || defined(DEBUG)
 				this->is_stop_silence_timer_called_ = true;
 			#endif
 
 				this->silence_timer_canceled_.test_and_set();
 
+				if (this->silence_timer_node_.linked())
+				{
+					derive.io_->timing_wheel().cancel(this->silence_timer_node_);
+				}
+
 				if (this->silence_timer_)
 				{
 					detail::cancel_timer(*(this->silence_timer_));
@@ -156,6 +174,9 @@ namespace asio2::detail
 		/// timer for session silence time out
 		std::unique_ptr<asio::steady_timer>         silence_timer_;
 
+		/// used instead of the silence_timer_ when the timing wheel is enabled, see io_t::set_timing_wheel
+		timing_wheel::node                          silence_timer_node_;
+
 		/// Why use this flag, beacuase the ec param maybe zero when the timer callback is
 		/// called after the timer cancel function has called already.
 		std::atomic_flag                            silence_timer_canceled_;
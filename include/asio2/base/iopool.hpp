@@ -26,6 +26,8 @@
 #include <unordered_set>
 #include <map>
 #include <functional>
+#include <random>
+#include <string_view>
 
 #include <asio2/base/error.hpp>
 #include <asio2/base/define.hpp>
@@ -33,6 +35,19 @@
 
 #include <asio2/base/detail/util.hpp>
 #include <asio2/base/detail/shared_mutex.hpp>
+#include <asio2/base/detail/cpu_affinity.hpp>
+#include <asio2/base/detail/timing_wheel.hpp>
+#include <asio2/base/detail/object_pool.hpp>
+#include <asio2/base/detail/buffer_pool.hpp>
+#include <asio2/base/detail/metrics.hpp>
+
+/*
+ * the default name prefix of the iopool threads, the name of thread i is prefix + i.
+ * define it to "" to don't set the names of the threads.
+ */
+#ifndef ASIO2_IOPOOL_THREAD_NAME
+#define ASIO2_IOPOOL_THREAD_NAME "asio2-io-"
+#endif
 
 namespace asio2::detail
 {
@@ -98,6 +113,99 @@ namespace asio2::detail
 
 	template<class, class> class iopool_cp;
 
+	/**
+	 * @brief the policy used to choose the io_context for a new session or client.
+	 */
+	enum class io_placement : std::uint8_t
+	{
+		/// choose the io_context one by one, this is the default policy.
+		round_robin,
+
+		/// choose the io_context which has the least sessions and clients.
+		least_sessions,
+
+		/// choose the io_context which has the least pending operations, see io_t::pending()
+		least_pending,
+
+		/// choose two io_contexts randomly, and use the one which has less sessions and clients.
+		power_of_two,
+	};
+
+	/**
+	 * @brief the load of an io_context, used to choose the io_context and to see the imbalance.
+	 */
+	struct io_stats
+	{
+		/// the count of sessions and clients which are using this io_context.
+		std::size_t sessions = 0;
+
+		/// the count of pending operations of this io_context, see io_t::pending()
+		std::size_t pending  = 0;
+	};
+
+	/**
+	 * @brief the policy used to bind the threads of the iopool to the cpus.
+	 */
+	enum class cpu_affinity : std::uint8_t
+	{
+		/// don't bind the threads, the threads can run on any cpu, this is the default policy.
+		none,
+
+		/// bind each thread to one physical core, the hyper threads are not used, the threads
+		/// fill the cores of the first numa node first.
+		physical_core,
+
+		/// bind the threads to the cpus of a numa node, the threads are divided into the numa
+		/// nodes evenly, and each thread can run on any cpu of its numa node.
+		numa_node,
+	};
+
+	/**
+	 * @brief the backend which is used by the io_context to wait for the events, it is
+	 * choosed at compile time, see : ASIO2_ENABLE_IO_URING
+	 */
+	enum class io_backend : std::uint8_t
+	{
+		select,
+		epoll,
+		kqueue,
+		iocp,
+		io_uring,
+	};
+
+	/**
+	 * @brief get the backend which is used by the io_context.
+	 */
+	constexpr io_backend get_io_backend() noexcept
+	{
+	#if   defined(ASIO_HAS_IO_URING_AS_DEFAULT) || defined(BOOST_ASIO_HAS_IO_URING_AS_DEFAULT)
+		return io_backend::io_uring;
+	#elif defined(ASIO_HAS_IOCP) || defined(BOOST_ASIO_HAS_IOCP)
+		return io_backend::iocp;
+	#elif defined(ASIO_HAS_EPOLL) || defined(BOOST_ASIO_HAS_EPOLL)
+		return io_backend::epoll;
+	#elif defined(ASIO_HAS_KQUEUE) || defined(BOOST_ASIO_HAS_KQUEUE)
+		return io_backend::kqueue;
+	#else
+		return io_backend::select;
+	#endif
+	}
+
+	/**
+	 * @brief get the name of the backend which is used by the io_context.
+	 */
+	constexpr std::string_view get_io_backend_name() noexcept
+	{
+		switch (get_io_backend())
+		{
+		case io_backend::epoll   : return "epoll";
+		case io_backend::kqueue  : return "kqueue";
+		case io_backend::iocp    : return "iocp";
+		case io_backend::io_uring: return "io_uring";
+		default                  : return "select";
+		}
+	}
+
 	class io_t
 	{
 		friend class iopool;
@@ -111,13 +219,89 @@ namespace asio2::detail
 		{
 		}
 
-		inline asio::io_context                        & context() noexcept { return (*(this->context_))   ; }
-		inline std::atomic<std::size_t>                & pending() noexcept { return    this->pending_     ; }
-		inline std::unordered_set<asio::steady_timer*> & timers () noexcept { return    this->timers_      ; }
+		inline asio::io_context                        & context () noexcept { return (*(this->context_))   ; }
+		inline std::atomic<std::size_t>                & pending () noexcept { return    this->pending_     ; }
+		inline std::atomic<std::size_t>                & sessions() noexcept { return    this->sessions_    ; }
+		inline std::unordered_set<asio::steady_timer*> & timers  () noexcept { return    this->timers_      ; }
+
+		inline asio::io_context                        const& context () const noexcept { return (*(this->context_))   ; }
+		inline std::atomic<std::size_t>                const& pending () const noexcept { return    this->pending_     ; }
+		inline std::atomic<std::size_t>                const& sessions() const noexcept { return    this->sessions_    ; }
+		inline std::unordered_set<asio::steady_timer*> const& timers  () const noexcept { return    this->timers_      ; }
 
-		inline asio::io_context                        const& context() const noexcept { return (*(this->context_))   ; }
-		inline std::atomic<std::size_t>                const& pending() const noexcept { return    this->pending_     ; }
-		inline std::unordered_set<asio::steady_timer*> const& timers () const noexcept { return    this->timers_      ; }
+		/**
+		 * @brief get the load of this io_context.
+		 */
+		inline io_stats stats() const noexcept
+		{
+			return io_stats{ this->sessions_.load(std::memory_order_relaxed),
+				this->pending_.load(std::memory_order_relaxed) };
+		}
+
+	#if defined(ASIO2_ENABLE_METRICS)
+		/**
+		 * @brief get the metrics of this io_context, the counters are accumulated by all the tcp
+		 * sessions and clients which are using this io_context.
+		 */
+		inline io_metrics metrics() const noexcept
+		{
+			io_metrics m;
+
+			connection_metrics c = this->counters_.snapshot();
+
+			m.sessions        = this->sessions_.load(std::memory_order_relaxed);
+			m.pending         = this->pending_ .load(std::memory_order_relaxed);
+			m.events          = this->counters_.events.load(std::memory_order_relaxed);
+			m.bytes_recv      = c.bytes_recv;
+			m.bytes_sent      = c.bytes_sent;
+			m.messages_recv   = c.messages_recv;
+			m.messages_sent   = c.messages_sent;
+			m.handler_latency = this->counters_.handler_latency.snapshot();
+
+			return m;
+		}
+
+		/**
+		 * @brief get the counters of this io_context, they should only be written in the
+		 * io_context thread.
+		 */
+		inline detail::io_counters& counters() noexcept
+		{
+			return this->counters_;
+		}
+	#endif
+
+		/**
+		 * @brief enable or disable the timing wheel for the housekeeping timers of the sessions
+		 * and clients which are using this io_context, like the silence timer and the connect
+		 * timeout timer. the timers which are waiting already are not affected.
+		 */
+		inline void set_timing_wheel(bool enable) noexcept
+		{
+			this->timing_wheel_enabled_ = enable;
+		}
+
+		/**
+		 * @brief check whether the timing wheel is enabled.
+		 */
+		inline bool is_timing_wheel_enabled() const noexcept
+		{
+			return this->timing_wheel_enabled_;
+		}
+
+		/**
+		 * @brief get the timing wheel of this io_context, it will be created at the first call.
+		 * @note must be called in the io_context thread.
+		 */
+		inline detail::timing_wheel& timing_wheel()
+		{
+			if (!this->timing_wheel_)
+			{
+				this->timing_wheel_ = std::make_shared<detail::timing_wheel>(this->context(), this->timers_);
+			}
+
+			return *(this->timing_wheel_);
+		}
 
 		template<class Object>
 		inline void regobj(Object* p)
@@ -224,6 +408,129 @@ namespace asio2::detail
 			return (std::this_thread::get_id() == this->thread_id_);
 		}
 
+		/**
+		 * @brief get the numa node of the thread which the io_context is running in, it is
+		 * detected when the thread is started, the memory allocated in the io_context thread,
+		 * like the buffers of the sessions, comes from this numa node by the first touch policy.
+		 * @return -1 if it is unknown.
+		 */
+		inline int get_numa_node() const noexcept
+		{
+			return this->numa_node_;
+		}
+
+		/**
+		 * @brief set the busy poll mode of this io_context, the thread spins on poll() for at
+		 * most "spin" time after the last completed handler before blocking in run_one(), this
+		 * trades cpu for lower latency, so enable it on the hot path threads only.
+		 * @param spin - the spin budget, 0 means disable, the thread blocks in run() directly.
+		 * @param socket_busy_poll - if greater than 0, the SO_BUSY_POLL option is set with this
+		 *                           value on the tcp sockets of the sessions and clients which
+		 *                           are using this io_context, see detail::set_busy_poll
+		 * @note must be called before the iopool is started, it takes effect at the next start.
+		 */
+		inline void set_busy_poll(std::chrono::microseconds spin,
+			std::chrono::microseconds socket_busy_poll = std::chrono::microseconds(0)) noexcept
+		{
+			this->busy_poll_spin_ = spin.count();
+			this->socket_busy_poll_ = socket_busy_poll.count();
+		}
+
+		/**
+		 * @brief get the spin budget of the busy poll mode, 0 means disabled.
+		 */
+		inline std::chrono::microseconds get_busy_poll() const noexcept
+		{
+			return std::chrono::microseconds(this->busy_poll_spin_.load(std::memory_order_relaxed));
+		}
+
+		/**
+		 * @brief get the SO_BUSY_POLL value for the sockets which are using this io_context.
+		 */
+		inline std::chrono::microseconds get_socket_busy_poll() const noexcept
+		{
+			return std::chrono::microseconds(this->socket_busy_poll_.load(std::memory_order_relaxed));
+		}
+
+		/**
+		 * @brief get the pool of the session memory blocks of this io_context, it will be created
+		 * at the first call. the sessions created with this io_context return their memory here
+		 * when they are destroyed, and the next session reuses it, see server::set_session_pool
+		 */
+		inline std::shared_ptr<detail::object_pool> session_pool()
+		{
+			return this->_get_pool(this->session_pool_, ASIO2_OBJECT_POOL_MAX_FREE,
+				(std::numeric_limits<std::size_t>::max)());
+		}
+
+		/**
+		 * @brief get the pool of the receive buffers of this io_context, it will be created at
+		 * the first call. the idle sessions return their receive buffer here, and borrow a buffer
+		 * when the socket becomes readable, see tcp_server::set_buffer_pool
+		 */
+		inline std::shared_ptr<detail::object_pool> buffer_pool()
+		{
+			return this->_get_pool(this->buffer_pool_, ASIO2_OBJECT_POOL_MAX_FREE, ASIO2_BUFFER_POOL_MAX_BYTES);
+		}
+
+		/**
+		 * @brief run the io_context until it is stopped, with the busy poll mode if enabled.
+		 * @return the number of handlers that were executed.
+		 */
+		inline std::size_t run()
+		{
+			asio::io_context& ioc = this->context();
+
+			std::chrono::microseconds spin = this->get_busy_poll();
+
+			if (spin.count() <= 0)
+				return ioc.run();
+
+			std::size_t count = 0;
+
+			auto deadline = std::chrono::steady_clock::now() + spin;
+
+			// when the io_context runs out of work or is stopped, the poll() and run_one() return
+			// 0 and the stopped() becomes true.
+			while (!ioc.stopped())
+			{
+				if (std::size_t n = ioc.poll(); n > 0)
+				{
+					count += n;
+					deadline = std::chrono::steady_clock::now() + spin;
+					continue;
+				}
+
+				if (std::chrono::steady_clock::now() < deadline)
+					continue;
+
+				count += ioc.run_one();
+
+				deadline = std::chrono::steady_clock::now() + spin;
+			}
+
+			return count;
+		}
+
+	protected:
+		inline std::shared_ptr<detail::object_pool> _get_pool(
+			std::shared_ptr<detail::object_pool>& p, std::size_t max_free, std::size_t max_bytes)
+		{
+			std::shared_ptr<detail::object_pool> pool = std::atomic_load(&p);
+
+			if (!pool)
+			{
+				std::shared_ptr<detail::object_pool> expected;
+
+				pool = std::make_shared<detail::object_pool>(max_free, max_bytes);
+
+				if (!std::atomic_compare_exchange_strong(&p, &expected, pool))
+					pool = std::move(expected);
+			}
+
+			return pool;
+		}
+
 	protected:
 		// 
 		std::shared_ptr<asio::io_context>        context_;
@@ -242,6 +549,10 @@ namespace asio2::detail
 		// see : send_cp.hpp "# issue x:"
 		std::atomic<std::size_t>                 pending_{};
 
+		// the count of sessions and clients which are using this io_context, it is used
+		// to choose the io_context for the new sessions, see io_placement.
+		std::atomic<std::size_t>                 sessions_{};
+
 		// Use this variable to save the timers that have not been closed properly.
 		// If we don't do this, the following problem will occurs:
 		// user call client.stop, when the code is run to before the iopool's 
@@ -270,6 +581,34 @@ namespace asio2::detail
 
 		// the thread id of the current io_context running in.
 		std::thread::id                              thread_id_{};
+
+		// the numa node of the thread which the io_context is running in.
+		std::atomic<int>                             numa_node_{ -1 };
+
+		// the spin budget and the SO_BUSY_POLL value in microseconds of the busy poll mode.
+		std::atomic<std::int64_t>                    busy_poll_spin_{ 0 };
+		std::atomic<std::int64_t>                    socket_busy_poll_{ 0 };
+
+		// the memory blocks of the destroyed sessions, the sessions hold it by the allocator.
+		std::shared_ptr<detail::object_pool>         session_pool_;
+
+		// the receive buffers of the idle sessions, the buffers hold it by the allocator.
+		std::shared_ptr<detail::object_pool>         buffer_pool_;
+
+		// the timing wheel is used instead of a asio::steady_timer for each session when enabled.
+		// it must be declared after the context_ and the timers_.
+		std::shared_ptr<detail::timing_wheel>        timing_wheel_;
+
+	#if defined(ASIO2_ENABLE_TIMING_WHEEL)
+		std::atomic<bool>                            timing_wheel_enabled_{ true };
+	#else
+		std::atomic<bool>                            timing_wheel_enabled_{ false };
+	#endif
+
+	#if defined(ASIO2_ENABLE_METRICS)
+		// the metrics counters, they are only written in the io_context thread.
+		detail::io_counters                          counters_;
+	#endif
 	};
 
 	//-----------------------------------------------------------------------------------
@@ -290,6 +629,72 @@ namespace asio2::detail
 
 	//-----------------------------------------------------------------------------------
 
+	/**
+	 * @brief choose an io_t index in the range [first, iots.size()) with the placement policy.
+	 * @param next - the round robin counter.
+	 */
+	inline std::size_t select_io_index(
+		const std::vector<std::shared_ptr<io_t>>& iots, std::size_t first,
+		io_placement placement, std::size_t& next) noexcept
+	{
+		ASIO2_ASSERT(first < iots.size());
+
+		std::size_t n = iots.size() - first;
+
+		if (n <= std::size_t(1))
+			return first;
+
+		switch (placement)
+		{
+		case io_placement::least_sessions:
+		case io_placement::least_pending:
+		{
+			std::size_t index = first, num = (std::numeric_limits<std::size_t>::max)();
+
+			// start from the round robin position, so the io_contexts which have the same
+			// load will be used one by one.
+			std::size_t offset = (++next);
+
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				std::size_t k = first + (offset + i) % n;
+
+				std::size_t load = (placement == io_placement::least_sessions ?
+					iots[k]->sessions().load(std::memory_order_relaxed) :
+					iots[k]->pending ().load(std::memory_order_relaxed));
+
+				if (load < num)
+				{
+					num = load;
+					index = k;
+
+					if (load == 0)
+						break;
+				}
+			}
+
+			return index;
+		}
+		case io_placement::power_of_two:
+		{
+			thread_local std::minstd_rand engine{ std::random_device{}() };
+
+			std::size_t a = first + std::size_t(engine()) % n;
+			std::size_t b = first + std::size_t(engine()) % (n - 1);
+
+			if (b >= a)
+				++b;
+
+			return (iots[a]->sessions().load(std::memory_order_relaxed) <=
+					iots[b]->sessions().load(std::memory_order_relaxed)) ? a : b;
+		}
+		default:
+			return first + (++next) % n;
+		}
+	}
+
+	//-----------------------------------------------------------------------------------
+
 	/**
 	 * io_context pool
 	 */
@@ -467,6 +872,10 @@ namespace asio2::detail
 
 			std::vector<std::promise<void>> promises(this->iots_.size());
 
+			std::vector<cpu_info> topology = get_cpu_topology();
+
+			std::vector<std::vector<int>> cpusets = this->make_cpusets(topology);
+
 			// Create a pool of threads to run all of the io_contexts. 
 			for (std::size_t i = 0; i < this->iots_.size(); ++i)
 			{
@@ -488,11 +897,26 @@ namespace asio2::detail
 
 				this->guards_.emplace_back(iot->context().get_executor());
 
+				std::vector<int>& cpus = cpusets[i];
+
+				std::string name = this->thread_name_.empty() ? std::string{} :
+					this->thread_name_ + std::to_string(i);
+
 				// start work thread
-				this->threads_.emplace_back([this, &iot, &promise]() mutable
+				this->threads_.emplace_back([this, &iot, &promise, &cpus, &topology, name = std::move(name)]()
+				mutable
 				{
 					detail::ignore_unused(this);
 
+					if (!cpus.empty() && !detail::set_current_thread_affinity(cpus))
+					{
+						ASIO2_LOG_ERROR("set the cpu affinity of the iopool thread failed: {}", name);
+					}
+
+					detail::set_current_thread_name(name);
+
+					iot->numa_node_ = detail::get_current_numa_node(topology);
+
 					iot->thread_id_ = std::this_thread::get_id();
 
 					// after the thread id is seted already, we set the promise
@@ -509,7 +933,7 @@ namespace asio2::detail
 					try
 					{
 				#endif
-						iot->context().run();
+						iot->run();
 				#if !defined(ASIO_NO_EXCEPTIONS) && !defined(BOOST_ASIO_NO_EXCEPTIONS)
 					}
 					catch (system_error const& e)
@@ -666,6 +1090,156 @@ namespace asio2::detail
 			return this->iots_[this->next_impl(index)];
 		}
 
+		/**
+		 * @brief set the policy used to bind the threads to the cpus, see cpu_affinity.
+		 * @note must be called before start, it takes effect at the next start.
+		 */
+		inline iopool& set_cpu_affinity(cpu_affinity policy)
+		{
+			asio2::unique_locker guard(this->mutex_);
+
+			this->cpu_affinity_ = policy;
+			this->cpusets_.clear();
+
+			return (*this);
+		}
+
+		/**
+		 * @brief bind the threads to the specified cpus, the thread i is bound to the cpus of
+		 * cpusets[i % cpusets.size()], eg: {{0,1},{2,3}} binds thread 0 to cpu 0 and cpu 1,
+		 * binds thread 1 to cpu 2 and cpu 3, binds thread 2 to cpu 0 and cpu 1, and so on.
+		 * @note must be called before start, it takes effect at the next start.
+		 */
+		inline iopool& set_cpu_affinity(std::vector<std::vector<int>> cpusets)
+		{
+			asio2::unique_locker guard(this->mutex_);
+
+			this->cpu_affinity_ = cpu_affinity::none;
+			this->cpusets_ = std::move(cpusets);
+
+			return (*this);
+		}
+
+		/**
+		 * @brief get the policy used to bind the threads to the cpus.
+		 */
+		inline cpu_affinity get_cpu_affinity() const noexcept
+		{
+			asio2::shared_locker guard(this->mutex_);
+
+			return this->cpu_affinity_;
+		}
+
+		/**
+		 * @brief set the name prefix of the threads, the name of thread i is prefix + i, the
+		 * names are displayed in the debugger, top and perf. empty prefix means don't set the
+		 * name. on linux the name is truncated to 15 characters.
+		 * @note must be called before start, it takes effect at the next start.
+		 */
+		inline iopool& set_thread_name(std::string prefix)
+		{
+			asio2::unique_locker guard(this->mutex_);
+
+			this->thread_name_ = std::move(prefix);
+
+			return (*this);
+		}
+
+		/**
+		 * @brief get the name prefix of the threads.
+		 */
+		inline std::string get_thread_name() const
+		{
+			asio2::shared_locker guard(this->mutex_);
+
+			return this->thread_name_;
+		}
+
+		/**
+		 * @brief enable or disable the timing wheel of all the io_contexts, see io_t::set_timing_wheel
+		 */
+		inline void set_timing_wheel(bool enable) noexcept
+		{
+			asio2::shared_locker guard(this->mutex_);
+
+			for (std::shared_ptr<io_t>& iot : this->iots_)
+			{
+				iot->set_timing_wheel(enable);
+			}
+		}
+
+		/**
+		 * @brief set the busy poll mode of the io_context at the index, see io_t::set_busy_poll
+		 * @note must be called before start, it takes effect at the next start.
+		 */
+		inline iopool& set_busy_poll(std::size_t index, std::chrono::microseconds spin,
+			std::chrono::microseconds socket_busy_poll = std::chrono::microseconds(0)) noexcept
+		{
+			asio2::shared_locker guard(this->mutex_);
+
+			ASIO2_ASSERT(index < this->iots_.size());
+
+			if (index < this->iots_.size())
+			{
+				this->iots_[index]->set_busy_poll(spin, socket_busy_poll);
+			}
+
+			return (*this);
+		}
+
+		/**
+		 * @brief get an io_t to use with the placement policy, eg: create a client with the
+		 * io_t which has the least sessions and clients.
+		 */
+		inline std::shared_ptr<io_t> get(io_placement placement) noexcept
+		{
+			asio2::shared_locker guard(this->mutex_);
+
+			ASIO2_ASSERT(!this->iots_.empty());
+
+			return this->iots_[select_io_index(this->iots_, 0, placement, this->next_)];
+		}
+
+		/**
+		 * @brief get the load of each io_context, it can be used to see the imbalance.
+		 */
+		inline std::vector<io_stats> stats() const
+		{
+			asio2::shared_locker guard(this->mutex_);
+
+			std::vector<io_stats> v;
+
+			v.reserve(this->iots_.size());
+
+			for (const std::shared_ptr<io_t>& iot : this->iots_)
+			{
+				v.emplace_back(iot->stats());
+			}
+
+			return v;
+		}
+
+	#if defined(ASIO2_ENABLE_METRICS)
+		/**
+		 * @brief get the metrics of each io_context.
+		 */
+		inline std::vector<io_metrics> metrics() const
+		{
+			asio2::shared_locker guard(this->mutex_);
+
+			std::vector<io_metrics> v;
+
+			v.reserve(this->iots_.size());
+
+			for (const std::shared_ptr<io_t>& iot : this->iots_)
+			{
+				v.emplace_back(iot->metrics());
+			}
+
+			return v;
+		}
+	#endif
+
 		/**
 		 * @brief get an io_context to use
 		 */
@@ -1089,6 +1663,48 @@ namespace asio2::detail
 		}
 
 	protected:
+		/**
+		 * @brief calc the cpus of each thread with the cpu affinity policy or the cpusets.
+		 * the element is empty if the thread don't need to be bound.
+		 */
+		inline std::vector<std::vector<int>> make_cpusets(const std::vector<cpu_info>& topology)
+			ASIO2_NO_THREAD_SAFETY_ANALYSIS
+		{
+			std::size_t count = this->iots_.size();
+
+			std::vector<std::vector<int>> v(count);
+
+			if (!this->cpusets_.empty())
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					v[i] = this->cpusets_[i % this->cpusets_.size()];
+				}
+			}
+			else if (this->cpu_affinity_ == cpu_affinity::physical_core)
+			{
+				std::vector<int> cores = get_physical_core_cpus(topology);
+
+				for (std::size_t i = 0; i < count && !cores.empty(); ++i)
+				{
+					v[i].emplace_back(cores[i % cores.size()]);
+				}
+			}
+			else if (this->cpu_affinity_ == cpu_affinity::numa_node)
+			{
+				std::vector<std::vector<int>> nodes = get_numa_node_cpus(topology);
+
+				// the adjacent threads are in the same node, eg: 4 threads and 2 nodes,
+				// the thread 0,1 is in node 0, the thread 2,3 is in node 1.
+				for (std::size_t i = 0; i < count && !nodes.empty(); ++i)
+				{
+					v[i] = nodes[i * nodes.size() / count];
+				}
+			}
+
+			return v;
+		}
+
 		inline bool running_in_threads_impl() const noexcept ASIO2_NO_THREAD_SAFETY_ANALYSIS
 		{
 			std::thread::id curr_tid = std::this_thread::get_id();
@@ -1145,6 +1761,15 @@ namespace asio2::detail
 		// exit until they are explicitly stopped. 
 		std::vector<io_context_work_guard>                           guards_ ASIO2_GUARDED_BY(mutex_);
 
+		/// The policy used to bind the threads to the cpus.
+		cpu_affinity                                                 cpu_affinity_ ASIO2_GUARDED_BY(mutex_) = cpu_affinity::none;
+
+		/// The cpus of each thread which are specified by the user.
+		std::vector<std::vector<int>>                                cpusets_ ASIO2_GUARDED_BY(mutex_);
+
+		/// The name prefix of the threads.
+		std::string                                                  thread_name_ ASIO2_GUARDED_BY(mutex_) = ASIO2_IOPOOL_THREAD_NAME;
+
 		// for debug, to see the derived object details.
 	#if defined(_DEBUG) || defined(DEBUG)
 		std::function<void()>                                        derive_pointer_;
@@ -1598,6 +2223,140 @@ namespace asio2::detail
 		 */
 		inline iopool_base const& iopool() const noexcept { return (*(this->iopool_)); }
 
+		/**
+		 * @brief get the load of each io_context, it can be used to see the imbalance.
+		 */
+		inline std::vector<io_stats> get_io_stats() const
+		{
+			std::vector<io_stats> v;
+
+			v.reserve(this->iots_.size());
+
+			for (const std::shared_ptr<io_t>& iot : this->iots_)
+			{
+				v.emplace_back(iot->stats());
+			}
+
+			return v;
+		}
+
+	#if defined(ASIO2_ENABLE_METRICS)
+		/**
+		 * @brief get the metrics of each io_context, see io_t::metrics
+		 */
+		inline std::vector<io_metrics> get_io_metrics() const
+		{
+			std::vector<io_metrics> v;
+
+			v.reserve(this->iots_.size());
+
+			for (const std::shared_ptr<io_t>& iot : this->iots_)
+			{
+				v.emplace_back(iot->metrics());
+			}
+
+			return v;
+		}
+	#endif
+
+		/**
+		 * @brief enable or disable the timing wheel for the silence timer and the connect timeout
+		 * timer, a timing wheel of each io_context is used instead of a asio::steady_timer for
+		 * each session, it reduces the memory and the cost of the timers when there are a large
+		 * number of idle sessions. the precision of the timers is ASIO2_TIMING_WHEEL_TICK.
+		 * @note must be called before start.
+		 */
+		inline derived_t& set_timing_wheel(bool enable) noexcept
+		{
+			for (std::shared_ptr<io_t>& iot : this->iots_)
+			{
+				iot->set_timing_wheel(enable);
+			}
+
+			return static_cast<derived_t&>(*this);
+		}
+
+		/**
+		 * @brief check whether the timing wheel is enabled.
+		 */
+		inline bool is_timing_wheel() const noexcept
+		{
+			return (!this->iots_.empty() && this->iots_.front()->is_timing_wheel_enabled());
+		}
+
+		/**
+		 * @brief set the busy poll mode of the io_context thread at the index, so only the hot
+		 * path threads spin, see io_t::set_busy_poll
+		 * eg: server.set_busy_poll(0, std::chrono::microseconds(50));
+		 * @note must be called before start, the spin doesn't work when the iopool is passed in
+		 * by the user, because the io_contexts are run by the user.
+		 */
+		inline derived_t& set_busy_poll(std::size_t index, std::chrono::microseconds spin,
+			std::chrono::microseconds socket_busy_poll = std::chrono::microseconds(0)) noexcept
+		{
+			ASIO2_ASSERT(index < this->iots_.size());
+
+			if (index < this->iots_.size())
+			{
+				this->iots_[index]->set_busy_poll(spin, socket_busy_poll);
+			}
+
+			return static_cast<derived_t&>(*this);
+		}
+
+		/**
+		 * @brief get the spin budget of the busy poll mode of the io_context at the index.
+		 */
+		inline std::chrono::microseconds get_busy_poll(std::size_t index) const noexcept
+		{
+			return (index < this->iots_.size() ? this->iots_[index]->get_busy_poll() : std::chrono::microseconds(0));
+		}
+
+		/**
+		 * @brief set the policy used to bind the iopool threads to the cpus, see cpu_affinity.
+		 * @note must be called before start, it doesn't work when the iopool is passed in by
+		 * the user, set the affinity to the user's iopool directly in this case.
+		 */
+		inline derived_t& set_cpu_affinity(cpu_affinity policy)
+		{
+			if (default_iopool* p = dynamic_cast<default_iopool*>(this->iopool_.get()); p)
+			{
+				p->impl_.set_cpu_affinity(policy);
+			}
+
+			return static_cast<derived_t&>(*this);
+		}
+
+		/**
+		 * @brief bind the iopool threads to the specified cpus, see iopool::set_cpu_affinity
+		 * @note must be called before start, it doesn't work when the iopool is passed in by
+		 * the user, set the affinity to the user's iopool directly in this case.
+		 */
+		inline derived_t& set_cpu_affinity(std::vector<std::vector<int>> cpusets)
+		{
+			if (default_iopool* p = dynamic_cast<default_iopool*>(this->iopool_.get()); p)
+			{
+				p->impl_.set_cpu_affinity(std::move(cpusets));
+			}
+
+			return static_cast<derived_t&>(*this);
+		}
+
+		/**
+		 * @brief set the name prefix of the iopool threads, see iopool::set_thread_name
+		 * @note must be called before start, it doesn't work when the iopool is passed in by
+		 * the user, set the name to the user's iopool directly in this case.
+		 */
+		inline derived_t& set_thread_name(std::string prefix)
+		{
+			if (default_iopool* p = dynamic_cast<default_iopool*>(this->iopool_.get()); p)
+			{
+				p->impl_.set_thread_name(std::move(prefix));
+			}
+
+			return static_cast<derived_t&>(*this);
+		}
+
 	protected:
 		inline std::shared_ptr<io_t> _get_io(std::size_t index = static_cast<std::size_t>(-1)) noexcept
 		{
@@ -1607,6 +2366,15 @@ namespace asio2::detail
 			return this->iots_[n];
 		}
 
+		/**
+		 * @brief choose an io_t in the range [first, size) with the placement policy.
+		 */
+		inline std::shared_ptr<io_t> _select_io(io_placement placement, std::size_t first = 0) noexcept
+		{
+			ASIO2_ASSERT(!iots_.empty());
+			return this->iots_[select_io_index(this->iots_, first, placement, this->next_)];
+		}
+
 		inline bool is_iopool_started() const noexcept
 		{
 			return this->iopool_->started();
@@ -1779,8 +2547,15 @@ namespace asio2::detail
 
 namespace asio2
 {
-	using io_t   = detail::io_t;
-	using iopool = detail::iopool;
+	using io_t         = detail::io_t;
+	using iopool       = detail::iopool;
+	using io_placement = detail::io_placement;
+	using io_stats     = detail::io_stats;
+	using io_backend   = detail::io_backend;
+	using cpu_affinity = detail::cpu_affinity;
+
+	using detail::get_io_backend;
+	using detail::get_io_backend_name;
 }
 
 #endif // !__ASIO2_IOPOOL_HPP__
@@ -28,6 +28,7 @@
 #include <asio2/base/log.hpp>
 
 #include <asio2/base/detail/util.hpp>
+#include <asio2/base/detail/tracer.hpp>
 
 namespace asio2::detail
 {
@@ -43,6 +44,7 @@ namespace asio2::detail
 		init,
 		start,
 		stop,
+		send_pressure,
 		max
 	};
 
@@ -62,12 +64,33 @@ namespace asio2::detail
 		case event_type::init       : return "init";
 		case event_type::start      : return "start";
 		case event_type::stop       : return "stop";
+		case event_type::send_pressure : return "send_pressure";
 		case event_type::max		: return "max";
 		default				        : return "none";
 		}
 		return "none";
 	}
 
+#if defined(ASIO2_ENABLE_TRACE)
+	/**
+	 * @brief get the trace site of the user callback function, eg : bind_recv
+	 */
+	inline const trace_site& get_trace_site(event_type e) noexcept
+	{
+		static const std::array<trace_site, detail::to_underlying(event_type::max) + 1> sites = []()
+		{
+			std::array<trace_site, detail::to_underlying(event_type::max) + 1> v{};
+			for (std::size_t i = 0; i < v.size(); ++i)
+			{
+				v[i] = trace_site{ "bind_", detail::to_string(static_cast<event_type>(i)), nullptr };
+			}
+			return v;
+		}();
+
+		return sites[detail::to_underlying(e)];
+	}
+#endif
+
 	class observer_base
 	{
 	public:
@@ -225,6 +248,10 @@ namespace asio2::detail
 				this->observers_[detail::to_underlying(e)].get());
 			if (observer_ptr)
 			{
+			#if defined(ASIO2_ENABLE_TRACE)
+				trace_scope scope(detail::get_trace_site(e));
+			#endif
+
 				// You can define ASIO_NO_EXCEPTIONS in the /asio2/config.hpp to disable the
 				// exception. so when the exception occurs, you can check the stack trace.
 			#if !defined(ASIO_NO_EXCEPTIONS) && !defined(BOOST_ASIO_NO_EXCEPTIONS)
@@ -23,6 +23,7 @@
 #include <atomic>
 #include <string>
 #include <string_view>
+#include <optional>
 
 #include <asio2/base/iopool.hpp>
 #include <asio2/base/log.hpp>
@@ -34,6 +35,7 @@
 #include <asio2/base/detail/allocator.hpp>
 #include <asio2/base/detail/util.hpp>
 #include <asio2/base/detail/buffer_wrap.hpp>
+#include <asio2/base/detail/shared_buffer.hpp>
 #include <asio2/base/detail/ecs.hpp>
 
 #include <asio2/base/impl/io_context_cp.hpp>
@@ -191,6 +193,47 @@ namespace asio2::detail
 			return reinterpret_cast<key_type>(this);
 		}
 
+		/**
+		 * @brief set the policy used to choose the io_context for the new sessions.
+		 * the default policy is round robin, see io_placement.
+		 * the load of each io_context can be got by get_io_stats()
+		 */
+		inline derived_t& set_io_placement(io_placement placement) noexcept
+		{
+			this->io_placement_ = placement;
+			return (this->derived());
+		}
+
+		/**
+		 * @brief get the policy used to choose the io_context for the new sessions.
+		 */
+		inline io_placement get_io_placement() const noexcept
+		{
+			return this->io_placement_;
+		}
+
+		/**
+		 * @brief enable or disable the session pool, when enabled, the memory of the destroyed
+		 * sessions is cached by the io_context which the session was using, and reused by the
+		 * next session of the io_context, it reduces the cost of the high connection churn.
+		 * the session is always constructed and destroyed normally, so the selfptr and the
+		 * life id are the same as without the pool.
+		 * @note must be called before start.
+		 */
+		inline derived_t& set_session_pool(bool enabled) noexcept
+		{
+			this->session_pool_ = enabled;
+			return (this->derived());
+		}
+
+		/**
+		 * @brief check whether the session pool is enabled.
+		 */
+		inline bool is_session_pool() const noexcept
+		{
+			return this->session_pool_;
+		}
+
 		/**
 		 * @brief Asynchronous send data for each session
 		 * supporting multi data formats,see asio::buffer(...) in /asio/buffer.hpp
@@ -200,14 +243,26 @@ namespace asio2::detail
 		 * std::array<PodType, N> : std::array<int,10> m; async_send(m);
 		 * std::vector<PodType, Allocator> : std::vector<float> m; async_send(m);
 		 * std::basic_string<Elem, Traits, Allocator> : std::string m; async_send(m);
+		 * The data is copied and passed to the data_filter_before_send only once, then all the
+		 * sessions will send the same asio2::shared_buffer, see shared_buffer.hpp
 		 */
 		template<class T>
 		inline derived_t & async_send(const T& data)
 		{
-			this->sessions_.quick_for_each([&data](std::shared_ptr<session_t>& session_ptr) mutable
+			if constexpr (is_shareable_data<T>::value)
 			{
-				session_ptr->async_send(data);
-			});
+				this->_async_send_shared([&data](std::shared_ptr<session_t>& session_ptr)
+				{
+					return session_ptr->_make_shared_buffer(data);
+				});
+			}
+			else
+			{
+				this->sessions_.quick_for_each([&data](std::shared_ptr<session_t>& session_ptr) mutable
+				{
+					session_ptr->async_send(data);
+				});
+			}
 			return this->derived();
 		}
 
@@ -233,14 +288,41 @@ namespace asio2::detail
 		{
 			if (s)
 			{
-				this->sessions_.quick_for_each([s, count](std::shared_ptr<session_t>& session_ptr) mutable
+				this->_async_send_shared([s, count](std::shared_ptr<session_t>& session_ptr)
 				{
-					session_ptr->async_send(s, count);
+					return session_ptr->_make_shared_buffer(s, count);
 				});
 			}
 			return this->derived();
 		}
 
+	protected:
+		template<class, class = void>
+		struct is_shareable_data : std::false_type {};
+
+		template<class T>
+		struct is_shareable_data<T, std::void_t<decltype(
+			asio::buffer(std::declval<const T&>()))>> : std::true_type {};
+
+		/**
+		 * @brief make the shared buffer with the first session, and send it to each session.
+		 */
+		template<class MakeFun>
+		inline void _async_send_shared(MakeFun&& make)
+		{
+			std::optional<shared_buffer> buffer;
+
+			this->sessions_.quick_for_each([&make, &buffer](std::shared_ptr<session_t>& session_ptr) mutable
+			{
+				// the data_filter_before_send is a member function of the session, so the shared
+				// buffer can't be made until we got a session.
+				if (!buffer.has_value())
+					buffer.emplace(make(session_ptr));
+
+				session_ptr->async_send(*buffer);
+			});
+		}
+
 	public:
 		/**
 		 * @brief get the acceptor reference, derived classes must override this function
@@ -299,6 +381,39 @@ namespace asio2::detail
 		 */
 		inline std::size_t get_session_count() const noexcept { return this->sessions_.size(); }
 
+	#if defined(ASIO2_ENABLE_METRICS)
+		/**
+		 * @brief get the metrics of the sessions and each io_context of this server, the
+		 * io_context is shared by the other servers and clients which use the same iopool.
+		 * use asio2::to_json(server.get_metrics()) to export it.
+		 */
+		inline server_metrics get_metrics() const
+		{
+			server_metrics m;
+
+			m.sessions = this->sessions_.metrics();
+			m.ios      = this->get_io_metrics();
+
+			return m;
+		}
+
+		/**
+		 * @brief get the sum of the handler allocator counters of all the sessions, the counters
+		 * of the disconnected sessions are not included.
+		 */
+		inline allocator_metrics get_allocator_metrics()
+		{
+			allocator_metrics m;
+
+			this->sessions_.for_each([&m](std::shared_ptr<session_t>& session_ptr)
+			{
+				m += session_ptr->get_allocator_metrics();
+			});
+
+			return m;
+		}
+	#endif
+
 		/**
 		 * @brief Applies the given function object fn for each session.
 		 * @param fn - The handler to be called for each session.
@@ -348,6 +463,22 @@ namespace asio2::detail
 		inline listener_t               & listener() noexcept { return this->listener_; }
 		inline std::atomic<state_t>     & state   () noexcept { return this->state_;    }
 
+		/**
+		 * @brief create a session with the memory of the session pool of the io_context if the
+		 * session pool is enabled.
+		 */
+		template<typename... Args>
+		inline std::shared_ptr<session_t> _new_session(const std::shared_ptr<io_t>& iot, Args&&... args)
+		{
+			if (this->session_pool_)
+			{
+				return std::allocate_shared<session_t>(detail::object_pool_allocator<session_t>(
+					iot->session_pool()), std::forward<Args>(args)...);
+			}
+
+			return std::make_shared<session_t>(std::forward<Args>(args)...);
+		}
+
 	protected:
 		// The memory to use for handler-based custom memory allocation. used for acceptor.
 		handler_memory<std::true_type , assizer<args_type>>     rallocator_;
@@ -370,6 +501,12 @@ namespace asio2::detail
 		/// the pointer of ecs_t
 		std::shared_ptr<ecs_base>                   ecs_;
 
+		/// the policy used to choose the io_context for the new sessions.
+		io_placement                                io_placement_ = io_placement::round_robin;
+
+		/// whether the memory of the sessions is reused by the session pool of the io_context.
+		bool                                        session_pool_ = false;
+
 	#if defined(_DEBUG) || defined(DEBUG)
 		std::atomic<int>                            post_send_counter_ = 0;
 		std::atomic<int>                            post_recv_counter_ = 0;
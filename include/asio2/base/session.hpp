@@ -53,6 +53,7 @@
 #include <asio2/base/impl/event_queue_cp.hpp>
 #include <asio2/base/impl/condition_event_cp.hpp>
 #include <asio2/base/impl/send_cp.hpp>
+#include <asio2/base/impl/metrics_cp.hpp>
 
 #include <asio2/component/rdc/rdc_call_cp.hpp>
 
@@ -90,6 +91,7 @@ namespace asio2::detail
 		, public silence_timer_cp      <derived_t, args_t>
 		, public connect_timeout_cp    <derived_t, args_t>
 		, public send_cp               <derived_t, args_t>
+		, public metrics_cp            <derived_t, args_t>
 		, public post_cp               <derived_t, args_t>
 		, public condition_event_cp    <derived_t, args_t>
 		, public rdc_call_cp           <derived_t, args_t>
@@ -137,6 +139,7 @@ namespace asio2::detail
 			, silence_timer_cp    <derived_t, args_t>()
 			, connect_timeout_cp  <derived_t, args_t>()
 			, send_cp             <derived_t, args_t>()
+			, metrics_cp          <derived_t, args_t>()
 			, post_cp             <derived_t, args_t>()
 			, condition_event_cp  <derived_t, args_t>()
 			, rdc_call_cp         <derived_t, args_t>()
@@ -144,6 +147,7 @@ namespace asio2::detail
 			, listener_(listener)
 			, buffer_  (init_buf_size, max_buf_size)
 		{
+			this->io_->sessions()++;
 		}
 
 		/**
@@ -151,6 +155,9 @@ namespace asio2::detail
 		 */
 		~session_impl_t()
 		{
+			// the io_ maybe reseted by destroy()
+			if (this->io_)
+				this->io_->sessions()--;
 		}
 
 	protected:
@@ -232,6 +239,10 @@ namespace asio2::detail
 			derived_t& derive = this->derived();
 
 			derive.socket_.reset();
+
+			if (derive.io_)
+				derive.io_->sessions()--;
+
 			derive.io_.reset();
 		}
 
@@ -285,6 +296,14 @@ namespace asio2::detail
 		inline constexpr bool             life_id () noexcept { return true; }
 		inline constexpr void       reset_life_id () noexcept { }
 
+		inline void _fire_send_pressure(std::shared_ptr<derived_t>& this_ptr, bool paused)
+		{
+			// the _fire_send_pressure must be executed in the thread 0.
+			ASIO2_ASSERT(this->io_->running_in_this_thread());
+
+			this->listener_.notify(event_type::send_pressure, this_ptr, bool(paused));
+		}
+
 	protected:
 		/// asio::strand ,used to ensure socket multi thread safe,we must ensure that only one operator
 		/// can operate the same socket at the same time,and strand can enuser that the event will
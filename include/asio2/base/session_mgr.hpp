@@ -20,6 +20,10 @@
 #include <functional>
 #include <unordered_map>
 #include <type_traits>
+#include <array>
+#include <vector>
+#include <atomic>
+#include <mutex>
 
 #include <asio2/base/iopool.hpp>
 #include <asio2/base/define.hpp>
@@ -29,6 +33,14 @@
 #include <asio2/base/detail/util.hpp>
 #include <asio2/base/detail/shared_mutex.hpp>
 
+/*
+ * the session map is split into this count of shards to reduce the lock contention, it must
+ * be power of 2.
+ */
+#ifndef ASIO2_SESSION_MGR_SHARDS
+#define ASIO2_SESSION_MGR_SHARDS 16
+#endif
+
 namespace asio2::detail
 {
 	ASIO2_CLASS_FORWARD_DECLARE_BASE;
@@ -88,6 +100,13 @@ namespace asio2::detail
 		using self     = session_mgr_t<session_t>;
 		using args_type = typename session_t::args_type;
 		using key_type  = typename session_t::key_type;
+		using map_type  = std::unordered_map<key_type, std::shared_ptr<session_t>>;
+		using snapshot_type = std::vector<std::shared_ptr<session_t>>;
+
+		static constexpr std::size_t shard_count = std::size_t(ASIO2_SESSION_MGR_SHARDS);
+
+		static_assert(shard_count > 0 && (shard_count & (shard_count - 1)) == 0,
+			"ASIO2_SESSION_MGR_SHARDS must be power of 2");
 
 		/**
 		 * @brief constructor
@@ -96,7 +115,6 @@ namespace asio2::detail
 			: io_   (std::move(acceptor_io))
 			, state_(server_state)
 		{
-			this->sessions_.reserve(64);
 		}
 
 		/**
@@ -149,8 +167,7 @@ namespace asio2::detail
 					// this thread is same as the server's io thread, when code run to here,
 					// the server's _post_stop must not be executed, so the server's sessions_.for_each
 					// -> session_ptr->stop() must not be executed.
-					asio2::unique_locker guard(this->mutex_);
-					inserted = this->sessions_.try_emplace(session_ptr->hash_key(), session_ptr).second;
+					inserted = this->_emplace(session_ptr);
 
 				#if defined(_DEBUG) || defined(DEBUG)
 					ASIO2_ASSERT(is_all_session_stop_called_ == false);
@@ -181,10 +198,7 @@ namespace asio2::detail
 				ASIO2_ASSERT(deadlock_checker_value::get() == false);
 			#endif
 
-				{
-					asio2::unique_locker guard(this->mutex_);
-					erased = (this->sessions_.erase(session_ptr->hash_key()) > 0);
-				}
+				erased = this->_erase(session_ptr);
 
 				(callback)(erased);
 			}));
@@ -219,27 +233,17 @@ namespace asio2::detail
 		inline void for_each(Fun&& fn)
 		{
 			// thred safety for each
-			// 
-			std::vector<std::shared_ptr<session_t>> sessions;
-
+			// the snapshot is only rebuilt after the sessions are changed, so the for_each
+			// don't need to copy all the sessions every time.
 		#if defined(_DEBUG) || defined(DEBUG)
 			ASIO2_ASSERT(deadlock_checker_value::get() == false);
 		#endif
 
-			{
-				asio2::shared_locker guard(this->mutex_);
-
-				sessions.reserve(this->sessions_.size());
-
-				for (const auto& [k, session_ptr] : this->sessions_)
-				{
-					std::ignore = k;
-
-					sessions.emplace_back(session_ptr);
-				}
-			}
+			// the snapshot holds the sessions until the for_each is finished, same as quick_for_each,
+			// the callback should't modify the session_ptr, the snapshot maybe used by other threads.
+			std::shared_ptr<snapshot_type> sessions = this->_snapshot();
 
-			for (std::shared_ptr<session_t>& session_ptr : sessions)
+			for (std::shared_ptr<session_t>& session_ptr : *sessions)
 			{
 				fn(session_ptr);
 			}
@@ -269,32 +273,46 @@ namespace asio2::detail
 			// if the unique locker was called in the callback inner, then will cause deadlock.
 			// and if the callback is a time-consuming operation, the new session will can't enter.
 
-			asio2::shared_locker guard(this->mutex_);
+			for (shard& s : this->shards_)
+			{
+				asio2::shared_locker guard(s.mutex);
 
-		#if defined(_DEBUG) || defined(DEBUG)
-			[[maybe_unused]] deadlock_checker_guard leg(deadlock_checker_value::get());
-		#endif
+			#if defined(_DEBUG) || defined(DEBUG)
+				[[maybe_unused]] deadlock_checker_guard leg(deadlock_checker_value::get());
+			#endif
 
-			for (auto& [k, session_ptr] : this->sessions_)
-			{
-				std::ignore = k;
+				for (auto& [k, session_ptr] : s.sessions)
+				{
+					std::ignore = k;
 
-				fn(session_ptr);
+					fn(session_ptr);
+				}
 			}
 		}
 
 		/**
 		 * @brief find the session by map key
 		 */
-		inline std::shared_ptr<session_t> find(const key_type & key)
+		inline std::shared_ptr<session_t> find(const key_type & key) ASIO2_NO_THREAD_SAFETY_ANALYSIS
 		{
 		#if defined(_DEBUG) || defined(DEBUG)
 			ASIO2_ASSERT(deadlock_checker_value::get() == false);
 		#endif
 
-			asio2::shared_locker guard(this->mutex_);
-			auto iter = this->sessions_.find(key);
-			return (iter == this->sessions_.end() ? std::shared_ptr<session_t>() : iter->second);
+			shard& s = this->_shard(key);
+
+			// the sessions are only inserted and erased in the io_ thread, so find in the io_
+			// thread don't need the lock, eg: the udp server find the session for each datagram
+			// in the io_ thread.
+			if (this->io_->running_in_this_thread())
+			{
+				auto iter = s.sessions.find(key);
+				return (iter == s.sessions.end() ? std::shared_ptr<session_t>() : iter->second);
+			}
+
+			asio2::shared_locker guard(s.mutex);
+			auto iter = s.sessions.find(key);
+			return (iter == s.sessions.end() ? std::shared_ptr<session_t>() : iter->second);
 		}
 
 		/**
@@ -309,13 +327,18 @@ namespace asio2::detail
 		#endif
 
 			// if the unique locker was called in the callback inner, then will cause deadlock.
-			asio2::shared_locker guard(this->mutex_);
-			auto iter = std::find_if(this->sessions_.begin(), this->sessions_.end(),
-			[&fn](auto &pair) mutable
+			for (shard& s : this->shards_)
 			{
-				return fn(pair.second);
-			});
-			return (iter == this->sessions_.end() ? std::shared_ptr<session_t>() : iter->second);
+				asio2::shared_locker guard(s.mutex);
+				auto iter = std::find_if(s.sessions.begin(), s.sessions.end(),
+				[&fn](auto &pair) mutable
+				{
+					return fn(pair.second);
+				});
+				if (iter != s.sessions.end())
+					return iter->second;
+			}
+			return std::shared_ptr<session_t>();
 		}
 
 		/**
@@ -327,93 +350,9 @@ namespace asio2::detail
 			ASIO2_ASSERT(deadlock_checker_value::get() == false);
 		#endif
 
-			asio2::shared_locker guard(this->mutex_);
-
-			// is std map.size() thread safety?
-			// 
-			// https://stackoverflow.com/questions/2170541/what-operations-are-thread-safe-on-stdmap
-			// https://en.cppreference.com/w/cpp/container
-			// https://timsong-cpp.github.io/cppwp/n3337/container.requirements.dataraces
-			// https://stackoverflow.com/questions/15067160/stdmap-thread-safety
-			// https://stackoverflow.com/questions/14127379/does-const-mean-thread-safe-in-c11
-
-			// There is no one consensus:
-
-			// The C++11 standard guarantees that const method access to containers is safe from
-			// different threads (ie, both use const methods).
-
-			// It should be thread-safe to call a const function from multiple threads simultaneously,
-			// without calling a non-const function at the same time in another thread.
-
-			// after my test on windows and linux:
-			// multithread call const function without mutex, and multithread call no-const function 
-			// with mutex at the same time, the result of the const function seems to be no problem.
-
-			//#include <unordered_map>
-			//#include <shared_mutex>
-			//#include <thread>
-			//
-			//int main()
-			//{
-			//    std::shared_mutex mtx;
-			//    std::unordered_map<int, int> map;
-			//
-			//    std::srand((unsigned int)std::time(nullptr));
-			//
-			//    for (std::size_t i = 0; i < std::thread::hardware_concurrency() * 2; i++)
-			//    {
-			//        std::thread([&]() mutable
-			//        {
-			//            for (;;)
-			//            {
-			//                int n = std::rand();
-			//                std::unique_lock g(mtx);
-			//                if (map.size() < 1000)
-			//                    map.emplace(n, n);
-			//                else
-			//                    std::this_thread::sleep_for(std::chrono::milliseconds(0));
-			//            }
-			//        }).detach();
-			//    }
-			//
-			//    for (std::size_t i = 0; i < std::thread::hardware_concurrency() * 2; i++)
-			//    {
-			//        std::thread([&]() mutable
-			//        {
-			//            for (;;)
-			//            {
-			//                std::unique_lock g(mtx);
-			//                if (map.size() > 500)
-			//                    map.erase(map.begin());
-			//                else
-			//                    std::this_thread::sleep_for(std::chrono::milliseconds(0));
-			//            }
-			//        }).detach();
-			//    }
-			//
-			//    std::this_thread::sleep_for(std::chrono::seconds(5));
-			//
-			//    for (std::size_t i = 0; i < std::thread::hardware_concurrency() * 2; i++)
-			//    {
-			//        std::thread([&]() mutable
-			//        {
-			//            for (;;)
-			//            {
-			//                int n = int(map.size());
-			//                if (n < 500 || n > 1000 || map.empty())
-			//                {
-			//                    printf("error %d\n", n);
-			//                }
-			//            }
-			//        }).detach();
-			//    }
-			//
-			//    while (std::getchar() != '\n');
-			//
-			//    return 0;
-			//}
-
-			return this->sessions_.size();
+			// the count is updated when the session is inserted or erased, so it doesn't need
+			// to lock all the shards.
+			return this->size_.load(std::memory_order_acquire);
 		}
 
 		/**
@@ -425,10 +364,18 @@ namespace asio2::detail
 			ASIO2_ASSERT(deadlock_checker_value::get() == false);
 		#endif
 
-			asio2::shared_locker guard(this->mutex_);
+			return (this->size_.load(std::memory_order_acquire) == 0);
+		}
 
-			return this->sessions_.empty();
+	#if defined(ASIO2_ENABLE_METRICS)
+		/**
+		 * @brief get the metrics of the session manager.
+		 */
+		inline session_mgr_metrics metrics() const noexcept
+		{
+			return this->metrics_.snapshot(this->size_.load(std::memory_order_acquire));
 		}
+	#endif
 
 		/**
 		 * @brief get the io object reference
@@ -447,11 +394,154 @@ namespace asio2::detail
 		}
 
 	protected:
-		/// use rwlock to make this session map thread safe
-		mutable asio2::shared_mutexer                            mutex_;
+		struct alignas(64) shard
+		{
+			/// use rwlock to make this session map thread safe
+			mutable asio2::shared_mutexer mutex;
+
+			/// session unorder map,these session is already connected session
+			map_type                      sessions ASIO2_GUARDED_BY(mutex);
+		};
+
+		inline shard& _shard(const key_type& key) noexcept
+		{
+			// the tcp session key is the pointer of the session, the low bits of it are always
+			// same, so mix the hash value before use it.
+			std::uint64_t h = std::uint64_t(std::hash<key_type>{}(key)) * 0x9E3779B97F4A7C15ull;
+
+			return this->shards_[std::size_t(h >> 32) & (shard_count - 1)];
+		}
 
-		/// session unorder map,these session is already connected session 
-		std::unordered_map<key_type, std::shared_ptr<session_t>> sessions_ ASIO2_GUARDED_BY(mutex_);
+		inline bool _emplace(const std::shared_ptr<session_t>& session_ptr)
+		{
+			ASIO2_ASSERT(this->io_->running_in_this_thread());
+
+			shard& s = this->_shard(session_ptr->hash_key());
+
+			{
+				asio2::unique_locker guard(s.mutex);
+
+				if (!s.sessions.try_emplace(session_ptr->hash_key(), session_ptr).second)
+					return false;
+			}
+
+			std::size_t size = this->size_.fetch_add(1, std::memory_order_release) + 1;
+
+		#if defined(ASIO2_ENABLE_METRICS)
+			this->metrics_.on_accept(size);
+		#else
+			std::ignore = size;
+		#endif
+
+			this->_invalidate_snapshot();
+
+			return true;
+		}
+
+		inline bool _erase(const std::shared_ptr<session_t>& session_ptr)
+		{
+			ASIO2_ASSERT(this->io_->running_in_this_thread());
+
+			shard& s = this->_shard(session_ptr->hash_key());
+
+			{
+				asio2::unique_locker guard(s.mutex);
+
+				if (s.sessions.erase(session_ptr->hash_key()) == 0)
+					return false;
+			}
+
+			this->size_.fetch_sub(1, std::memory_order_release);
+
+			this->_invalidate_snapshot();
+
+			return true;
+		}
+
+		inline void _invalidate_snapshot()
+		{
+			std::shared_ptr<snapshot_type> old;
+
+			{
+				asio2::unique_locker guard(this->snapshot_mutex_);
+
+				this->snapshot_version_++;
+
+				// release the sessions of the old snapshot out of the lock.
+				old = std::move(this->snapshot_);
+			}
+		}
+
+		/**
+		 * @brief get the snapshot of all sessions, it is rebuilt only when the sessions changed.
+		 */
+		inline std::shared_ptr<snapshot_type> _snapshot()
+		{
+			std::uint64_t version;
+
+			{
+				asio2::shared_locker guard(this->snapshot_mutex_);
+
+				if (this->snapshot_)
+					return this->snapshot_;
+			}
+
+			// only one thread build the snapshot, the other threads wait for it and use it.
+			std::lock_guard<std::mutex> build_guard(this->snapshot_build_mutex_);
+
+			{
+				asio2::shared_locker guard(this->snapshot_mutex_);
+
+				if (this->snapshot_)
+					return this->snapshot_;
+
+				version = this->snapshot_version_;
+			}
+
+			std::shared_ptr<snapshot_type> sessions = std::make_shared<snapshot_type>();
+
+			sessions->reserve(this->size_.load(std::memory_order_acquire));
+
+			for (shard& s : this->shards_)
+			{
+				asio2::shared_locker guard(s.mutex);
+
+				for (const auto& [k, session_ptr] : s.sessions)
+				{
+					std::ignore = k;
+
+					sessions->emplace_back(session_ptr);
+				}
+			}
+
+			{
+				asio2::unique_locker guard(this->snapshot_mutex_);
+
+				// if the sessions was changed while the snapshot is building, don't cache it.
+				if (version == this->snapshot_version_ && !this->snapshot_)
+					this->snapshot_ = sessions;
+			}
+
+			return sessions;
+		}
+
+	protected:
+		/// the sessions are split into shards by the key
+		std::array<shard, shard_count>                           shards_;
+
+		/// the count of the sessions
+		std::atomic<std::size_t>                                 size_{ 0 };
+
+		/// protect the snapshot_ and the snapshot_version_
+		mutable asio2::shared_mutexer                            snapshot_mutex_;
+
+		/// the cached sessions for the for_each function, it is reset when the sessions changed.
+		std::shared_ptr<snapshot_type>                           snapshot_ ASIO2_GUARDED_BY(snapshot_mutex_);
+
+		std::uint64_t                                            snapshot_version_ ASIO2_GUARDED_BY(snapshot_mutex_) = 0;
+
+		/// make sure only one thread is building the snapshot
+		std::mutex                                               snapshot_build_mutex_;
 
 		/// the zero io_context reference in the iopool
 		std::shared_ptr<io_t>                                    io_;
@@ -462,6 +552,11 @@ namespace asio2::detail
 		/// server state reference
 		std::atomic<state_t>                                   & state_;
 
+	#if defined(ASIO2_ENABLE_METRICS)
+		/// the metrics counters, they are only written in the io_ thread.
+		session_mgr_counters                                     metrics_;
+	#endif
+
 	#if defined(_DEBUG) || defined(DEBUG)
 		bool                                                     is_all_session_stop_called_ = false;
 	#endif
@@ -33,6 +33,7 @@
 
 #include <asio2/base/detail/util.hpp>
 #include <asio2/base/detail/function_traits.hpp>
+#include <asio2/base/detail/awaitable.hpp>
 
 #include <asio2/base/impl/condition_event_cp.hpp>
 
@@ -214,6 +215,46 @@ namespace asio2::detail
 					derive._rdc_send(std::move(p), std::move(data), std::move(timeout), std::move(invoker));
 				}));
 			}
+
+			/// the result of the awaitable async_call, the std::string_view is converted to std::string
+			/// and the reference is removed, beacuse the recv data is invalid after the callback.
+			template<class T>
+			struct result_t
+			{
+				using type = detail::remove_cvref_t<T>;
+			};
+
+			template<class... Ts>
+			struct result_t<std::basic_string_view<Ts...>>
+			{
+				using type = std::basic_string<typename std::basic_string_view<Ts...>::value_type>;
+			};
+
+			using result_type = typename result_t<recv_data_t>::type;
+
+			template<class DataT, class CompletionToken, class Rep, class Period>
+			inline static auto exec_with_token(derive_t& derive, DataT&& data,
+				std::chrono::duration<Rep, Period> timeout, CompletionToken&& token)
+			{
+				return asio::async_initiate<CompletionToken, void(error_code, result_type)>(
+				[&derive, timeout](auto handler, auto data) mutable
+				{
+					// the callback_type is a std::function, so the handler must be copyable.
+					detail::copyable_wrapper<decltype(handler)> h(std::move(handler));
+
+					async_call_op<derive_t, arg_t>::exec(derive, std::move(data), timeout,
+					[&derive, h = std::move(h)](const error_code& ec, send_data_t, recv_data_t recv_data) mutable
+					{
+						result_type result{};
+
+						if (!ec)
+							result = result_type(recv_data);
+
+						detail::awaitable_complete(std::move(h()), derive.io_->context().get_executor(),
+							ec, std::move(result));
+					});
+				}, token, std::forward<DataT>(data));
+			}
 		};
 
 		template<class derive_t, class arg_t>
@@ -458,6 +499,39 @@ namespace asio2::detail
 				rdc_make_callback_t<send_data_t, recv_data_t>::bind(std::forward<Callback>(cb)));
 		}
 
+		/**
+		 * @brief Send data and waiting for a response or until the timeout period is reached in a coroutine
+		 * use like this : auto [ec, rep] = co_await async_call(data, asio::as_tuple(asio::use_awaitable));
+		 * Completion signature : void(asio::error_code ec, DataType data)
+		 * the DataType is the recv data type without reference, and std::string for the std::string_view,
+		 * eg: std::string for tcp, http::web_response for http.
+		 * When the coroutine runs on the io_context of this object, it is resumed on the io
+		 * thread directly when the response is received, without an additional post.
+		 */
+		template<class DataT, class CompletionToken,
+			std::enable_if_t<detail::is_awaitable_token_v<CompletionToken>, int> = 0>
+		inline auto async_call(DataT&& data, CompletionToken&& token)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			return async_call_op<derived_t, args_t>::exec_with_token(derive, std::forward<DataT>(data),
+				derive.get_default_timeout(), std::forward<CompletionToken>(token));
+		}
+
+		/**
+		 * @brief Send data and waiting for a response or until the timeout period is reached in a coroutine
+		 * Completion signature : void(asio::error_code ec, DataType data)
+		 */
+		template<class DataT, class CompletionToken, class Rep, class Period,
+			std::enable_if_t<detail::is_awaitable_token_v<CompletionToken>, int> = 0>
+		inline auto async_call(DataT&& data, CompletionToken&& token, std::chrono::duration<Rep, Period> timeout)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			return async_call_op<derived_t, args_t>::exec_with_token(derive, std::forward<DataT>(data),
+				timeout, std::forward<CompletionToken>(token));
+		}
+
 		/**
 		 * @brief Send data and asynchronous waiting for a response or until the timeout period is reached
 		 */
@@ -41,6 +41,10 @@
 // eg : stop_timer will awake the timer with error of asio::error::operation_aborted.
 //#define ASIO2_ENABLE_TIMER_CALLBACK_WHEN_ERROR
 
+// Define ASIO2_ENABLE_IO_URING to use io_uring instead of epoll as the backend of the io_context
+// on linux, need linker "uring". see : asio2::get_io_backend()
+//#define ASIO2_ENABLE_IO_URING
+
 // Define ASIO_NO_EXCEPTIONS to disable the exception. so when the exception occurs, you can
 // check the stack trace.
 // If the ASIO_NO_EXCEPTIONS is defined, you can impl the throw_exception function by youself,
@@ -29,6 +29,26 @@
 #  endif
 #endif
 
+// Use io_uring instead of epoll as the reactor of the io_context, the sockets, timers and the
+// asio file objects are all driven by io_uring. Need linux kernel 5.10 or later and liburing.
+#if defined(ASIO2_ENABLE_IO_URING) && defined(__linux__)
+#  ifdef ASIO_STANDALONE
+#    ifndef ASIO_HAS_IO_URING
+#    define ASIO_HAS_IO_URING 1
+#    endif
+#    ifndef ASIO_DISABLE_EPOLL
+#    define ASIO_DISABLE_EPOLL 1
+#    endif
+#  else
+#    ifndef BOOST_ASIO_HAS_IO_URING
+#    define BOOST_ASIO_HAS_IO_URING 1
+#    endif
+#    ifndef BOOST_ASIO_DISABLE_EPOLL
+#    define BOOST_ASIO_DISABLE_EPOLL 1
+#    endif
+#  endif
+#endif
+
 #include <asio2/base/detail/push_options.hpp>
 
 #ifdef ASIO_STANDALONE
@@ -37,6 +57,7 @@
 	#elif __has_include(<asio/asio.hpp>)
 		#include <asio/asio.hpp>
 	#else
+		#include "asio/as_tuple.hpp"
 		#include "asio/associated_allocator.hpp"
 		#include "asio/associated_executor.hpp"
 		#include "asio/async_result.hpp"
@@ -273,6 +294,9 @@
 	#if !defined(ASIO_HAS_STD_HASH) && defined(BOOST_ASIO_HAS_STD_HASH)
 	#define ASIO_HAS_STD_HASH BOOST_ASIO_HAS_STD_HASH
 	#endif
+	#if !defined(ASIO_HAS_CO_AWAIT) && defined(BOOST_ASIO_HAS_CO_AWAIT)
+	#define ASIO_HAS_CO_AWAIT BOOST_ASIO_HAS_CO_AWAIT
+	#endif
 	#if !defined(ASIO_SYNC_OP_VOID) && defined(BOOST_ASIO_SYNC_OP_VOID)
 	#define ASIO_SYNC_OP_VOID BOOST_ASIO_SYNC_OP_VOID
 	#endif
@@ -123,27 +123,37 @@ namespace asio2::detail
 		 * a numeric address string.
 		 * @param port - A string identifying the requested service. This may be a
 		 * descriptive name or a numeric string corresponding to a port number.
+		 * The last one of the args can be a completion token, eg: asio::use_awaitable, then it
+		 * returns an awaitable which completes with void(asio::error_code ec) when connected.
 		 */
 		template<typename String, typename StrOrInt, typename... Args>
-		inline bool async_start(String&& host, StrOrInt&& port, Args&&... args)
+		inline auto async_start(String&& host, StrOrInt&& port, Args&&... args)
 		{
-			if constexpr (ecs_helper::args_has_rdc<Args...>())
+			if constexpr (detail::is_last_awaitable_token_v<Args...>)
 			{
-				return this->derived().template _do_connect<true>(
-					std::forward<String>(host), std::forward<StrOrInt>(port),
-					ecs_helper::make_ecs('0', std::forward<Args>(args)...));
+				return this->derived()._async_start_with_token(
+					std::forward<String>(host), std::forward<StrOrInt>(port), std::forward<Args>(args)...);
 			}
 			else
 			{
-				asio2::rdc::option rdc_option
+				if constexpr (ecs_helper::args_has_rdc<Args...>())
 				{
-					[](http::web_request &) { return 0; },
-					[](http::web_response&) { return 0; }
-				};
-
-				return this->derived().template _do_connect<true>(
-					std::forward<String>(host), std::forward<StrOrInt>(port),
-					ecs_helper::make_ecs('0', std::forward<Args>(args)..., std::move(rdc_option)));
+					return this->derived().template _do_connect<true>(
+						std::forward<String>(host), std::forward<StrOrInt>(port),
+						ecs_helper::make_ecs('0', std::forward<Args>(args)...));
+				}
+				else
+				{
+					asio2::rdc::option rdc_option
+					{
+						[](http::web_request &) { return 0; },
+						[](http::web_response&) { return 0; }
+					};
+
+					return this->derived().template _do_connect<true>(
+						std::forward<String>(host), std::forward<StrOrInt>(port),
+						ecs_helper::make_ecs('0', std::forward<Args>(args)..., std::move(rdc_option)));
+				}
 			}
 		}
 
@@ -220,6 +230,10 @@ namespace asio2::detail
 			}
 		}
 
+		// the http message has its own framing, so the send coalesce is not supported.
+		template<class... Args>
+		inline bool _do_send_batch(Args&&... args) = delete;
+
 		template<class Data>
 		inline send_data_t _rdc_convert_to_send_data(Data& data)
 		{
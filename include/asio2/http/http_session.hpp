@@ -372,6 +372,10 @@ namespace asio2::detail
 			return this->derived()._http_send(data, std::forward<Callback>(callback));
 		}
 
+		// the http message has its own framing, so the send coalesce is not supported.
+		template<class... Args>
+		inline bool _do_send_batch(Args&&... args) = delete;
+
 		template<class Data>
 		inline send_data_t _rdc_convert_to_send_data(Data& data) noexcept
 		{
@@ -152,6 +152,16 @@ namespace asio2::detail
 
 			derive._check_http_message(data.base());
 
+			// the file body is sent by the async_send_file, it uses sendfile on the plain socket.
+			if constexpr (std::is_same_v<Body, http::flex_body> && std::is_same_v<int, decltype(
+				std::declval<typename http::file_body::value_type&>().file().native_handle())>)
+			{
+				if (data.body().is_file() && !data.chunked())
+				{
+					return derive._http_send_file(data, std::forward<Callback>(callback));
+				}
+			}
+
 		#if defined(_DEBUG) || defined(DEBUG)
 			ASIO2_ASSERT(derive.post_send_counter_.load() == 0);
 			derive.post_send_counter_++;
@@ -181,6 +191,67 @@ namespace asio2::detail
 			return true;
 		}
 
+		/**
+		 * @brief write the header of the response, then send the file body by _tcp_send_file.
+		 */
+		template<class Body, class Fields, class Callback>
+		inline bool _http_send_file(detail::http_response_impl_t<Body, Fields>& data, Callback&& callback)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			using serializer_type = http::response_serializer<Body, Fields>;
+
+			std::unique_ptr<serializer_type> sr = std::make_unique<serializer_type>(data.base());
+
+			sr->split(true);
+
+			serializer_type& ref = *sr;
+
+		#if defined(_DEBUG) || defined(DEBUG)
+			ASIO2_ASSERT(derive.post_send_counter_.load() == 0);
+			derive.post_send_counter_++;
+		#endif
+
+			http::async_write_header(derive.stream(), ref, make_allocator(derive.wallocator(),
+			[&derive, &data, sr = std::move(sr), callback = std::forward<Callback>(callback)]
+			(const error_code& ec, std::size_t bytes_sent) mutable
+			{
+			#if defined(_DEBUG) || defined(DEBUG)
+				derive.post_send_counter_--;
+			#endif
+
+				sr.reset();
+
+				std::uint64_t size = data.body().size();
+
+				if (ec || size == 0)
+				{
+					set_last_error(ec);
+
+					callback(ec, bytes_sent);
+
+					if (ec && derive.state_ == state_t::started)
+					{
+						derive._do_disconnect(ec, derive.selfptr());
+					}
+					return;
+				}
+
+				std::unique_ptr<send_file_state> state = std::make_unique<send_file_state>();
+
+				state->fd        = data.body().file().file().native_handle();
+				state->offset    = 0;
+				state->remaining = size;
+
+				derive._tcp_send_file(std::move(state),
+				[bytes_sent, callback = std::move(callback)](const error_code& ec, std::size_t file_sent) mutable
+				{
+					callback(ec, bytes_sent + file_sent);
+				});
+			}));
+			return true;
+		}
+
 	protected:
 	};
 }
@@ -162,18 +162,28 @@ namespace asio2::detail
 		 * @param args - The args can be include the upgraged target.
 		 * eg: async_start("127.0.0.1", 8883); async_start("127.0.0.1", 8883, "/admin");
 		 * the "/admin" is the websocket upgraged target
+		 * The last one of the args can be a completion token, eg: asio::use_awaitable, then it
+		 * returns an awaitable which completes with void(asio::error_code ec) when connected.
 		 */
 		template<typename String, typename StrOrInt, typename... Args>
-		inline bool async_start(String&& host, StrOrInt&& port, Args&&... args)
+		inline auto async_start(String&& host, StrOrInt&& port, Args&&... args)
 		{
-			if constexpr (sizeof...(Args) > std::size_t(0))
-				return this->derived().template _do_connect_with_target<true>(
-					std::forward<String>(host), std::forward<StrOrInt>(port),
-					std::forward<Args>(args)...);
+			if constexpr (detail::is_last_awaitable_token_v<Args...>)
+			{
+				return this->derived()._async_start_with_token(
+					std::forward<String>(host), std::forward<StrOrInt>(port), std::forward<Args>(args)...);
+			}
 			else
-				return this->derived().template _do_connect<true>(
-					std::forward<String>(host), std::forward<StrOrInt>(port),
-					ecs_helper::make_ecs('0', std::forward<Args>(args)...));
+			{
+				if constexpr (sizeof...(Args) > std::size_t(0))
+					return this->derived().template _do_connect_with_target<true>(
+						std::forward<String>(host), std::forward<StrOrInt>(port),
+						std::forward<Args>(args)...);
+				else
+					return this->derived().template _do_connect<true>(
+						std::forward<String>(host), std::forward<StrOrInt>(port),
+						ecs_helper::make_ecs('0', std::forward<Args>(args)...));
+			}
 		}
 
 		/**
@@ -304,6 +314,10 @@ namespace asio2::detail
 			return this->derived()._ws_send(data, std::forward<Callback>(callback));
 		}
 
+		// the websocket message has its own framing, so the send coalesce is not supported.
+		template<class... Args>
+		inline bool _do_send_batch(Args&&... args) = delete;
+
 	protected:
 		template<typename C>
 		inline void _post_recv(std::shared_ptr<derived_t> this_ptr, std::shared_ptr<ecs_t<C>> ecs)
@@ -233,6 +233,10 @@ namespace asio2::detail
 			return this->derived()._ws_send(data, std::forward<Callback>(callback));
 		}
 
+		// the websocket message has its own framing, so the send coalesce is not supported.
+		template<class... Args>
+		inline bool _do_send_batch(Args&&... args) = delete;
+
 	protected:
 		template<typename C>
 		inline void _post_recv(std::shared_ptr<derived_t> this_ptr, std::shared_ptr<ecs_t<C>> ecs)
@@ -181,19 +181,29 @@ namespace asio2::detail
 		 * a numeric address string.
 		 * @param port - A string identifying the requested service. This may be a
 		 * descriptive name or a numeric string corresponding to a port number.
+		 * The last one of the args can be a completion token, eg: asio::use_awaitable, then it
+		 * returns an awaitable which completes with void(asio::error_code ec) when connected.
 		 */
 		template<typename String, typename StrOrInt, typename... Args>
-		inline bool async_start(String&& host, StrOrInt&& port, Args&&... args)
+		inline auto async_start(String&& host, StrOrInt&& port, Args&&... args)
 		{
-			if constexpr (sizeof...(Args) > std::size_t(0))
-				return this->derived().template _do_connect_with_connect_message<true>(
-					std::forward<String>(host), std::forward<StrOrInt>(port),
-					std::forward<Args>(args)...);
+			if constexpr (detail::is_last_awaitable_token_v<Args...>)
+			{
+				return this->derived()._async_start_with_token(
+					std::forward<String>(host), std::forward<StrOrInt>(port), std::forward<Args>(args)...);
+			}
 			else
-				return this->derived().template _do_connect<true>(
-					std::forward<String>(host), std::forward<StrOrInt>(port),
-					ecs_helper::make_ecs(asio::transfer_at_least(1),
-						mqtt::mqtt_match_role, std::forward<Args>(args)...));
+			{
+				if constexpr (sizeof...(Args) > std::size_t(0))
+					return this->derived().template _do_connect_with_connect_message<true>(
+						std::forward<String>(host), std::forward<StrOrInt>(port),
+						std::forward<Args>(args)...);
+				else
+					return this->derived().template _do_connect<true>(
+						std::forward<String>(host), std::forward<StrOrInt>(port),
+						ecs_helper::make_ecs(asio::transfer_at_least(1),
+							mqtt::mqtt_match_role, std::forward<Args>(args)...));
+			}
 		}
 
 	public:
@@ -685,6 +695,10 @@ namespace asio2::detail
 			return this->derived()._mqtt_send(data, std::forward<Callback>(callback));
 		}
 
+		// the mqtt message has its own framing, so the send coalesce is not supported.
+		template<class... Args>
+		inline bool _do_send_batch(Args&&... args) = delete;
+
 	protected:
 		template<typename C>
 		inline void _fire_recv(
@@ -358,6 +358,10 @@ namespace asio2::detail
 			return this->derived()._mqtt_send(data, std::forward<Callback>(callback));
 		}
 
+		// the mqtt message has its own framing, so the send coalesce is not supported.
+		template<class... Args>
+		inline bool _do_send_batch(Args&&... args) = delete;
+
 	protected:
 		template<typename C>
 		inline void _fire_recv(
@@ -56,6 +56,7 @@ auto f(Args&& ... args){
 
 #include <asio2/base/error.hpp>
 #include <asio2/base/detail/function_traits.hpp>
+#include <asio2/base/detail/awaitable.hpp>
 
 #include <asio2/rpc/detail/rpc_serialization.hpp>
 #include <asio2/rpc/detail/rpc_protocol.hpp>
@@ -523,6 +524,43 @@ namespace asio2::detail
 
 				asio::post(derive.io_->context(), make_allocator(derive.callocator_, std::move(fn)));
 			}
+
+			template<class return_t, class CompletionToken, class Rep, class Period, class Req>
+			inline static auto exec(derive_t& derive, CompletionToken&& token,
+				std::chrono::duration<Rep, Period> timeout, Req&& req)
+			{
+				using result_type = typename rpc_result_t<return_t>::type;
+				using signature_type = std::conditional_t<std::is_same_v<return_t, void>,
+					void(error_code), void(error_code, result_type)>;
+
+				return asio::async_initiate<CompletionToken, signature_type>(
+				[&derive, timeout](auto handler, auto req) mutable
+				{
+					// the callback is saved into the std::function of reqs_, so it must be copyable.
+					detail::copyable_wrapper<decltype(handler)> h(std::move(handler));
+
+					if constexpr (std::is_same_v<return_t, void>)
+					{
+						async_call_op<derive_t>::template exec(derive, derive.mkid(), timeout,
+							async_call_op<derive_t>::template make_callback_impl<return_t>(derive,
+							[&derive, h = std::move(h)]() mutable
+							{
+								detail::awaitable_complete(std::move(h()), derive.io_->context().get_executor(),
+									get_last_error());
+							}), std::move(req));
+					}
+					else
+					{
+						async_call_op<derive_t>::template exec(derive, derive.mkid(), timeout,
+							async_call_op<derive_t>::template make_callback_impl<return_t>(derive,
+							[&derive, h = std::move(h)](result_type result) mutable
+							{
+								detail::awaitable_complete(std::move(h()), derive.io_->context().get_executor(),
+									get_last_error(), std::move(result));
+							}), std::move(req));
+					}
+				}, token, std::forward<Req>(req));
+			}
 		};
 
 		template<class derive_t>
@@ -846,6 +884,44 @@ namespace asio2::detail
 				rpc_request<Args...>{ std::move(name), std::forward<Args>(args)... });
 		}
 
+		/**
+		 * @brief asynchronous call a rpc function in a coroutine
+		 * the return_t is the first template parameter.
+		 * use like this : auto [ec, sum] = co_await async_call<int>(asio::as_tuple(asio::use_awaitable), "add", 1, 2);
+		 * Completion signature : void(asio::error_code ec, return_t result)
+		 * if result type is void, the Completion signature is : void(asio::error_code ec)
+		 * When the coroutine runs on the io_context of this object, it is resumed on the io
+		 * thread directly when the response is received, without an additional post.
+		 */
+		template<class return_t, class CompletionToken,
+			std::enable_if_t<detail::is_awaitable_token_v<CompletionToken>, int> = 0, class ...Args>
+		inline auto async_call(CompletionToken&& token, std::string name, Args&&... args)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			return async_call_op<derived_t>::template exec<return_t>(derive,
+				std::forward<CompletionToken>(token), derive.get_default_timeout(),
+				rpc_request<Args...>{ std::move(name), std::forward<Args>(args)... });
+		}
+
+		/**
+		 * @brief asynchronous call a rpc function in a coroutine
+		 * the return_t is the first template parameter.
+		 * Completion signature : void(asio::error_code ec, return_t result)
+		 * if result type is void, the Completion signature is : void(asio::error_code ec)
+		 */
+		template<class return_t, class CompletionToken, class Rep, class Period,
+			std::enable_if_t<detail::is_awaitable_token_v<CompletionToken>, int> = 0, class ...Args>
+		inline auto async_call(CompletionToken&& token, std::chrono::duration<Rep, Period> timeout,
+			std::string name, Args&&... args)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			return async_call_op<derived_t>::template exec<return_t>(derive,
+				std::forward<CompletionToken>(token), timeout,
+				rpc_request<Args...>{ std::move(name), std::forward<Args>(args)... });
+		}
+
 		/**
 		 * @brief asynchronous call a rpc function
 		 */
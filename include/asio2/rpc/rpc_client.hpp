@@ -132,12 +132,19 @@ namespace asio2::detail
 		 * a numeric address string.
 		 * @param port - A string identifying the requested service. This may be a
 		 * descriptive name or a numeric string corresponding to a port number.
+		 * The last one of the args can be a completion token, eg: asio::use_awaitable, then it
+		 * returns an awaitable which completes with void(asio::error_code ec) when connected.
 		 */
 		template<typename String, typename StrOrInt, typename... Args>
-		bool async_start(String&& host, StrOrInt&& port, Args&&... args)
+		auto async_start(String&& host, StrOrInt&& port, Args&&... args)
 		{
 			//static_assert(net_protocol != asio2::net_protocol::udp, "net_protocol::udp not supported");
-			if constexpr (is_websocket_client<executor_t>::value)
+			if constexpr (detail::is_last_awaitable_token_v<Args...>)
+			{
+				return this->derived()._async_start_with_token(
+					std::forward<String>(host), std::forward<StrOrInt>(port), std::forward<Args>(args)...);
+			}
+			else if constexpr (is_websocket_client<executor_t>::value)
 			{
 				return executor_t::template async_start(
 					std::forward<String>(host), std::forward<StrOrInt>(port),
@@ -849,6 +849,16 @@ namespace asio2::detail
 			this->listener_.notify(event_type::stop);
 		}
 
+		inline void _fire_send_pressure(std::shared_ptr<derived_t>& this_ptr, bool paused)
+		{
+			// the _fire_send_pressure must be executed in the thread 0.
+			ASIO2_ASSERT(this->derived().io_->running_in_this_thread());
+
+			detail::ignore_unused(this_ptr);
+
+			this->listener_.notify(event_type::send_pressure, bool(paused));
+		}
+
 		template<typename C>
 		inline void _fire_recv(
 			std::shared_ptr<derived_t>& this_ptr, std::shared_ptr<ecs_t<C>>& ecs, std::string_view data)
@@ -22,6 +22,8 @@
 
 #include <asio2/base/error.hpp>
 #include <asio2/base/detail/ecs.hpp>
+#include <asio2/base/detail/buffer_pool.hpp>
+#include <asio2/base/detail/recv_chunk.hpp>
 
 namespace asio2::detail
 {
@@ -35,6 +37,18 @@ namespace asio2::detail
 		template<class T>
 		struct has_member_dgram<T, std::void_t<decltype(T::dgram_)>> : std::true_type {};
 
+		template<class, class = std::void_t<>>
+		struct has_member_buffer_pool : std::false_type {};
+
+		template<class T>
+		struct has_member_buffer_pool<T, std::void_t<decltype(T::buffer_pool_)>> : std::true_type {};
+
+		template<class, class = std::void_t<>>
+		struct has_member_recv_chunk : std::false_type {};
+
+		template<class T>
+		struct has_member_recv_chunk<T, std::void_t<decltype(T::recv_chunk_)>> : std::true_type {};
+
 	public:
 		/**
 		 * @brief constructor
@@ -65,6 +79,222 @@ namespace asio2::detail
 				return;
 			}
 
+			if constexpr (_is_buffer_pool_supported())
+			{
+				// nothing is pending, wait for the socket to become readable without a buffer, then
+				// the idle session holds no receive buffer.
+				if (derive.buffer_pool_ && derive.template _tcp_recv_data<C>().size() == 0)
+				{
+					derive._tcp_release_buffer();
+
+				#if defined(_DEBUG) || defined(DEBUG)
+					ASIO2_ASSERT(derive.post_recv_counter_.load() == 0);
+					derive.post_recv_counter_++;
+				#endif
+
+					ASIO2_ASSERT(derive.reading_ == false);
+
+					derive.reading_ = true;
+
+					derive.socket().async_wait(asio::socket_base::wait_read,
+						make_allocator(derive.rallocator(),
+							[&derive, this_ptr = std::move(this_ptr), ecs = std::move(ecs)]
+					(const error_code& ec) mutable
+					{
+					#if defined(_DEBUG) || defined(DEBUG)
+						derive.post_recv_counter_--;
+					#endif
+
+						derive.reading_ = false;
+
+						if (ec || !derive.is_started())
+						{
+							derive._handle_recv(ec, 0, std::move(this_ptr), std::move(ecs));
+						}
+						else
+						{
+							derive._tcp_post_read(std::move(this_ptr), std::move(ecs));
+						}
+					}));
+
+					return;
+				}
+			}
+
+			derive._tcp_post_read(std::move(this_ptr), std::move(ecs));
+		}
+
+		/**
+		 * @brief whether the receive buffer can be released to the buffer pool when idle, the
+		 * readiness of the socket is meaningless for the ssl stream, so it works with the plain
+		 * tcp socket only.
+		 */
+		static constexpr bool _is_buffer_pool_supported() noexcept
+		{
+			if constexpr (has_member_buffer_pool<derived_t>::value)
+			{
+				return std::is_same_v<typename derived_t::buffer_type, detail::pooled_streambuf> &&
+					std::is_same_v<detail::remove_cvref_t<decltype(std::declval<derived_t&>().stream())>,
+						asio::ip::tcp::socket>;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		/**
+		 * @brief free the memory of the receive buffer, the buffer is recreated with the allocator
+		 * of the buffer pool, then the buffer borrows the memory from the pool when reading and
+		 * returns it here when it is idle again.
+		 */
+		inline void _tcp_release_buffer()
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			auto& buffer = derive.buffer();
+
+			ASIO2_ASSERT(buffer.size() == 0);
+
+			if constexpr (has_member_recv_chunk<derived_t>::value)
+			{
+				derive.chunk_buffer_.release();
+			}
+
+			// the asio::streambuf always holds a small block of buffer_delta (128) bytes.
+			if (buffer.capacity() <= std::size_t(128))
+				return;
+
+			derive._tcp_reset_buffer();
+		}
+
+		/**
+		 * @brief recreate the receive buffer with the allocator of the buffer pool.
+		 */
+		inline void _tcp_reset_buffer()
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			auto& buffer = derive.buffer();
+
+			using buffer_wrap_type = detail::remove_cvref_t<decltype(buffer)>;
+
+			std::size_t pre_size = buffer.pre_size();
+			std::size_t max_size = buffer.max_size();
+
+			std::destroy_at(std::addressof(buffer));
+
+			::new (static_cast<void*>(std::addressof(buffer))) buffer_wrap_type(
+				max_size, buffer_pool_allocator<char>(derive.io_->buffer_pool()));
+
+			buffer.pre_size(pre_size);
+		}
+
+		/**
+		 * @brief whether the received data can be shared as a recv_chunk without a copy, the hook
+		 * buffer condition consumes the buffer by the user, so it is not supported.
+		 */
+		template<typename C>
+		static constexpr bool _is_recv_chunk_supported() noexcept
+		{
+			if constexpr (has_member_recv_chunk<derived_t>::value)
+			{
+				return !std::is_same_v<typename ecs_t<C>::condition_lowest_type, asio2::detail::hook_buffer_t>;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		/**
+		 * @brief get the received data of the buffer which is used to read currently.
+		 */
+		template<typename C>
+		inline asio::const_buffer _tcp_recv_data() noexcept
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			if constexpr (_is_recv_chunk_supported<C>())
+			{
+				if (derive.recv_chunk_)
+					return derive.chunk_buffer_.data();
+			}
+
+			return derive.buffer().data();
+		}
+
+		template<typename C>
+		inline void _tcp_recv_consume(std::size_t bytes) noexcept
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			if constexpr (_is_recv_chunk_supported<C>())
+			{
+				if (derive.recv_chunk_)
+				{
+					derive.chunk_buffer_.consume(bytes);
+					return;
+				}
+			}
+
+			derive.buffer().consume(bytes);
+		}
+
+		template<typename C>
+		inline void _tcp_fire_recv(
+			std::shared_ptr<derived_t>& this_ptr, std::shared_ptr<ecs_t<C>>& ecs, std::string_view data)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+		#if defined(ASIO2_ENABLE_METRICS)
+			auto t1 = std::chrono::steady_clock::now();
+		#endif
+
+			if constexpr (has_member_recv_chunk<derived_t>::value)
+			{
+				// the get_recv_chunk in the recv callback shares this data.
+				derive.recv_chunk_data_ = data;
+
+				derive._fire_recv(this_ptr, ecs, data);
+
+				derive.recv_chunk_data_ = {};
+			}
+			else
+			{
+				derive._fire_recv(this_ptr, ecs, data);
+			}
+
+		#if defined(ASIO2_ENABLE_METRICS)
+			derive._metrics_recv(data.size(), std::chrono::steady_clock::now() - t1);
+		#endif
+		}
+
+		template<typename C>
+		void _tcp_post_read(std::shared_ptr<derived_t> this_ptr, std::shared_ptr<ecs_t<C>> ecs)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			if constexpr (_is_recv_chunk_supported<C>())
+			{
+				if (derive.recv_chunk_)
+				{
+					derive._tcp_post_read_into(detail::chunk_buffer_ref(derive.chunk_buffer_),
+						std::move(this_ptr), std::move(ecs));
+					return;
+				}
+			}
+
+			derive._tcp_post_read_into(derive.buffer().base(), std::move(this_ptr), std::move(ecs));
+		}
+
+		template<typename Buffer, typename C>
+		void _tcp_post_read_into(Buffer&& buffer, std::shared_ptr<derived_t> this_ptr, std::shared_ptr<ecs_t<C>> ecs)
+		{
+			using condition_lowest_type = typename ecs_t<C>::condition_lowest_type;
+
+			derived_t& derive = static_cast<derived_t&>(*this);
+
 		#if defined(_DEBUG) || defined(DEBUG)
 			ASIO2_ASSERT(derive.post_recv_counter_.load() == 0);
 			derive.post_recv_counter_++;
@@ -82,7 +312,7 @@ namespace asio2::detail
 				std::is_same_v<condition_lowest_type, asio::detail::transfer_exactly_t> ||
 				std::is_same_v<condition_lowest_type, asio2::detail::hook_buffer_t>)
 			{
-				asio::async_read(derive.stream(), derive.buffer().base(), e.get_condition().lowest(),
+				asio::async_read(derive.stream(), std::forward<Buffer>(buffer), e.get_condition().lowest(),
 					make_allocator(derive.rallocator(),
 						[&derive, this_ptr = std::move(this_ptr), ecs = std::move(ecs)]
 				(const error_code& ec, std::size_t bytes_recvd) mutable
@@ -98,7 +328,7 @@ namespace asio2::detail
 			}
 			else
 			{
-				asio::async_read_until(derive.stream(), derive.buffer().base(), e.get_condition().lowest(),
+				asio::async_read_until(derive.stream(), std::forward<Buffer>(buffer), e.get_condition().lowest(),
 					make_allocator(derive.rallocator(),
 						[&derive, this_ptr = std::move(this_ptr), ecs = std::move(ecs)]
 				(const error_code& ec, std::size_t bytes_recvd) mutable
@@ -123,21 +353,21 @@ namespace asio2::detail
 
 			derived_t& derive = static_cast<derived_t&>(*this);
 
-			const std::uint8_t* buffer = static_cast<const std::uint8_t*>(derive.buffer().data().data());
+			const std::uint8_t* buffer = static_cast<const std::uint8_t*>(derive.template _tcp_recv_data<C>().data());
 			if /**/ (std::uint8_t(buffer[0]) < std::uint8_t(254))
 			{
-				derive._fire_recv(this_ptr, ecs, std::string_view(reinterpret_cast<
+				derive._tcp_fire_recv(this_ptr, ecs, std::string_view(reinterpret_cast<
 					std::string_view::const_pointer>(buffer + 1), bytes_recvd - 1));
 			}
 			else if (std::uint8_t(buffer[0]) == std::uint8_t(254))
 			{
-				derive._fire_recv(this_ptr, ecs, std::string_view(reinterpret_cast<
+				derive._tcp_fire_recv(this_ptr, ecs, std::string_view(reinterpret_cast<
 					std::string_view::const_pointer>(buffer + 1 + 2), bytes_recvd - 1 - 2));
 			}
 			else
 			{
 				ASIO2_ASSERT(std::uint8_t(buffer[0]) == std::uint8_t(255));
-				derive._fire_recv(this_ptr, ecs, std::string_view(reinterpret_cast<
+				derive._tcp_fire_recv(this_ptr, ecs, std::string_view(reinterpret_cast<
 					std::string_view::const_pointer>(buffer + 1 + 8), bytes_recvd - 1 - 8));
 			}
 		}
@@ -215,12 +445,12 @@ namespace asio2::detail
 				{
 					if constexpr (!std::is_same_v<condition_lowest_type, asio2::detail::hook_buffer_t>)
 					{
-						derive._fire_recv(this_ptr, ecs, std::string_view(reinterpret_cast<
-							std::string_view::const_pointer>(derive.buffer().data().data()), bytes_recvd));
+						derive._tcp_fire_recv(this_ptr, ecs, std::string_view(reinterpret_cast<
+							std::string_view::const_pointer>(derive.template _tcp_recv_data<C>().data()), bytes_recvd));
 					}
 					else
 					{
-						derive._fire_recv(this_ptr, ecs, std::string_view(reinterpret_cast<
+						derive._tcp_fire_recv(this_ptr, ecs, std::string_view(reinterpret_cast<
 							std::string_view::const_pointer>(derive.buffer().data().data()),
 							derive.buffer().size()));
 					}
@@ -228,7 +458,7 @@ namespace asio2::detail
 
 				if constexpr (!std::is_same_v<condition_lowest_type, asio2::detail::hook_buffer_t>)
 				{
-					derive.buffer().consume(bytes_recvd);
+					derive.template _tcp_recv_consume<C>(bytes_recvd);
 				}
 				else
 				{
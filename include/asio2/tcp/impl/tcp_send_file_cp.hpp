@@ -0,0 +1,458 @@
+/*
+ * Copyright (c) 2017-2023 zhllxt
+ *
+ * author   : zhllxt
+ * email    : 37792738@qq.com
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef __ASIO2_TCP_SEND_FILE_COMPONENT_HPP__
+#define __ASIO2_TCP_SEND_FILE_COMPONENT_HPP__
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <filesystem>
+#include <limits>
+
+#include <asio2/external/predef.h>
+
+#include <asio2/base/error.hpp>
+#include <asio2/base/detail/buffer_wrap.hpp>
+
+#if ASIO2_OS_WINDOWS
+#	include <io.h>
+#	include <fcntl.h>
+#	include <sys/types.h>
+#	include <sys/stat.h>
+#else
+#	include <fcntl.h>
+#	include <unistd.h>
+#	include <sys/types.h>
+#	include <sys/stat.h>
+#	if ASIO2_OS_LINUX
+#		include <sys/sendfile.h>
+#	endif
+#endif
+
+/*
+ * the size of the buffer which is used to read the file when the file is sent by read and write,
+ * eg: the ssl stream, or the sendfile is not supported.
+ */
+#ifndef ASIO2_SEND_FILE_CHUNK_SIZE
+#define ASIO2_SEND_FILE_CHUNK_SIZE (64 * 1024)
+#endif
+
+namespace asio2::detail
+{
+	/**
+	 * @brief the file which is being sent, the file is closed when it is destroyed if it was
+	 * opened by async_send_file.
+	 */
+	struct send_file_state
+	{
+		int            fd        = -1;
+		bool           owned     = false;
+		bool           sendfile  = false;
+		std::uint64_t  offset    = 0;
+		std::uint64_t  remaining = 0;
+		std::size_t    sent      = 0;
+
+		std::unique_ptr<char[]> chunk;
+
+		send_file_state() = default;
+
+		send_file_state(const send_file_state&) = delete;
+		send_file_state& operator=(const send_file_state&) = delete;
+
+		~send_file_state()
+		{
+			if (owned && fd != -1)
+			{
+			#if ASIO2_OS_WINDOWS
+				::_close(fd);
+			#else
+				::close(fd);
+			#endif
+			}
+		}
+
+		/**
+		 * @brief open the file for reading.
+		 */
+		inline error_code open(const std::filesystem::path& path) noexcept
+		{
+		#if ASIO2_OS_WINDOWS
+			this->fd = ::_wopen(path.c_str(), _O_RDONLY | _O_BINARY);
+		#else
+			this->fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		#endif
+
+			if (this->fd == -1)
+				return error_code(errno, asio::error::get_system_category());
+
+			this->owned = true;
+
+			return error_code{};
+		}
+
+		/**
+		 * @brief check the range and calculate the bytes to be sent.
+		 * @param length - 0 means all the remaining bytes from the offset to the end of the file.
+		 */
+		inline error_code prepare(std::uint64_t off, std::uint64_t length) noexcept
+		{
+		#if ASIO2_OS_WINDOWS
+			struct _stat64 st;
+			if (::_fstat64(this->fd, &st) != 0)
+				return error_code(errno, asio::error::get_system_category());
+		#else
+			struct stat st;
+			if (::fstat(this->fd, &st) != 0)
+				return error_code(errno, asio::error::get_system_category());
+		#endif
+
+			std::uint64_t size = static_cast<std::uint64_t>(st.st_size);
+
+			if (off > size)
+				return asio::error::invalid_argument;
+
+			this->offset    = off;
+			this->remaining = (length == 0) ? (size - off) : (std::min)(length, size - off);
+
+			return error_code{};
+		}
+
+		/**
+		 * @brief read the next chunk of the file at the current offset.
+		 * @return the bytes read, 0 means the end of the file.
+		 */
+		inline std::size_t read(error_code& ec) noexcept
+		{
+			if (!this->chunk)
+				this->chunk = std::make_unique<char[]>(std::size_t(ASIO2_SEND_FILE_CHUNK_SIZE));
+
+			std::size_t n = static_cast<std::size_t>((std::min)(
+				this->remaining, std::uint64_t(ASIO2_SEND_FILE_CHUNK_SIZE)));
+
+			for (;;)
+			{
+			#if ASIO2_OS_WINDOWS
+				if (::_lseeki64(this->fd, static_cast<__int64>(this->offset), SEEK_SET) == -1)
+				{
+					ec = error_code(errno, asio::error::get_system_category());
+					return 0;
+				}
+				int r = ::_read(this->fd, this->chunk.get(), static_cast<unsigned int>(n));
+			#else
+				::ssize_t r = ::pread(this->fd, this->chunk.get(), n, static_cast<::off_t>(this->offset));
+			#endif
+
+				if (r >= 0)
+				{
+					ec.clear();
+					return static_cast<std::size_t>(r);
+				}
+
+				if (errno != EINTR)
+				{
+					ec = error_code(errno, asio::error::get_system_category());
+					return 0;
+				}
+			}
+		}
+	};
+
+	template<class derived_t, class args_t>
+	class tcp_send_file_cp
+	{
+	public:
+		/**
+		 * @brief constructor
+		 */
+		tcp_send_file_cp() noexcept {}
+
+		/**
+		 * @brief destructor
+		 */
+		~tcp_send_file_cp() = default;
+
+	public:
+		/**
+		 * @brief Asynchronous send the content of a file.
+		 * You can call this function on the communication thread and anywhere,it's multi thread safed.
+		 * The file is sent in the order of the other async_send calls. It is sent by sendfile
+		 * on linux with the plain socket, otherwise it is read by chunks and written to the stream.
+		 * The file content is sent as is, without the dgram head.
+		 * @param path - the file to be sent, it is opened in this function.
+		 * @param offset - the offset of the first byte to be sent.
+		 * @param length - the bytes to be sent, 0 means to the end of the file.
+		 * Callback signature : void() or void(std::size_t bytes_sent)
+		 */
+		template<class Callback>
+		inline typename std::enable_if_t<is_callable_v<Callback>, void> async_send_file(
+			const std::filesystem::path& path, std::uint64_t offset, std::uint64_t length, Callback&& fn)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			std::unique_ptr<send_file_state> state = std::make_unique<send_file_state>();
+
+			if (error_code ec = state->open(path); ec)
+			{
+				set_last_error(ec);
+				callback_helper::call(fn, 0);
+				return;
+			}
+
+			derive._post_send_file(std::move(state), offset, length, std::forward<Callback>(fn));
+		}
+
+		/**
+		 * @brief Asynchronous send the content of a file.
+		 * You can call this function on the communication thread and anywhere,it's multi thread safed.
+		 * @param fd - the file descriptor to be sent, it is not closed by this function, and it
+		 * must be kept open until the callback is called.
+		 * @param offset - the offset of the first byte to be sent.
+		 * @param length - the bytes to be sent, 0 means to the end of the file.
+		 * Callback signature : void() or void(std::size_t bytes_sent)
+		 */
+		template<class Callback>
+		inline typename std::enable_if_t<is_callable_v<Callback>, void> async_send_file(
+			int fd, std::uint64_t offset, std::uint64_t length, Callback&& fn)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			std::unique_ptr<send_file_state> state = std::make_unique<send_file_state>();
+
+			state->fd = fd;
+
+			derive._post_send_file(std::move(state), offset, length, std::forward<Callback>(fn));
+		}
+
+	protected:
+		template<class Callback>
+		inline void _post_send_file(std::unique_ptr<send_file_state> state,
+			std::uint64_t offset, std::uint64_t length, Callback&& fn)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			detail::integer_add_sub_guard asg(derive.io_->pending());
+
+			if (error_code ec = state->prepare(offset, length); ec)
+			{
+				set_last_error(ec);
+				callback_helper::call(fn, 0);
+				return;
+			}
+
+			derive.push_event(
+			[&derive, id = derive.life_id(), state = std::move(state), fn = std::forward<Callback>(fn)]
+			(event_queue_guard<derived_t> g) mutable
+			{
+				if (!derive.is_started())
+				{
+					set_last_error(asio::error::not_connected);
+					callback_helper::call(fn, 0);
+					return;
+				}
+
+				if (id != derive.life_id())
+				{
+					set_last_error(asio::error::operation_aborted);
+					callback_helper::call(fn, 0);
+					return;
+				}
+
+				clear_last_error();
+
+			#if defined(ASIO2_ENABLE_METRICS)
+				derive._metrics_send(1);
+			#endif
+
+				derive._tcp_send_file(std::move(state),
+				[&derive, fn = std::move(fn), g = std::move(g)](const error_code&, std::size_t bytes_sent) mutable
+				{
+					ASIO2_ASSERT(!g.is_empty());
+
+				#if defined(ASIO2_ENABLE_METRICS)
+					derive._metrics_sent(bytes_sent);
+				#else
+					detail::ignore_unused(derive);
+				#endif
+
+					callback_helper::call(fn, bytes_sent);
+				});
+			});
+		}
+
+		/**
+		 * @brief send the file, the callback is called with the total sent bytes when all the
+		 * bytes are sent or an error occurs, the connection is closed when an error occurs.
+		 */
+		template<class Callback>
+		inline bool _tcp_send_file(std::unique_ptr<send_file_state> state, Callback&& callback)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+		#if defined(_DEBUG) || defined(DEBUG)
+			ASIO2_ASSERT(derive.post_send_counter_.load() == 0);
+			derive.post_send_counter_++;
+		#endif
+
+		#if ASIO2_OS_LINUX
+			if constexpr (!std::is_base_of_v<ssl_stream_tag, derived_t>)
+			{
+				state->sendfile = true;
+			}
+		#endif
+
+			derive._tcp_send_file_some(std::move(state), std::forward<Callback>(callback));
+
+			return true;
+		}
+
+		template<class Callback>
+		inline void _tcp_send_file_some(std::unique_ptr<send_file_state> state, Callback&& callback)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			while (state->remaining > 0)
+			{
+			#if ASIO2_OS_LINUX
+				if (state->sendfile)
+				{
+					auto& sock = derive.socket();
+
+					error_code ec;
+
+					// the socket is non-blocking internally already if an asynchronous operation
+					// has been started on it, this makes the sendfile won't block the io thread.
+					if (!sock.native_non_blocking())
+						sock.native_non_blocking(true, ec);
+
+					::off_t off = static_cast<::off_t>(state->offset);
+
+					::ssize_t n = ::sendfile(sock.native_handle(), state->fd, &off, static_cast<std::size_t>(
+						(std::min)(state->remaining, std::uint64_t(0x7ffff000))));
+
+					if (n > 0)
+					{
+						state->offset    += static_cast<std::uint64_t>(n);
+						state->remaining -= static_cast<std::uint64_t>(n);
+						state->sent      += static_cast<std::size_t>(n);
+						continue;
+					}
+
+					if (n == 0)
+					{
+						// the file was truncated after the length was calculated.
+						derive._tcp_send_file_done(asio::error::eof, std::move(state), callback);
+						return;
+					}
+
+					if (errno == EINTR)
+						continue;
+
+					if (errno == EAGAIN || errno == EWOULDBLOCK)
+					{
+						sock.async_wait(asio::socket_base::wait_write, make_allocator(derive.wallocator(),
+						[&derive, state = std::move(state), callback = std::forward<Callback>(callback)]
+						(const error_code& ec) mutable
+						{
+							if (ec)
+							{
+								derive._tcp_send_file_done(ec, std::move(state), callback);
+								return;
+							}
+
+							derive._tcp_send_file_some(std::move(state), std::move(callback));
+						}));
+						return;
+					}
+
+					// the file don't support sendfile, eg: some special file systems, then read
+					// the file and write it to the stream.
+					if (state->sent == 0 && (errno == EINVAL || errno == ENOSYS || errno == EOPNOTSUPP))
+					{
+						state->sendfile = false;
+						continue;
+					}
+
+					derive._tcp_send_file_done(error_code(errno, asio::error::get_system_category()),
+						std::move(state), callback);
+					return;
+				}
+			#endif
+
+				error_code ec;
+
+				std::size_t n = state->read(ec);
+
+				if (ec || n == 0)
+				{
+					derive._tcp_send_file_done(ec ? ec : asio::error::eof, std::move(state), callback);
+					return;
+				}
+
+				asio::const_buffer buffer(state->chunk.get(), n);
+
+				asio::async_write(derive.stream(), buffer, make_allocator(derive.wallocator(),
+				[&derive, state = std::move(state), callback = std::forward<Callback>(callback)]
+				(const error_code& ec, std::size_t bytes_sent) mutable
+				{
+					state->offset    += bytes_sent;
+					state->remaining -= bytes_sent;
+					state->sent      += bytes_sent;
+
+					if (ec)
+					{
+						derive._tcp_send_file_done(ec, std::move(state), callback);
+						return;
+					}
+
+					derive._tcp_send_file_some(std::move(state), std::move(callback));
+				}));
+				return;
+			}
+
+			derive._tcp_send_file_done(error_code{}, std::move(state), callback);
+		}
+
+		template<class Callback>
+		inline void _tcp_send_file_done(
+			const error_code& ec, std::unique_ptr<send_file_state> state, Callback& callback)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+		#if defined(_DEBUG) || defined(DEBUG)
+			derive.post_send_counter_--;
+		#endif
+
+			std::size_t sent = state->sent;
+
+			// close the file before the callback is called.
+			state.reset();
+
+			set_last_error(ec);
+
+			callback(ec, sent);
+
+			if (ec)
+			{
+				// must stop, otherwise re-sending will cause body confusion
+				if (derive.state_ == state_t::started)
+				{
+					derive._do_disconnect(ec, derive.selfptr());
+				}
+			}
+		}
+	};
+}
+
+#endif // !__ASIO2_TCP_SEND_FILE_COMPONENT_HPP__
@@ -22,6 +22,8 @@
 
 #include <asio2/base/error.hpp>
 #include <asio2/base/detail/buffer_wrap.hpp>
+#include <asio2/base/detail/send_batch.hpp>
+#include <asio2/base/detail/shared_buffer.hpp>
 
 namespace asio2::detail
 {
@@ -39,6 +41,12 @@ namespace asio2::detail
 		//struct has_member_dgram<T, std::void_t<decltype(T::dgram_), std::enable_if_t<
 		//	std::is_same_v<decltype(T::dgram_), bool>>>> : std::true_type {};
 
+		template<class, class = std::void_t<>>
+		struct has_member_zerocopy : std::false_type {};
+
+		template<class T>
+		struct has_member_zerocopy<T, std::void_t<decltype(T::zerocopy_enabled_)>> : std::true_type {};
+
 	public:
 		/**
 		 * @brief constructor
@@ -68,57 +76,80 @@ namespace asio2::detail
 				std::ignore = true;
 			}
 
+			// only the data which memory can be taken over without copying is sent by zero copy,
+			// the "data" is owned by the send event, and it is not used after the _tcp_send.
+			if constexpr (has_member_zerocopy<derived_t>::value && (
+				std::is_same_v<detail::remove_cvref_t<Data>, asio2::shared_buffer> ||
+				detail::is_template_instance_of_v<std::basic_string, detail::remove_cvref_t<Data>> ||
+				detail::is_template_instance_of_v<std::vector      , detail::remove_cvref_t<Data>>))
+			{
+				if (derive._tcp_zerocopy_admit(asio::buffer(data).size()))
+				{
+					return derive._tcp_send_zerocopy(asio2::shared_buffer(std::move(data)),
+						std::forward<Callback>(callback));
+				}
+			}
+			else
+			{
+				std::ignore = true;
+			}
+
 			return derive._tcp_send_general(asio::buffer(data), std::forward<Callback>(callback));
 		}
 
-		template<class Buffer, class Callback>
-		inline bool _tcp_send_dgram(Buffer&& buffer, Callback&& callback)
+		/**
+		 * @brief write the dgram head of the data into the "head", return the head bytes.
+		 * the "head" must has 9 bytes at least.
+		 */
+		inline int _tcp_make_dgram_head(std::size_t data_size, std::uint8_t* head) noexcept
 		{
-			derived_t& derive = static_cast<derived_t&>(*this);
-
-			int bytes = 0;
-			std::unique_ptr<std::uint8_t[]> head;
-
-			// why don't use std::string for "head"?
-			// beacuse std::string has a SSO(Small String Optimization) mechanism
-			// https://stackoverflow.com/questions/34788789/disable-stdstrings-sso
-			// std::string str;
-			// str.reserve(sizeof(str) + 1);
-
 			// note : need ensure big endian and little endian
-			if (buffer.size() < std::size_t(254))
+			if (data_size < std::size_t(254))
 			{
-				bytes = 1;
-				head = std::make_unique<std::uint8_t[]>(bytes);
-				head[0] = static_cast<std::uint8_t>(buffer.size());
+				head[0] = static_cast<std::uint8_t>(data_size);
+				return 1;
 			}
-			else if (buffer.size() <= (std::numeric_limits<std::uint16_t>::max)())
+			else if (data_size <= (std::numeric_limits<std::uint16_t>::max)())
 			{
-				bytes = 3;
-				head = std::make_unique<std::uint8_t[]>(bytes);
 				head[0] = static_cast<std::uint8_t>(254);
-				std::uint16_t size = static_cast<std::uint16_t>(buffer.size());
+				std::uint16_t size = static_cast<std::uint16_t>(data_size);
 				std::memcpy(&head[1], reinterpret_cast<const void*>(&size), sizeof(std::uint16_t));
 				// use little endian
 				if (!is_little_endian())
 				{
 					swap_bytes<sizeof(std::uint16_t)>(&head[1]);
 				}
+				return 3;
 			}
 			else
 			{
-				ASIO2_ASSERT(buffer.size() > (std::numeric_limits<std::uint16_t>::max)());
-				bytes = 9;
-				head = std::make_unique<std::uint8_t[]>(bytes);
+				ASIO2_ASSERT(data_size > (std::numeric_limits<std::uint16_t>::max)());
 				head[0] = static_cast<std::uint8_t>(255);
-				std::uint64_t size = buffer.size();
+				std::uint64_t size = data_size;
 				std::memcpy(&head[1], reinterpret_cast<const void*>(&size), sizeof(std::uint64_t));
 				// use little endian
 				if (!is_little_endian())
 				{
 					swap_bytes<sizeof(std::uint64_t)>(&head[1]);
 				}
+				return 9;
 			}
+		}
+
+		template<class Buffer, class Callback>
+		inline bool _tcp_send_dgram(Buffer&& buffer, Callback&& callback)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			// why don't use std::string for "head"?
+			// beacuse std::string has a SSO(Small String Optimization) mechanism
+			// https://stackoverflow.com/questions/34788789/disable-stdstrings-sso
+			// std::string str;
+			// str.reserve(sizeof(str) + 1);
+
+			std::unique_ptr<std::uint8_t[]> head = std::make_unique<std::uint8_t[]>(9);
+
+			int bytes = derive._tcp_make_dgram_head(buffer.size(), head.get());
 
 			std::array<asio::const_buffer, 2> buffers
 			{
@@ -131,6 +162,10 @@ namespace asio2::detail
 			derive.post_send_counter_++;
 		#endif
 
+		#if defined(ASIO2_ENABLE_METRICS)
+			derive._metrics_send(1);
+		#endif
+
 			asio::async_write(derive.stream(), buffers, make_allocator(derive.wallocator(),
 			[&derive, bytes, head = std::move(head), callback = std::forward<Callback>(callback)]
 			(const error_code& ec, std::size_t bytes_sent) mutable
@@ -153,6 +188,10 @@ namespace asio2::detail
 				}
 				else
 				{
+				#if defined(ASIO2_ENABLE_METRICS)
+					derive._metrics_sent(bytes_sent);
+				#endif
+
 					callback(ec, bytes_sent - bytes);
 				}
 			}));
@@ -169,6 +208,10 @@ namespace asio2::detail
 			derive.post_send_counter_++;
 		#endif
 
+		#if defined(ASIO2_ENABLE_METRICS)
+			derive._metrics_send(1);
+		#endif
+
 			asio::async_write(derive.stream(), buffer, make_allocator(derive.wallocator(),
 			[&derive, callback = std::forward<Callback>(callback)]
 			(const error_code& ec, std::size_t bytes_sent) mutable
@@ -179,6 +222,124 @@ namespace asio2::detail
 
 				set_last_error(ec);
 
+			#if defined(ASIO2_ENABLE_METRICS)
+				derive._metrics_sent(bytes_sent);
+			#endif
+
+				callback(ec, bytes_sent);
+
+				if (ec)
+				{
+					// must stop, otherwise re-sending will cause body confusion
+					if (derive.state_ == state_t::started)
+					{
+						derive._do_disconnect(ec, derive.selfptr());
+					}
+				}
+			}));
+			return true;
+		}
+
+		/**
+		 * @brief send all the datas of the batch with a single gather write.
+		 * the bytes_sent passed to the callback contains the dgram head bytes.
+		 */
+		template<class Callback>
+		inline bool _tcp_send_batch(send_batch& batch, Callback&& callback)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			bool dgram = false;
+
+			if constexpr (has_member_dgram<derived_t>::value)
+			{
+				dgram = derive.dgram_;
+			}
+			else
+			{
+				std::ignore = true;
+			}
+
+			batch.buffers.clear();
+			batch.scratch.clear();
+
+			// the ssl stream only encrypt the first non-empty buffer of the buffer sequence at
+			// each write_some, so the datas must be linearized, otherwise each data will be
+			// encrypted into a standalone record and written with a standalone syscall.
+			if constexpr (std::is_base_of_v<ssl_stream_tag, derived_t>)
+			{
+				batch.scratch.reserve(batch.total_bytes + (dgram ? batch.entries.size() * 9 : 0));
+
+				for (send_batch::entry& e : batch.entries)
+				{
+					asio::const_buffer data = e.buffer();
+
+					if (dgram)
+					{
+						std::uint8_t head[9];
+						e.head_size = derive._tcp_make_dgram_head(data.size(), head);
+						batch.scratch.append(reinterpret_cast<const char*>(head), e.head_size);
+					}
+
+					batch.scratch.append(reinterpret_cast<const char*>(data.data()), data.size());
+				}
+
+				batch.buffers.emplace_back(asio::buffer(batch.scratch));
+			}
+			else
+			{
+				// must reserve the scratch, otherwise the head buffers will be invalid when the
+				// scratch is reallocated.
+				if (dgram)
+				{
+					batch.scratch.reserve(batch.entries.size() * 9);
+					batch.buffers.reserve(batch.entries.size() * 2);
+				}
+				else
+				{
+					batch.buffers.reserve(batch.entries.size());
+				}
+
+				for (send_batch::entry& e : batch.entries)
+				{
+					asio::const_buffer data = e.buffer();
+
+					if (dgram)
+					{
+						std::size_t offset = batch.scratch.size();
+						std::uint8_t head[9];
+						e.head_size = derive._tcp_make_dgram_head(data.size(), head);
+						batch.scratch.append(reinterpret_cast<const char*>(head), e.head_size);
+						batch.buffers.emplace_back(batch.scratch.data() + offset, e.head_size);
+					}
+
+					batch.buffers.emplace_back(data);
+				}
+			}
+
+		#if defined(_DEBUG) || defined(DEBUG)
+			ASIO2_ASSERT(derive.post_send_counter_.load() == 0);
+			derive.post_send_counter_++;
+		#endif
+
+		#if defined(ASIO2_ENABLE_METRICS)
+			derive._metrics_send(batch.entries.size());
+		#endif
+
+			asio::async_write(derive.stream(), batch.view(), make_allocator(derive.wallocator(),
+			[&derive, callback = std::forward<Callback>(callback)]
+			(const error_code& ec, std::size_t bytes_sent) mutable
+			{
+			#if defined(_DEBUG) || defined(DEBUG)
+				derive.post_send_counter_--;
+			#endif
+
+				set_last_error(ec);
+
+			#if defined(ASIO2_ENABLE_METRICS)
+				derive._metrics_sent(bytes_sent);
+			#endif
+
 				callback(ec, bytes_sent);
 
 				if (ec)
@@ -0,0 +1,429 @@
+/*
+ * Copyright (c) 2017-2023 zhllxt
+ *
+ * author   : zhllxt
+ * email    : 37792738@qq.com
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See accompanying
+ * file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#ifndef __ASIO2_TCP_SEND_ZEROCOPY_COMPONENT_HPP__
+#define __ASIO2_TCP_SEND_ZEROCOPY_COMPONENT_HPP__
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <utility>
+
+#include <asio2/external/predef.h>
+
+#include <asio2/base/error.hpp>
+#include <asio2/base/detail/buffer_wrap.hpp>
+#include <asio2/base/detail/shared_buffer.hpp>
+
+#if ASIO2_OS_LINUX
+#	include <sys/types.h>
+#	include <sys/socket.h>
+#	include <netinet/in.h>
+#	include <linux/errqueue.h>
+#	if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY) && defined(SO_EE_ORIGIN_ZEROCOPY)
+#		define ASIO2_HAS_SEND_ZEROCOPY 1
+#	endif
+#endif
+
+/*
+ * the data which is less than this bytes is sent by the normal way when the zero copy send is
+ * enabled, the cost of pinning the pages and reading the notifications is larger than the cost
+ * of copying for the small datas.
+ */
+#ifndef ASIO2_SEND_ZEROCOPY_THRESHOLD
+#define ASIO2_SEND_ZEROCOPY_THRESHOLD (16 * 1024)
+#endif
+
+namespace asio2::detail
+{
+	template<class derived_t, class args_t>
+	class tcp_send_zerocopy_cp
+	{
+	public:
+		/**
+		 * @brief constructor
+		 */
+		tcp_send_zerocopy_cp() noexcept {}
+
+		/**
+		 * @brief destructor
+		 */
+		~tcp_send_zerocopy_cp() = default;
+
+	public:
+		/**
+		 * @brief set whether send the large datas with MSG_ZEROCOPY.
+		 * When enabled, the data which is not less than the threshold is sent from its own memory
+		 * without copying into the kernel, and the data is kept alive until the kernel notifies
+		 * that the pages are released through the socket error queue. The callback of async_send
+		 * is still called as soon as the data has been written to the socket.
+		 * Only the plain tcp session and client on linux in general mode support it, for the
+		 * others (ssl, rate limit, dgram mode, other platforms) this option is ignored. And only the data of
+		 * std::string, std::vector and asio2::shared_buffer is sent with MSG_ZEROCOPY, because
+		 * its memory can be taken over without copying, the others are sent by the normal way.
+		 * If the kernel reports that it had to copy the data (eg: the loopback device), the
+		 * connection turns back to the normal way for the rest of its lifetime.
+		 * Note : this option is ignored when the send coalesce is enabled.
+		 * @param threshold - the data which is less than this bytes is sent by the normal way.
+		 */
+		inline derived_t& set_send_zerocopy(bool enabled,
+			std::size_t threshold = std::size_t(ASIO2_SEND_ZEROCOPY_THRESHOLD)) noexcept
+		{
+			this->zerocopy_enabled_   = enabled;
+			this->zerocopy_threshold_ = threshold;
+			return static_cast<derived_t&>(*this);
+		}
+
+		/**
+		 * @brief get whether send the large datas with MSG_ZEROCOPY.
+		 */
+		inline bool is_send_zerocopy() const noexcept
+		{
+			return this->zerocopy_enabled_;
+		}
+
+		/**
+		 * @brief get the bytes below which the data is sent by the normal way.
+		 */
+		inline std::size_t get_send_zerocopy_threshold() const noexcept
+		{
+			return this->zerocopy_threshold_;
+		}
+
+	protected:
+		/**
+		 * @brief check whether the data of this bytes should be sent with MSG_ZEROCOPY, the
+		 * SO_ZEROCOPY is enabled on the socket at the first time.
+		 */
+		inline bool _tcp_zerocopy_admit(std::size_t bytes) noexcept
+		{
+		#if defined(ASIO2_HAS_SEND_ZEROCOPY)
+			// the ssl stream must encrypt the data, and the rate limited stream must be written
+			// through the stream, so only the plain socket can be written directly.
+			if constexpr (std::is_base_of_v<ssl_stream_tag, derived_t> ||
+				!std::is_same_v<typename args_t::socket_t, asio::ip::tcp::socket>)
+			{
+				detail::ignore_unused(bytes);
+				return false;
+			}
+			else
+			{
+				derived_t& derive = static_cast<derived_t&>(*this);
+
+				if (!this->zerocopy_enabled_ || bytes == 0 || bytes < this->zerocopy_threshold_)
+					return false;
+
+				if (this->zerocopy_mode_ == zerocopy_mode::unknown)
+				{
+					// the buffers of the previous connection can be released now, the notification
+					// ids are counted from 0 for each socket.
+					this->zerocopy_pending_.clear();
+					this->zerocopy_next_id_ = 0;
+
+					int enable = 1;
+
+					if (::setsockopt(derive.socket().lowest_layer().native_handle(), SOL_SOCKET, SO_ZEROCOPY,
+						reinterpret_cast<const void*>(&enable), socklen_t(sizeof(enable))) == 0)
+						this->zerocopy_mode_ = zerocopy_mode::enabled;
+					else
+						this->zerocopy_mode_ = zerocopy_mode::disabled;
+				}
+
+				return (this->zerocopy_mode_ == zerocopy_mode::enabled);
+			}
+		#else
+			detail::ignore_unused(bytes);
+			return false;
+		#endif
+		}
+
+		/**
+		 * @brief send the data with MSG_ZEROCOPY, the callback is called when all the bytes are
+		 * written or an error occurs, and the data is kept until the kernel has released it.
+		 */
+		template<class Callback>
+		inline bool _tcp_send_zerocopy(asio2::shared_buffer data, Callback&& callback)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+		#if defined(_DEBUG) || defined(DEBUG)
+			ASIO2_ASSERT(derive.post_send_counter_.load() == 0);
+			derive.post_send_counter_++;
+		#endif
+
+		#if defined(ASIO2_ENABLE_METRICS)
+			derive._metrics_send(1);
+		#endif
+
+			derive._tcp_send_zerocopy_some(std::move(data), 0, std::forward<Callback>(callback));
+
+			return true;
+		}
+
+		template<class Callback>
+		inline void _tcp_send_zerocopy_some(asio2::shared_buffer data, std::size_t sent, Callback&& callback)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+		#if defined(ASIO2_HAS_SEND_ZEROCOPY)
+			auto& sock = derive.socket().lowest_layer();
+
+			error_code ec;
+
+			// the socket is non-blocking internally already if an asynchronous operation
+			// has been started on it, this makes the send won't block the io thread.
+			if (!sock.native_non_blocking())
+				sock.native_non_blocking(true, ec);
+
+			const char* p = static_cast<const char*>(data.data());
+
+			int flags = MSG_NOSIGNAL | MSG_ZEROCOPY;
+
+			while (sent < data.size())
+			{
+				::ssize_t n = ::send(sock.native_handle(), p + sent, data.size() - sent, flags);
+
+				if (n > 0)
+				{
+					sent += static_cast<std::size_t>(n);
+
+					// each successful send with MSG_ZEROCOPY takes a notification id, the data
+					// must be kept until the notification of its last id is received.
+					if (flags & MSG_ZEROCOPY)
+					{
+						std::uint32_t id = this->zerocopy_next_id_++;
+
+						if (!this->zerocopy_pending_.empty() && this->zerocopy_pending_.back().second.data() == p)
+							this->zerocopy_pending_.back().first = id;
+						else
+							this->zerocopy_pending_.emplace_back(id, data);
+					}
+					continue;
+				}
+
+				if (n < 0 && errno == EINTR)
+					continue;
+
+				if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+				{
+					sock.async_wait(asio::socket_base::wait_write, make_allocator(derive.wallocator(),
+					[&derive, data = std::move(data), sent, callback = std::forward<Callback>(callback)]
+					(const error_code& ec) mutable
+					{
+						if (ec)
+						{
+							derive._tcp_send_zerocopy_done(ec, sent, callback);
+							return;
+						}
+
+						derive._tcp_send_zerocopy_some(std::move(data), sent, std::move(callback));
+					}));
+					return;
+				}
+
+				// the socket exceeds the optmem limit for the notifications, send the rest of
+				// the data by copying.
+				if (n < 0 && errno == ENOBUFS && (flags & MSG_ZEROCOPY))
+				{
+					flags &= ~MSG_ZEROCOPY;
+					continue;
+				}
+
+				derive._tcp_send_zerocopy_done(n < 0 ?
+					error_code(errno, asio::error::get_system_category()) :
+					error_code(asio::error::eof), sent, callback);
+				return;
+			}
+
+			derive._tcp_send_zerocopy_done(error_code{}, sent, callback);
+
+			derive._tcp_zerocopy_reap();
+			derive._tcp_zerocopy_post_wait();
+		#else
+			// never reached, the _tcp_zerocopy_admit always return false on this platform.
+			asio::async_write(derive.stream(), data.buffer(), make_allocator(derive.wallocator(),
+			[&derive, data, sent, callback = std::forward<Callback>(callback)]
+			(const error_code& ec, std::size_t bytes_sent) mutable
+			{
+				derive._tcp_send_zerocopy_done(ec, sent + bytes_sent, callback);
+			}));
+		#endif
+		}
+
+		template<class Callback>
+		inline void _tcp_send_zerocopy_done(const error_code& ec, std::size_t sent, Callback& callback)
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+		#if defined(_DEBUG) || defined(DEBUG)
+			derive.post_send_counter_--;
+		#endif
+
+			set_last_error(ec);
+
+		#if defined(ASIO2_ENABLE_METRICS)
+			derive._metrics_sent(sent);
+		#endif
+
+			callback(ec, sent);
+
+			if (ec)
+			{
+				// must stop, otherwise re-sending will cause body confusion
+				if (derive.state_ == state_t::started)
+				{
+					derive._do_disconnect(ec, derive.selfptr());
+				}
+			}
+		}
+
+		/**
+		 * @brief read all the notifications from the socket error queue, and release the datas
+		 * which the kernel don't reference anymore.
+		 */
+		inline void _tcp_zerocopy_reap() noexcept
+		{
+		#if defined(ASIO2_HAS_SEND_ZEROCOPY)
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			for (;;)
+			{
+				char control[128];
+
+				::msghdr msg{};
+				msg.msg_control    = control;
+				msg.msg_controllen = sizeof(control);
+
+				if (::recvmsg(derive.socket().lowest_layer().native_handle(), &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+				{
+					if (errno == EINTR)
+						continue;
+
+					break;
+				}
+
+				for (::cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm))
+				{
+					if (!(cm->cmsg_level == IPPROTO_IP   && cm->cmsg_type == IP_RECVERR) &&
+						!(cm->cmsg_level == IPPROTO_IPV6 && cm->cmsg_type == IPV6_RECVERR))
+						continue;
+
+					::sock_extended_err serr;
+					std::memcpy(reinterpret_cast<void*>(&serr), CMSG_DATA(cm), sizeof(serr));
+
+					if (serr.ee_errno != 0 || serr.ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+						continue;
+
+					// the notification is a range of ids [ee_info, ee_data], and the notifications
+					// of a tcp socket are in order, so the datas before ee_data are released too.
+					while (!this->zerocopy_pending_.empty() &&
+						std::int32_t(this->zerocopy_pending_.front().first - serr.ee_data) <= 0)
+					{
+						this->zerocopy_pending_.pop_front();
+					}
+
+					// the kernel copied the data, eg: the loopback device, the zero copy only has
+					// extra cost for this connection.
+					if (serr.ee_code & SO_EE_CODE_ZEROCOPY_COPIED)
+					{
+						this->zerocopy_mode_ = zerocopy_mode::copied;
+					}
+				}
+			}
+		#endif
+		}
+
+		/**
+		 * @brief wait for the notifications while there are datas which are referenced by the kernel.
+		 */
+		inline void _tcp_zerocopy_post_wait()
+		{
+		#if defined(ASIO2_HAS_SEND_ZEROCOPY)
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			if (this->zerocopy_waiting_ || this->zerocopy_pending_.empty())
+				return;
+
+			if (!derive.socket().lowest_layer().is_open())
+				return;
+
+			this->zerocopy_waiting_ = true;
+
+			derive.socket().lowest_layer().async_wait(asio::socket_base::wait_error, make_allocator(derive.wallocator(),
+			[&derive, this_ptr = derive.selfptr(), epoch = this->zerocopy_epoch_](const error_code& ec) mutable
+			{
+				detail::ignore_unused(this_ptr);
+
+				// the connection is closed already, and the state may belong to a new connection.
+				if (epoch != derive.zerocopy_epoch_)
+					return;
+
+				derive.zerocopy_waiting_ = false;
+
+				if (ec)
+					return;
+
+				derive._tcp_zerocopy_reap();
+				derive._tcp_zerocopy_post_wait();
+			}));
+		#endif
+		}
+
+		/**
+		 * @brief called when the connection is closed.
+		 * The pending datas are not released here, because the kernel may still send the queued
+		 * bytes after the socket is closed, they are released when the next connection sends
+		 * with MSG_ZEROCOPY at the first time or this object is destroyed.
+		 */
+		inline void _tcp_zerocopy_stop() noexcept
+		{
+			derived_t& derive = static_cast<derived_t&>(*this);
+
+			if (!this->zerocopy_pending_.empty() && derive.socket().lowest_layer().is_open())
+				derive._tcp_zerocopy_reap();
+
+			this->zerocopy_mode_    = zerocopy_mode::unknown;
+			this->zerocopy_waiting_ = false;
+			this->zerocopy_epoch_++;
+		}
+
+	protected:
+		enum class zerocopy_mode : std::uint8_t
+		{
+			unknown,  // the SO_ZEROCOPY is not set on the socket yet
+			enabled,  // the SO_ZEROCOPY is set
+			disabled, // the SO_ZEROCOPY is not supported
+			copied,   // the kernel copied the data, so the MSG_ZEROCOPY is not used anymore
+		};
+
+		bool                                                   zerocopy_enabled_   = false;
+
+		zerocopy_mode                                          zerocopy_mode_      = zerocopy_mode::unknown;
+
+		bool                                                   zerocopy_waiting_   = false;
+
+		std::size_t                                            zerocopy_threshold_ = ASIO2_SEND_ZEROCOPY_THRESHOLD;
+
+		/// the notification id of the next successful send with MSG_ZEROCOPY
+		std::uint32_t                                          zerocopy_next_id_   = 0;
+
+		/// used to discard the wait of the notifications of the previous connection
+		std::uint32_t                                          zerocopy_epoch_     = 0;
+
+		/// the datas which are referenced by the kernel, with the notification id of its last send
+		std::deque<std::pair<std::uint32_t, asio2::shared_buffer>> zerocopy_pending_;
+	};
+}
+
+#endif // !__ASIO2_TCP_SEND_ZEROCOPY_COMPONENT_HPP__
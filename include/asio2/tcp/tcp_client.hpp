@@ -18,9 +18,12 @@
 #include <asio2/base/detail/push_options.hpp>
 
 #include <asio2/base/client.hpp>
+#include <asio2/base/impl/async_recv_cp.hpp>
 
 #include <asio2/tcp/impl/tcp_keepalive_cp.hpp>
 #include <asio2/tcp/impl/tcp_send_op.hpp>
+#include <asio2/tcp/impl/tcp_send_file_cp.hpp>
+#include <asio2/tcp/impl/tcp_send_zerocopy_cp.hpp>
 #include <asio2/tcp/impl/tcp_recv_op.hpp>
 
 namespace asio2::detail
@@ -46,7 +49,10 @@ namespace asio2::detail
 		: public client_impl_t         <derived_t, args_t>
 		, public tcp_keepalive_cp      <derived_t, args_t>
 		, public tcp_send_op           <derived_t, args_t>
+		, public tcp_send_file_cp      <derived_t, args_t>
+		, public tcp_send_zerocopy_cp  <derived_t, args_t>
 		, public tcp_recv_op           <derived_t, args_t>
+		, public async_recv_cp         <derived_t, args_t>
 		, public tcp_tag
 	{
 		ASIO2_CLASS_FRIEND_DECLARE_BASE;
@@ -74,6 +80,8 @@ namespace asio2::detail
 			: super(init_buf_size, max_buf_size, concurrency)
 			, tcp_keepalive_cp<derived_t, args_t>()
 			, tcp_send_op     <derived_t, args_t>()
+			, tcp_send_file_cp<derived_t, args_t>()
+			, tcp_send_zerocopy_cp<derived_t, args_t>()
 			, tcp_recv_op     <derived_t, args_t>()
 		{
 			this->set_connect_timeout(std::chrono::milliseconds(tcp_connect_timeout));
@@ -88,6 +96,8 @@ namespace asio2::detail
 			: super(init_buf_size, max_buf_size, std::forward<Scheduler>(scheduler))
 			, tcp_keepalive_cp<derived_t, args_t>()
 			, tcp_send_op     <derived_t, args_t>()
+			, tcp_send_file_cp<derived_t, args_t>()
+			, tcp_send_zerocopy_cp<derived_t, args_t>()
 			, tcp_recv_op     <derived_t, args_t>()
 		{
 			this->set_connect_timeout(std::chrono::milliseconds(tcp_connect_timeout));
@@ -156,13 +166,23 @@ namespace asio2::detail
 		 * function:std::pair<iterator, bool> match_condition(iterator begin, iterator end),
 		 * asio::transfer_at_least,asio::transfer_exactly
 		 * more details see asio::read_until
+		 * The last one of the args can be a completion token, eg: asio::use_awaitable, then it
+		 * returns an awaitable which completes with void(asio::error_code ec) when connected.
 		 */
 		template<typename String, typename StrOrInt, typename... Args>
-		inline bool async_start(String&& host, StrOrInt&& port, Args&&... args)
+		inline auto async_start(String&& host, StrOrInt&& port, Args&&... args)
 		{
-			return this->derived().template _do_connect<true>(
-				std::forward<String>(host), std::forward<StrOrInt>(port),
-				ecs_helper::make_ecs(asio::transfer_at_least(1), std::forward<Args>(args)...));
+			if constexpr (detail::is_last_awaitable_token_v<Args...>)
+			{
+				return this->derived()._async_start_with_token(
+					std::forward<String>(host), std::forward<StrOrInt>(port), std::forward<Args>(args)...);
+			}
+			else
+			{
+				return this->derived().template _do_connect<true>(
+					std::forward<String>(host), std::forward<StrOrInt>(port),
+					ecs_helper::make_ecs(asio::transfer_at_least(1), std::forward<Args>(args)...));
+			}
 		}
 
 		/**
@@ -300,6 +320,25 @@ namespace asio2::detail
 			return (this->derived());
 		}
 
+		/**
+		 * @brief bind send pressure listener
+		 * @param fun - a user defined callback function.
+		 * @param obj - a pointer or reference to a class object, this parameter can be none.
+		 * @li if fun is nonmember function, the obj param must be none, otherwise the obj must be the
+		 * the class object's pointer or reference.
+		 * This notification is called when the queued sends exceed the high watermark (paused is
+		 * true), and when they fall to the low watermark again (paused is false), see
+		 * set_send_watermark and set_send_watermark_count.
+		 * Function signature : void(bool paused)
+		 */
+		template<class F, class ...C>
+		inline derived_t & bind_send_pressure(F&& fun, C&&... obj)
+		{
+			this->listener_.bind(event_type::send_pressure,
+				observer_t<bool>(std::forward<F>(fun), std::forward<C>(obj)...));
+			return (this->derived());
+		}
+
 		/**
 		 * @brief bind init listener,we should set socket options at here
 		 * @param fun - a user defined callback function.
@@ -351,9 +390,15 @@ namespace asio2::detail
 			// use derfer to ensure the promise's value must be seted.
 			detail::defer_event pg
 			{
-				[promise = std::move(promise)]() mutable
+				[promise = std::move(promise), handler = std::move(this->start_handler_)]() mutable
 				{
-					promise.set_value(get_last_error());
+					error_code ec = get_last_error();
+
+					// the completion handler of the async_start which is called with a completion token.
+					if (handler)
+						handler(ec);
+
+					promise.set_value(ec);
 				}
 			};
 
@@ -486,6 +531,10 @@ namespace asio2::detail
 
 			this->derived()._rdc_stop();
 
+			this->derived()._tcp_zerocopy_stop();
+
+			this->derived()._async_recv_stop(ec);
+
 			// should we close the socket in handle disconnect function? otherwise when send
 			// data failed, will cause the _do_disconnect function be called, then cause the
 			// auto reconnect executed, and then the _post_recv will be return with some error,
@@ -602,6 +651,12 @@ namespace asio2::detail
 			return this->derived()._tcp_send(data, std::forward<Callback>(callback));
 		}
 
+		template<class Callback>
+		inline bool _do_send_batch(send_batch& batch, Callback&& callback)
+		{
+			return this->derived()._tcp_send_batch(batch, std::forward<Callback>(callback));
+		}
+
 		template<class Data>
 		inline send_data_t _rdc_convert_to_send_data(Data& data) noexcept
 		{
@@ -662,6 +717,8 @@ namespace asio2::detail
 
 			this->listener_.notify(event_type::recv, data);
 
+			this->derived()._async_recv_notify(data);
+
 			this->derived()._rdc_handle_recv(this_ptr, ecs, data);
 		}
 
@@ -18,8 +18,13 @@
 #include <asio2/base/detail/push_options.hpp>
 
 #include <asio2/base/server.hpp>
+#include <asio2/base/detail/reuse_port.hpp>
 #include <asio2/tcp/tcp_session.hpp>
 
+#ifndef ASIO2_MAX_ACCEPT_BATCH
+#define ASIO2_MAX_ACCEPT_BATCH 64
+#endif
+
 namespace asio2::detail
 {
 	ASIO2_CLASS_FORWARD_DECLARE_BASE;
@@ -161,6 +166,7 @@ namespace asio2::detail
 			derive.counter_timer_.reset();
 			derive.acceptor_timer_.reset();
 			derive.acceptor_.reset();
+			derive.reuse_acceptors_.clear();
 
 			super::destroy();
 		}
@@ -306,6 +312,26 @@ namespace asio2::detail
 			return (this->derived());
 		}
 
+		/**
+		 * @brief bind send pressure listener
+		 * @param fun - a user defined callback function.
+		 * @param obj - a pointer or reference to a class object, this parameter can be none.
+		 * @li if fun is nonmember function, the obj param must be none, otherwise the obj must be the
+		 * the class object's pointer or reference.
+		 * This notification is called when the queued sends of a session exceed the high watermark
+		 * (paused is true), and when they fall to the low watermark again (paused is false), see
+		 * set_send_watermark and set_send_watermark_count.
+		 * Function signature : void(std::shared_ptr<asio2::tcp_session>& session_ptr, bool paused)
+		 */
+		template<class F, class ...C>
+		inline derived_t & bind_send_pressure(F&& fun, C&&... obj)
+		{
+			this->listener_.bind(event_type::send_pressure,
+				observer_t<std::shared_ptr<session_t>&, bool>(
+					std::forward<F>(fun), std::forward<C>(obj)...));
+			return (this->derived());
+		}
+
 	public:
 		/**
 		 * @brief get the acceptor reference
@@ -317,6 +343,130 @@ namespace asio2::detail
 		 */
 		inline asio::ip::tcp::acceptor const& acceptor() const noexcept { return *(this->acceptor_); }
 
+		/**
+		 * @brief enable or disable the multi acceptors mode, must be called before start.
+		 * In this mode, each iopool thread except the thread 0 opens its own SO_REUSEPORT acceptor,
+		 * and accepts the connections into its own io_context, the kernel distributes the new
+		 * connections to the acceptors, so the thread 0 is no longer the accept bottleneck.
+		 * The acceptor() is still bound to the address, but it don't listen in this mode.
+		 * The accept/connect/disconnect notifications are still called in the thread 0.
+		 * If the iopool has only one thread or SO_REUSEPORT is not supported, this mode is ignored.
+		 */
+		inline derived_t& set_reuse_port(bool enabled) noexcept
+		{
+			this->reuse_port_ = enabled;
+			return (this->derived());
+		}
+
+		/**
+		 * @brief check whether the multi acceptors mode is enabled.
+		 */
+		inline bool is_reuse_port() const noexcept
+		{
+			return this->reuse_port_;
+		}
+
+		/**
+		 * @brief enable or disable the buffer pool mode, must be called before start.
+		 * In this mode, when a session has no pending data, it releases its receive buffer to the
+		 * buffer pool of its io_context and waits for the socket to become readable without a
+		 * buffer, then borrows the memory from the pool to read and parse, so the idle sessions
+		 * hold no receive buffer. The pool returns the memory of a traffic spike to the system,
+		 * see ASIO2_BUFFER_POOL_MAX_BYTES.
+		 * It works with the plain tcp sessions only, the ssl, http and websocket sessions ignore it.
+		 */
+		inline derived_t& set_buffer_pool(bool enabled) noexcept
+		{
+			this->buffer_pool_ = enabled;
+			return (this->derived());
+		}
+
+		/**
+		 * @brief check whether the buffer pool mode is enabled.
+		 */
+		inline bool is_buffer_pool() const noexcept
+		{
+			return this->buffer_pool_;
+		}
+
+		/**
+		 * @brief enable or disable the recv chunk mode, must be called before start.
+		 * In this mode, the sessions receive the data into the memory blocks of the buffer pool of
+		 * its io_context, then the session_ptr->get_recv_chunk() in the recv callback returns the
+		 * data as a ref-counted asio2::recv_chunk without a copy, the chunk can be kept and
+		 * processed asynchronously, and the session reads the next data into a new block.
+		 * If this mode is disabled, the get_recv_chunk() copies the data.
+		 * It works with the tcp based sessions which use the tcp receive operation, the http and
+		 * websocket sessions ignore it, and the hook_buffer condition is not supported.
+		 */
+		inline derived_t& set_recv_chunk(bool enabled) noexcept
+		{
+			this->recv_chunk_ = enabled;
+			return (this->derived());
+		}
+
+		/**
+		 * @brief check whether the recv chunk mode is enabled.
+		 */
+		inline bool is_recv_chunk() const noexcept
+		{
+			return this->recv_chunk_;
+		}
+
+		/**
+		 * @brief set the high and low watermark of the bytes of the queued sends of each session,
+		 * must be called before start. see bind_send_pressure.
+		 */
+		inline derived_t& set_send_watermark(std::size_t high_bytes, std::size_t low_bytes) noexcept
+		{
+			ASIO2_ASSERT(low_bytes <= high_bytes);
+
+			this->send_high_bytes_ = high_bytes;
+			this->send_low_bytes_  = (std::min)(low_bytes, high_bytes);
+			this->send_pressure_   = true;
+			return (this->derived());
+		}
+
+		/**
+		 * @brief set the high and low watermark of the count of the queued sends of each session,
+		 * must be called before start. see bind_send_pressure.
+		 */
+		inline derived_t& set_send_watermark_count(std::size_t high_count, std::size_t low_count) noexcept
+		{
+			ASIO2_ASSERT(low_count <= high_count);
+
+			this->send_high_count_ = high_count;
+			this->send_low_count_  = (std::min)(low_count, high_count);
+			this->send_pressure_   = true;
+			return (this->derived());
+		}
+
+		/**
+		 * @brief set the max bytes of the queued sends of all the sessions, must be called before start.
+		 * When a new send would exceed it, the policy is applied to the session which sends it:
+		 * send_policy::reject      : the send is failed with asio::error::no_buffer_space.
+		 * send_policy::drop_oldest : the same bytes of the oldest queued sends of the session are
+		 *                            dropped, the memory is released when they reach the head of the
+		 *                            queue, if the session hasn't enough queued sends, it is rejected.
+		 * send_policy::disconnect  : the send is rejected and the session is disconnected with
+		 *                            asio::error::no_buffer_space.
+		 */
+		inline derived_t& set_send_budget(std::size_t bytes, send_policy policy = send_policy::reject)
+		{
+			this->send_budget_   = std::make_shared<detail::send_budget>(bytes, policy);
+			this->send_pressure_ = true;
+			return (this->derived());
+		}
+
+		/**
+		 * @brief get the bytes of the queued sends of all the sessions, it is always 0 if the
+		 * budget is not setted.
+		 */
+		inline std::size_t get_send_budget_used() const noexcept
+		{
+			return this->send_budget_ ? this->send_budget_->used.load(std::memory_order_relaxed) : 0;
+		}
+
 	protected:
 		template<typename String, typename StrOrInt, typename C>
 		inline bool _do_start(String&& host, StrOrInt&& port, std::shared_ptr<ecs_t<C>> ecs)
@@ -446,6 +596,16 @@ namespace asio2::detail
 				// set port reuse
 				this->acceptor_->set_option(asio::ip::tcp::acceptor::reuse_address(true), ec_ignore);
 
+				if (derive._is_reuse_port_mode())
+				{
+					detail::set_reuse_port(*(this->acceptor_), true, ec);
+					if (ec)
+					{
+						derive._handle_start(ec, std::move(this_ptr), std::move(ecs));
+						return;
+					}
+				}
+
 				clear_last_error();
 
 				derive._fire_init();
@@ -457,7 +617,16 @@ namespace asio2::detail
 					return;
 				}
 
-				this->acceptor_->listen(asio::socket_base::max_listen_connections, ec);
+				// the acceptor of thread 0 only holds the address in the multi acceptors mode,
+				// the connections are accepted by the acceptors of the other threads.
+				if (derive._is_reuse_port_mode())
+				{
+					derive._open_reuse_acceptors(ec);
+				}
+				else
+				{
+					this->acceptor_->listen(asio::socket_base::max_listen_connections, ec);
+				}
 				if (ec)
 				{
 					derive._handle_start(ec, std::move(this_ptr), std::move(ecs));
@@ -515,6 +684,19 @@ namespace asio2::detail
 				return;
 			}
 
+			if (!this->reuse_acceptors_.empty())
+			{
+				for (std::size_t i = 0; i < this->reuse_acceptors_.size(); ++i)
+				{
+					asio::post(this->reuse_acceptors_[i].iot->context(),
+					[this, i, this_ptr, ecs]() mutable
+					{
+						this->derived()._post_reuse_accept(i, std::move(this_ptr), std::move(ecs));
+					});
+				}
+				return;
+			}
+
 			this->derived()._post_accept(std::move(this_ptr), std::move(ecs));
 		}
 
@@ -590,7 +772,11 @@ namespace asio2::detail
 					}
 				});
 
-				if (iots.size() > std::size_t(2) && this->get_session_count() > ((iots.size() - 1) * 5))
+				// the kernel distributes the connections in the multi acceptors mode, it is not
+				// a strict round robin, so only check the thread 0.
+				if (iots.size() > std::size_t(2) && this->reuse_acceptors_.empty() &&
+					this->io_placement_ == io_placement::round_robin &&
+					this->get_session_count() > ((iots.size() - 1) * 5))
 				{
 					ASIO2_ASSERT(session_counter[0] == 0);
 
@@ -662,6 +848,22 @@ namespace asio2::detail
 			this->acceptor_->cancel(ec_ignore);
 			this->acceptor_->close(ec_ignore);
 
+			// the acceptors of the multi acceptors mode must be closed in their own threads.
+			for (reuse_acceptor& ra : this->reuse_acceptors_)
+			{
+				asio::dispatch(ra.iot->context(), [&ra, this_ptr]() mutable
+				{
+					detail::ignore_unused(this_ptr);
+
+					error_code ec_ignore{};
+
+					detail::cancel_timer(*(ra.timer));
+
+					ra.acceptor->cancel(ec_ignore);
+					ra.acceptor->close(ec_ignore);
+				});
+			}
+
 			ASIO2_ASSERT(this->state_ == state_t::stopped);
 		}
 
@@ -672,21 +874,43 @@ namespace asio2::detail
 			// but if the iopool size is 1, this io will be the zero io forever.
 			std::shared_ptr<io_t> iot;
 
-			if (this->iots_.size() > std::size_t(1))
+			// in the multi acceptors mode, the session is accepted by the acceptor of the current
+			// thread, so use the io of the current thread directly, no cross thread hop.
+			if (!this->reuse_acceptors_.empty() && !this->io_->running_in_this_thread())
 			{
-				iot = this->_get_io();
-
-				if (iot == this->_get_io(0))
-					iot = this->_get_io();
+				for (reuse_acceptor& ra : this->reuse_acceptors_)
+				{
+					if (ra.iot->running_in_this_thread())
+					{
+						iot = ra.iot;
+						break;
+					}
+				}
 			}
-			else
+
+			if (!iot)
 			{
-				iot = this->_get_io();
+				iot = this->_select_io(this->io_placement_, this->iots_.size() > std::size_t(1) ? 1 : 0);
 			}
 
-			return std::make_shared<session_t>(std::forward<Args>(args)...,
-				this->sessions_, this->listener_, std::move(iot),
+			std::shared_ptr<session_t> session_ptr = this->_new_session(iot, std::forward<Args>(args)...,
+				this->sessions_, this->listener_, iot,
 				this->init_buffer_size_, this->max_buffer_size_);
+
+			session_ptr->buffer_pool_ = this->buffer_pool_;
+			session_ptr->recv_chunk_  = this->recv_chunk_;
+
+			if (this->send_pressure_)
+			{
+				session_ptr->send_high_bytes_ = this->send_high_bytes_;
+				session_ptr->send_low_bytes_  = this->send_low_bytes_;
+				session_ptr->send_high_count_ = this->send_high_count_;
+				session_ptr->send_low_count_  = this->send_low_count_;
+				session_ptr->send_budget_     = this->send_budget_;
+				session_ptr->send_pressure_   = true;
+			}
+
+			return session_ptr;
 		}
 
 		template<typename C>
@@ -764,6 +988,189 @@ namespace asio2::detail
 			this->derived()._post_accept(std::move(this_ptr), std::move(ecs));
 		}
 
+		inline bool _is_reuse_port_mode() const noexcept
+		{
+			return (this->reuse_port_ && detail::is_reuse_port_supported() && this->iots_.size() > std::size_t(1));
+		}
+
+		inline void _open_reuse_acceptors(error_code& ec)
+		{
+			ASIO2_ASSERT(this->derived().io_->running_in_this_thread());
+
+			error_code ec_ignore{};
+
+			this->reuse_acceptors_.clear();
+
+			// if the port is 0, the other acceptors must be bound to the port which is choosed
+			// by the system for the acceptor of thread 0.
+			asio::ip::tcp::endpoint endpoint = this->acceptor_->local_endpoint(ec);
+			if (ec)
+				return;
+
+			// skip zero io, the 0 io is used for the server and the session manager.
+			for (std::size_t i = 1; i < this->iots_.size(); ++i)
+			{
+				reuse_acceptor& ra = this->reuse_acceptors_.emplace_back();
+
+				ra.iot      = this->_get_io(i);
+				ra.acceptor = std::make_unique<asio::ip::tcp::acceptor>(ra.iot->context());
+				ra.timer    = std::make_unique<asio::steady_timer>(ra.iot->context());
+
+				ra.acceptor->open(endpoint.protocol(), ec);
+				if (ec)
+					break;
+
+				ra.acceptor->set_option(asio::ip::tcp::acceptor::reuse_address(true), ec_ignore);
+
+				detail::set_reuse_port(*(ra.acceptor), true, ec);
+				if (ec)
+					break;
+
+				ra.acceptor->bind(endpoint, ec);
+				if (ec)
+					break;
+
+				ra.acceptor->listen(asio::socket_base::max_listen_connections, ec);
+				if (ec)
+					break;
+
+				// the backlog is drained with the non blocking accept after each wakeup.
+				ra.acceptor->non_blocking(true, ec);
+				if (ec)
+					break;
+			}
+
+			if (ec)
+			{
+				for (reuse_acceptor& ra : this->reuse_acceptors_)
+				{
+					ra.acceptor->close(ec_ignore);
+				}
+
+				this->reuse_acceptors_.clear();
+			}
+		}
+
+		template<typename C>
+		inline void _post_reuse_accept(
+			std::size_t index, std::shared_ptr<derived_t> this_ptr, std::shared_ptr<ecs_t<C>> ecs)
+		{
+			reuse_acceptor& ra = this->reuse_acceptors_[index];
+
+			ASIO2_ASSERT(ra.iot->running_in_this_thread());
+
+			if (this->state_ != state_t::started || !ra.acceptor->is_open())
+				return;
+
+			ra.acceptor->async_wait(asio::socket_base::wait_read,
+			[this, index, this_ptr = std::move(this_ptr), ecs = std::move(ecs)]
+			(const error_code& ec) mutable
+			{
+				this->derived()._handle_reuse_accept(ec, index, std::move(this_ptr), std::move(ecs));
+			});
+		}
+
+		template<typename C>
+		inline void _handle_reuse_accept(
+			const error_code& ec, std::size_t index,
+			std::shared_ptr<derived_t> this_ptr, std::shared_ptr<ecs_t<C>> ecs)
+		{
+			reuse_acceptor& ra = this->reuse_acceptors_[index];
+
+			ASIO2_ASSERT(ra.iot->running_in_this_thread());
+
+			set_last_error(ec);
+
+			// if the acceptor status is closed,don't call _post_reuse_accept again.
+			if (ec == asio::error::operation_aborted)
+				return;
+
+			if (this->state_ != state_t::started)
+				return;
+
+			error_code ec_accept = ec;
+
+			std::vector<std::shared_ptr<session_t>> sessions;
+
+			// drain the backlog, but limit the count to avoid starving the other handlers
+			// of this thread.
+			for (std::size_t i = 0; !ec_accept && i < std::size_t(ASIO2_MAX_ACCEPT_BATCH); ++i)
+			{
+				asio::ip::tcp::socket peer(ra.iot->context());
+
+				ra.acceptor->accept(peer, ec_accept);
+				if (ec_accept)
+					break;
+
+				std::shared_ptr<session_t> session_ptr = this->derived()._make_session();
+
+				ASIO2_ASSERT(session_ptr->io_ == ra.iot);
+
+				session_ptr->socket().lowest_layer() = std::move(peer);
+
+				sessions.emplace_back(std::move(session_ptr));
+			}
+
+			// the session must be started in the thread 0, because the session manager and
+			// the accept notification are both in the thread 0, so post all the sessions of
+			// this wakeup together.
+			if (!sessions.empty())
+			{
+				// don't use the wallocator, it can only be used in the thread 0.
+				asio::post(this->io_->context(),
+				[this, this_ptr, ecs, sessions = std::move(sessions)]() mutable
+				{
+					this->derived()._start_reuse_sessions(sessions, std::move(this_ptr), std::move(ecs));
+				});
+			}
+
+			if (ec_accept == asio::error::would_block || ec_accept == asio::error::try_again)
+				ec_accept.clear();
+
+			// handle exception, may be is the exception "Too many open files" (exception code : 24)
+			// asio::error::no_descriptors - Too many open files
+			if (ec_accept)
+			{
+				ASIO2_LOG_ERROR("Error occurred when accept:{} {}", ec_accept.value(), ec_accept.message());
+
+				ra.timer->expires_after(std::chrono::seconds(1));
+				ra.timer->async_wait(
+				[this, index, this_ptr = std::move(this_ptr), ecs = std::move(ecs)]
+				(const error_code& ec) mutable
+				{
+					if (ec == asio::error::operation_aborted)
+						return;
+
+					this->derived()._post_reuse_accept(index, std::move(this_ptr), std::move(ecs));
+				});
+
+				return;
+			}
+
+			this->derived()._post_reuse_accept(index, std::move(this_ptr), std::move(ecs));
+		}
+
+		template<typename C>
+		inline void _start_reuse_sessions(std::vector<std::shared_ptr<session_t>>& sessions,
+			std::shared_ptr<derived_t> this_ptr, std::shared_ptr<ecs_t<C>> ecs)
+		{
+			ASIO2_ASSERT(this->derived().io_->running_in_this_thread());
+
+			detail::ignore_unused(this_ptr);
+
+			for (std::shared_ptr<session_t>& session_ptr : sessions)
+			{
+				if (!this->derived().is_started())
+					return;
+
+				// the session start function use the last error as the accept error.
+				clear_last_error();
+
+				session_ptr->counter_ptr_ = this->counter_ptr_;
+				session_ptr->start(detail::to_shared_ptr(ecs->clone()));
+			}
+		}
+
 		inline void _fire_init()
 		{
 			// the _fire_init must be executed in the thread 0.
@@ -807,6 +1214,37 @@ namespace asio2::detail
 		/// used to hold the acceptor io_context util all sessions are closed already.
 		std::unique_ptr<asio::steady_timer>      counter_timer_;
 
+		struct reuse_acceptor
+		{
+			std::shared_ptr<io_t>                    iot;
+
+			std::unique_ptr<asio::ip::tcp::acceptor> acceptor;
+
+			/// timer for acceptor exception, like the exception "Too many open files"
+			std::unique_ptr<asio::steady_timer>      timer;
+		};
+
+		/// the acceptors of the multi acceptors mode, one for each iopool thread except the thread 0.
+		std::vector<reuse_acceptor>              reuse_acceptors_;
+
+		bool                    reuse_port_       = false;
+
+		/// whether the idle sessions release the receive buffer to the buffer pool.
+		bool                    buffer_pool_      = false;
+
+		/// whether the sessions receive the data into the chunks which can be shared without a copy.
+		bool                    recv_chunk_       = false;
+
+		/// the send watermarks of each session, and the send budget of all the sessions.
+		bool                    send_pressure_    = false;
+
+		std::size_t             send_high_bytes_  = (std::numeric_limits<std::size_t>::max)();
+		std::size_t             send_low_bytes_   = 0;
+		std::size_t             send_high_count_  = (std::numeric_limits<std::size_t>::max)();
+		std::size_t             send_low_count_   = 0;
+
+		std::shared_ptr<detail::send_budget> send_budget_;
+
 		std::size_t             init_buffer_size_ = tcp_frame_size;
 
 		std::size_t             max_buffer_size_  = max_buffer_size;
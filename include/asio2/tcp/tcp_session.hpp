@@ -18,9 +18,15 @@
 #include <asio2/base/detail/push_options.hpp>
 
 #include <asio2/base/session.hpp>
+#include <asio2/base/impl/async_recv_cp.hpp>
+#include <asio2/base/detail/busy_poll.hpp>
+#include <asio2/base/detail/buffer_pool.hpp>
+#include <asio2/base/detail/recv_chunk.hpp>
 
 #include <asio2/tcp/impl/tcp_keepalive_cp.hpp>
 #include <asio2/tcp/impl/tcp_send_op.hpp>
+#include <asio2/tcp/impl/tcp_send_file_cp.hpp>
+#include <asio2/tcp/impl/tcp_send_zerocopy_cp.hpp>
 #include <asio2/tcp/impl/tcp_recv_op.hpp>
 
 namespace asio2::detail
@@ -32,7 +38,7 @@ namespace asio2::detail
 		static constexpr bool is_server  = false;
 
 		using socket_t    = asio::ip::tcp::socket;
-		using buffer_t    = asio::streambuf;
+		using buffer_t    = detail::pooled_streambuf;
 		using send_data_t = std::string_view;
 		using recv_data_t = std::string_view;
 	};
@@ -47,7 +53,10 @@ namespace asio2::detail
 		: public session_impl_t   <derived_t, args_t>
 		, public tcp_keepalive_cp <derived_t, args_t>
 		, public tcp_send_op      <derived_t, args_t>
+		, public tcp_send_file_cp <derived_t, args_t>
+		, public tcp_send_zerocopy_cp <derived_t, args_t>
 		, public tcp_recv_op      <derived_t, args_t>
+		, public async_recv_cp    <derived_t, args_t>
 		, public tcp_tag
 	{
 		ASIO2_CLASS_FRIEND_DECLARE_BASE;
@@ -79,6 +88,8 @@ namespace asio2::detail
 			: super(sessions, listener, rwio, init_buf_size, max_buf_size, rwio->context())
 			, tcp_keepalive_cp<derived_t, args_t>()
 			, tcp_send_op     <derived_t, args_t>()
+			, tcp_send_file_cp<derived_t, args_t>()
+			, tcp_send_zerocopy_cp<derived_t, args_t>()
 			, tcp_recv_op     <derived_t, args_t>()
 			, rallocator_()
 			, wallocator_()
@@ -305,6 +316,31 @@ namespace asio2::detail
 			return reinterpret_cast<key_type>(this);
 		}
 
+		/**
+		 * @brief get the received data as a ref-counted chunk, must be called in the recv callback.
+		 * The chunk can be kept and processed asynchronously after the recv callback returns.
+		 * If the recv chunk mode is enabled, the chunk shares the memory of the receive buffer
+		 * without a copy, and the session reads the next data into a new block of the pool,
+		 * otherwise the data is copied into the chunk. see tcp_server::set_recv_chunk
+		 */
+		inline asio2::recv_chunk get_recv_chunk()
+		{
+			ASIO2_ASSERT(this->io_->running_in_this_thread());
+
+			if (this->recv_chunk_)
+				return this->chunk_buffer_.share(this->recv_chunk_data_);
+
+			return detail::chunk_buffer::copy(this->io_->buffer_pool(), this->recv_chunk_data_);
+		}
+
+		/**
+		 * @brief check whether the recv chunk mode is enabled.
+		 */
+		inline bool is_recv_chunk() const noexcept
+		{
+			return this->recv_chunk_;
+		}
+
 	protected:
 		template<class T, class R, class... Args>
 		struct condition_has_member_init : std::false_type {};
@@ -349,6 +385,27 @@ namespace asio2::detail
 
 			// set keeplive options
 			this->derived().set_keep_alive_options();
+
+			// the io_context thread is in busy poll mode, let the kernel busy poll the socket too.
+			if (std::chrono::microseconds usec = this->derived().io_->get_socket_busy_poll(); usec.count() > 0)
+			{
+				error_code ec_ignore{};
+				detail::set_busy_poll(this->derived().socket().lowest_layer(), usec, ec_ignore);
+			}
+
+			// the buffer is created before the buffer pool mode is known, recreate it with the
+			// allocator of the buffer pool, then the first read borrows the memory from the pool too.
+			if constexpr (derived_t::_is_buffer_pool_supported())
+			{
+				if (this->buffer_pool_)
+					this->derived()._tcp_reset_buffer();
+			}
+
+			if (this->recv_chunk_)
+			{
+				this->chunk_buffer_ = detail::chunk_buffer(this->io_->buffer_pool(),
+					this->derived().buffer().pre_size(), this->derived().buffer().max_size());
+			}
 		}
 
 		template<typename C, typename DeferEvent>
@@ -393,6 +450,10 @@ namespace asio2::detail
 
 			this->derived()._rdc_stop();
 
+			this->derived()._tcp_zerocopy_stop();
+
+			this->derived()._async_recv_stop(ec);
+
 			// call shutdown again, beacuse the do shutdown maybe not called, eg: when
 			// protocol error is checked in the mqtt or http, then the do disconnect 
 			// maybe called directly.
@@ -500,6 +561,12 @@ namespace asio2::detail
 			return this->derived()._tcp_send(data, std::forward<Callback>(callback));
 		}
 
+		template<class Callback>
+		inline bool _do_send_batch(send_batch& batch, Callback&& callback)
+		{
+			return this->derived()._tcp_send_batch(batch, std::forward<Callback>(callback));
+		}
+
 		template<class Data>
 		inline send_data_t _rdc_convert_to_send_data(Data& data) noexcept
 		{
@@ -552,6 +619,8 @@ namespace asio2::detail
 
 			this->listener_.notify(event_type::recv, this_ptr, data);
 
+			this->derived()._async_recv_notify(data);
+
 			this->derived()._rdc_handle_recv(this_ptr, ecs, data);
 		}
 
@@ -610,6 +679,18 @@ namespace asio2::detail
 		/// Does it have the same datagram mechanism as udp?
 		bool                                      dgram_                = false;
 
+		/// Whether the receive buffer is released to the buffer pool of the io_context when idle.
+		bool                                      buffer_pool_          = false;
+
+		/// Whether the data is received into the chunk buffer, then it can be shared without a copy.
+		bool                                      recv_chunk_           = false;
+
+		/// The receive buffer of the recv chunk mode.
+		detail::chunk_buffer                      chunk_buffer_;
+
+		/// The data which is passed to the recv callback currently.
+		std::string_view                          recv_chunk_data_;
+
 	#if defined(_DEBUG) || defined(DEBUG)
 		bool                                      is_disconnect_called_ = false;
 	#endif
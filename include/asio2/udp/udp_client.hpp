@@ -18,6 +18,7 @@
 #include <asio2/base/detail/push_options.hpp>
 
 #include <asio2/base/client.hpp>
+#include <asio2/base/impl/async_recv_cp.hpp>
 #include <asio2/base/detail/linear_buffer.hpp>
 
 #include <asio2/udp/detail/kcp_util.hpp>
@@ -56,6 +57,7 @@ namespace asio2::detail
 		: public client_impl_t<derived_t, args_t>
 		, public udp_send_op  <derived_t, args_t>
 		, public udp_recv_op  <derived_t, args_t>
+		, public async_recv_cp<derived_t, args_t>
 		, public udp_tag
 	{
 		ASIO2_CLASS_FRIEND_DECLARE_BASE;
@@ -135,13 +137,23 @@ namespace asio2::detail
 		 * a numeric address string.
 		 * @param port - A string identifying the requested service. This may be a
 		 * descriptive name or a numeric string corresponding to a port number.
+		 * The last one of the args can be a completion token, eg: asio::use_awaitable, then it
+		 * returns an awaitable which completes with void(asio::error_code ec) when connected.
 		 */
 		template<typename String, typename StrOrInt, typename... Args>
-		inline bool async_start(String&& host, StrOrInt&& port, Args&&... args)
+		inline auto async_start(String&& host, StrOrInt&& port, Args&&... args)
 		{
-			return this->derived().template _do_connect<true>(
-				std::forward<String>(host), std::forward<StrOrInt>(port),
-				ecs_helper::make_ecs('0', std::forward<Args>(args)...));
+			if constexpr (detail::is_last_awaitable_token_v<Args...>)
+			{
+				return this->derived()._async_start_with_token(
+					std::forward<String>(host), std::forward<StrOrInt>(port), std::forward<Args>(args)...);
+			}
+			else
+			{
+				return this->derived().template _do_connect<true>(
+					std::forward<String>(host), std::forward<StrOrInt>(port),
+					ecs_helper::make_ecs('0', std::forward<Args>(args)...));
+			}
 		}
 
 		/**
@@ -414,9 +426,15 @@ namespace asio2::detail
 			// use derfer to ensure the promise's value must be seted.
 			detail::defer_event pg
 			{
-				[promise = std::move(promise)]() mutable
+				[promise = std::move(promise), handler = std::move(this->start_handler_)]() mutable
 				{
-					promise.set_value(get_last_error());
+					error_code ec = get_last_error();
+
+					// the completion handler of the async_start which is called with a completion token.
+					if (handler)
+						handler(ec);
+
+					promise.set_value(ec);
 				}
 			};
 
@@ -563,6 +581,8 @@ namespace asio2::detail
 
 			this->derived()._rdc_stop();
 
+			this->derived()._async_recv_stop(ec);
+
 			if (this->kcp_stream_)
 				this->kcp_stream_->_kcp_stop();
 
@@ -705,6 +725,8 @@ namespace asio2::detail
 
 			this->listener_.notify(event_type::recv, data);
 
+			this->derived()._async_recv_notify(data);
+
 			this->derived()._rdc_handle_recv(this_ptr, ecs, data);
 		}
 
@@ -683,7 +683,7 @@ namespace asio2::detail
 		template<typename... Args>
 		inline std::shared_ptr<session_t> _make_session(Args&&... args)
 		{
-			return std::make_shared<session_t>(
+			return this->_new_session(this->io_,
 				std::forward<Args>(args)...,
 				this->sessions_,
 				this->listener_,
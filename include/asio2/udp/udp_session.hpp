@@ -18,6 +18,7 @@
 #include <asio2/base/detail/push_options.hpp>
 
 #include <asio2/base/session.hpp>
+#include <asio2/base/impl/async_recv_cp.hpp>
 #include <asio2/base/detail/linear_buffer.hpp>
 
 #include <asio2/udp/detail/kcp_util.hpp>
@@ -52,6 +53,7 @@ namespace asio2::detail
 		: public session_impl_t<derived_t, args_t>
 		, public udp_send_op   <derived_t, args_t>
 		, public udp_recv_op   <derived_t, args_t>
+		, public async_recv_cp <derived_t, args_t>
 		, public udp_tag
 	{
 		ASIO2_CLASS_FRIEND_DECLARE_BASE;
@@ -456,6 +458,8 @@ namespace asio2::detail
 
 			this->derived()._rdc_stop();
 
+			this->derived()._async_recv_stop(ec);
+
 			super::_handle_disconnect(ec, std::move(this_ptr), std::move(chain));
 		}
 
@@ -606,6 +610,8 @@ namespace asio2::detail
 
 			this->listener_.notify(event_type::recv, this_ptr, data);
 
+			this->derived()._async_recv_notify(data);
+
 			this->derived()._rdc_handle_recv(this_ptr, ecs, data);
 		}
 
@@ -0,0 +1,253 @@
+#define ASIO2_ENABLE_METRICS
+
+#include <asio2/tcp/tcp_server.hpp>
+#include <asio2/tcp/tcp_client.hpp>
+#include <asio2/rpc/rpc_server.hpp>
+#include <asio2/rpc/rpc_client.hpp>
+#include <asio2/http/http_server.hpp>
+#include <asio2/http/http_client.hpp>
+
+// Measure the heap allocations of the framework's completion handlers per message on the tcp,
+// rpc and http echo paths. A handler is allocated from the single block of storage of the
+// session's rallocator/wallocator, or from the per thread handler_memory_pool when the storage
+// is in use or too small, and the pool only goes to the heap when it has no cached block.
+// The counters are taken after a warm up, so the "heap/msg" column should be 0.
+// usage : bench_asio2_handler_alloc [messages]
+
+struct alloc_sample
+{
+	asio2::allocator_metrics server;
+	asio2::allocator_metrics client;
+};
+
+template<class Server, class Client>
+alloc_sample take_sample(Server& server, Client& client)
+{
+	alloc_sample s;
+
+	s.server = server.get_allocator_metrics();
+	s.client = client.get_allocator_metrics();
+
+	return s;
+}
+
+void print_sample(const char* name, const alloc_sample& a, const alloc_sample& b, std::size_t count)
+{
+	auto delta = [](const asio2::allocator_stats& x, const asio2::allocator_stats& y)
+	{
+		return asio2::allocator_stats{ y.hits - x.hits, y.misses - x.misses, y.heap - x.heap };
+	};
+
+	asio2::allocator_stats sr = delta(a.server.rallocator, b.server.rallocator);
+	asio2::allocator_stats sw = delta(a.server.wallocator, b.server.wallocator);
+	asio2::allocator_stats cr = delta(a.client.rallocator, b.client.rallocator);
+	asio2::allocator_stats cw = delta(a.client.wallocator, b.client.wallocator);
+
+	std::uint64_t hits   = sr.hits   + sw.hits   + cr.hits   + cw.hits;
+	std::uint64_t misses = sr.misses + sw.misses + cr.misses + cw.misses;
+	std::uint64_t heap   = sr.heap   + sw.heap   + cr.heap   + cw.heap;
+
+	printf("%-5s hits/msg %6.2f | misses/msg %6.2f | heap/msg %6.3f\n",
+		name,
+		double(hits  ) / double(count),
+		double(misses) / double(count),
+		double(heap  ) / double(count));
+}
+
+int main(int argc, char* argv[])
+{
+	std::size_t count = (argc > 1) ? std::size_t(std::strtoull(argv[1], nullptr, 10)) : std::size_t(100000);
+	std::size_t warmup = (std::max)(count / 10, std::size_t(100));
+
+	count = (std::max)(count, std::size_t(100));
+
+	printf("messages %zu, warm up %zu\n", count, warmup);
+
+	// tcp
+	{
+		asio2::tcp_server server(1);
+		asio2::tcp_client client;
+
+		std::size_t recvd = 0;
+		std::promise<void> warmed, finished;
+
+		server.bind_recv([&](std::shared_ptr<asio2::tcp_session>& session_ptr, std::string_view data)
+		{
+			session_ptr->async_send(data);
+		});
+
+		client.bind_connect([&]()
+		{
+			if (!asio2::get_last_error())
+				client.async_send("0123456789abcdef\n");
+		}).bind_recv([&](std::string_view data)
+		{
+			asio2::ignore_unused(data);
+
+			if (++recvd == warmup)
+			{
+				warmed.set_value();
+				return;
+			}
+			if (recvd == warmup + count)
+			{
+				finished.set_value();
+				return;
+			}
+
+			client.async_send("0123456789abcdef\n");
+		});
+
+		if (!server.start("127.0.0.1", 18090, '\n') || !client.start("127.0.0.1", 18090, '\n'))
+		{
+			printf("tcp start failed: %s\n", asio2::last_error_msg().data());
+			return 0;
+		}
+
+		warmed.get_future().wait();
+
+		alloc_sample a = take_sample(server, client);
+
+		client.async_send("0123456789abcdef\n");
+
+		finished.get_future().wait();
+
+		alloc_sample b = take_sample(server, client);
+
+		print_sample("tcp", a, b, count);
+
+		client.stop();
+		server.stop();
+	}
+
+	// rpc
+	{
+		asio2::rpc_server server(1);
+		asio2::rpc_client client;
+
+		std::size_t recvd = 0;
+		std::promise<void> warmed, finished;
+
+		server.bind("echo", [](std::string s) { return s; });
+
+		std::function<void()> sender;
+
+		sender = [&]()
+		{
+			client.async_call([&](std::string)
+			{
+				if (asio2::get_last_error())
+					return;
+
+				if (++recvd == warmup)
+				{
+					warmed.set_value();
+					return;
+				}
+				if (recvd == warmup + count)
+				{
+					finished.set_value();
+					return;
+				}
+
+				sender();
+			}, "echo", std::string("0123456789abcdef"));
+		};
+
+		client.bind_connect([&]()
+		{
+			if (!asio2::get_last_error())
+				sender();
+		});
+
+		if (!server.start("127.0.0.1", 18091) || !client.start("127.0.0.1", 18091))
+		{
+			printf("rpc start failed: %s\n", asio2::last_error_msg().data());
+			return 0;
+		}
+
+		warmed.get_future().wait();
+
+		alloc_sample a = take_sample(server, client);
+
+		client.post([&]() { sender(); });
+
+		finished.get_future().wait();
+
+		alloc_sample b = take_sample(server, client);
+
+		print_sample("rpc", a, b, count);
+
+		client.stop();
+		server.stop();
+	}
+
+	// http
+	{
+		asio2::http_server server(1);
+		asio2::http_client client;
+
+		std::size_t recvd = 0;
+		std::promise<void> warmed, finished;
+
+		server.bind<http::verb::get>("/echo", [](http::web_request& req, http::web_response& rep)
+		{
+			asio2::ignore_unused(req);
+
+			rep.fill_text("0123456789abcdef");
+		});
+
+		auto make_req = []()
+		{
+			http::web_request req(http::verb::get, "/echo", 11);
+			req.set(http::field::host, "127.0.0.1");
+			req.keep_alive(true);
+			return req;
+		};
+
+		client.bind_recv([&](http::web_request& req, http::web_response& rep)
+		{
+			asio2::ignore_unused(req, rep);
+
+			if (++recvd == warmup)
+			{
+				warmed.set_value();
+				return;
+			}
+			if (recvd == warmup + count)
+			{
+				finished.set_value();
+				return;
+			}
+
+			client.async_send(make_req());
+		}).bind_connect([&]()
+		{
+			if (!asio2::get_last_error())
+				client.async_send(make_req());
+		});
+
+		if (!server.start("127.0.0.1", 18092) || !client.start("127.0.0.1", 18092))
+		{
+			printf("http start failed: %s\n", asio2::last_error_msg().data());
+			return 0;
+		}
+
+		warmed.get_future().wait();
+
+		alloc_sample a = take_sample(server, client);
+
+		client.async_send(make_req());
+
+		finished.get_future().wait();
+
+		alloc_sample b = take_sample(server, client);
+
+		print_sample("http", a, b, count);
+
+		client.stop();
+		server.stop();
+	}
+
+	return 0;
+}
@@ -0,0 +1,161 @@
+#include <asio2/rpc/rpc_server.hpp>
+#include <asio2/rpc/rpc_client.hpp>
+
+// Compare the calls per second of a rpc echo with the three call styles :
+// callback  : async_call with a callback, the next call is made in the callback.
+// future    : the synchronous call in the user thread, which waits for a std::future.
+// coroutine : co_await async_call(..., asio::use_awaitable) in a coroutine which runs on the
+//             client's io_context, it is resumed on the io thread without an additional post.
+// Every style is run with 1 call in flight (latency) and with [depth] calls in flight
+// (the future style uses [depth] user threads).
+// usage : bench_asio2_rpc_call_styles [calls] [depth]
+
+using clock_type = std::chrono::steady_clock;
+
+void print_result(const char* name, std::size_t inflight, std::size_t count, clock_type::time_point t1)
+{
+	double secs = std::chrono::duration_cast<std::chrono::duration<double>>(clock_type::now() - t1).count();
+
+	printf("%-9s inflight %3zu : %10.0lf calls/sec\n", name, inflight, double(count) / secs);
+}
+
+void bench_callback(asio2::rpc_client& client, std::size_t count, std::size_t inflight)
+{
+	std::atomic<std::size_t> sent = 0, recvd = 0;
+	std::promise<void> finished;
+
+	std::function<void()> sender = [&]()
+	{
+		if (sent.fetch_add(1) >= count)
+			return;
+
+		client.async_call([&](std::string s)
+		{
+			asio2::ignore_unused(s);
+
+			if (++recvd == count)
+				finished.set_value();
+			else
+				sender();
+		}, "echo", std::string("0123456789abcdef"));
+	};
+
+	auto t1 = clock_type::now();
+
+	client.post([&]()
+	{
+		for (std::size_t i = 0; i < inflight; ++i)
+			sender();
+	});
+
+	finished.get_future().wait();
+
+	print_result("callback", inflight, count, t1);
+}
+
+void bench_future(asio2::rpc_client& client, std::size_t count, std::size_t inflight)
+{
+	std::atomic<std::size_t> sent = 0;
+
+	auto t1 = clock_type::now();
+
+	std::vector<std::thread> threads;
+
+	for (std::size_t i = 0; i < inflight; ++i)
+	{
+		threads.emplace_back([&]()
+		{
+			while (sent.fetch_add(1) < count)
+			{
+				std::string s = client.call<std::string>("echo", std::string("0123456789abcdef"));
+
+				asio2::ignore_unused(s);
+			}
+		});
+	}
+
+	for (auto& t : threads)
+		t.join();
+
+	print_result("future", inflight, count, t1);
+}
+
+void bench_coroutine(asio2::rpc_client& client, std::size_t count, std::size_t inflight)
+{
+#if defined(ASIO_HAS_CO_AWAIT)
+	std::atomic<std::size_t> sent = 0, recvd = 0;
+	std::promise<void> finished;
+
+	auto t1 = clock_type::now();
+
+	for (std::size_t i = 0; i < inflight; ++i)
+	{
+		asio::co_spawn(client.io().context(), [&]() -> asio::awaitable<void>
+		{
+			while (sent.fetch_add(1) < count)
+			{
+				auto [ec, s] = co_await client.async_call<std::string>(asio::as_tuple(asio::use_awaitable),
+					"echo", std::string("0123456789abcdef"));
+
+				asio2::ignore_unused(ec, s);
+
+				// the locals of this function are invalid after the set_value.
+				if (++recvd == count)
+				{
+					finished.set_value();
+					co_return;
+				}
+			}
+		}, asio::detached);
+	}
+
+	finished.get_future().wait();
+
+	print_result("coroutine", inflight, count, t1);
+#else
+	asio2::ignore_unused(client, count, inflight);
+
+	printf("coroutine : the compiler has no c++20 coroutine support\n");
+#endif
+}
+
+int main(int argc, char* argv[])
+{
+	std::size_t count = (argc > 1) ? std::size_t(std::strtoull(argv[1], nullptr, 10)) : std::size_t(100000);
+	std::size_t depth = (argc > 2) ? std::size_t(std::strtoull(argv[2], nullptr, 10)) : std::size_t(16);
+
+	count = (std::max)(count, std::size_t(100));
+	depth = (std::max)(depth, std::size_t(1));
+
+	asio2::rpc_server server(1);
+
+	server.bind("echo", [](std::string s) { return s; });
+
+	if (!server.start("127.0.0.1", 18094))
+	{
+		printf("start failed: %s\n", asio2::last_error_msg().data());
+		return 0;
+	}
+
+	asio2::rpc_client client;
+
+	if (!client.start("127.0.0.1", 18094))
+	{
+		printf("connect failed: %s\n", asio2::last_error_msg().data());
+		return 0;
+	}
+
+	printf("calls %zu\n", count);
+
+	for (std::size_t inflight : { std::size_t(1), depth })
+	{
+		bench_callback (client, count, inflight);
+		bench_future   (client, count, inflight);
+		bench_coroutine(client, count, inflight);
+	}
+
+	client.stop();
+	server.stop();
+
+	return 0;
+}
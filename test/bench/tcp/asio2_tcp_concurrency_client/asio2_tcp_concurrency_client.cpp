@@ -1,5 +1,8 @@
 #include <asio2/tcp/tcp_client.hpp>
 
+// usage : bench_asio2_tcp_concurrency_client [client count] [idle]
+// idle : each client sends one message and then keeps silent, like the mostly-idle iot devices.
+
 int main(int argc, char* argv[])
 {
 	asio2::iopool iopool;
@@ -10,6 +13,8 @@ int main(int argc, char* argv[])
 	if (argc > 1)
 		client_count = std::stoi(argv[1]);
 
+	bool idle = (argc > 2 && std::string_view(argv[2]) == "idle");
+
 	for (int i = 0; i < client_count; i++)
 	{
 		std::shared_ptr<asio2::tcp_client> client = std::make_shared<asio2::tcp_client>(iopool.get(i));
@@ -21,8 +26,11 @@ int main(int argc, char* argv[])
 			if (!asio2::get_last_error())
 				pclt->async_send(std::move(strmsg));
 
-		}).bind_recv([pclt = client.get()](std::string_view data)
+		}).bind_recv([pclt = client.get(), idle](std::string_view data)
 		{
+			if (idle)
+				return;
+
 			pclt->async_send(asio::buffer(data)); // no allocate memory
 			//pclt->async_send(data); // allocate memory
 		});
@@ -1,14 +1,34 @@
 #include <asio2/tcp/tcp_server.hpp>
+#include <fstream>
+
+// usage : bench_asio2_tcp_concurrency_server [pool]
+// pool : enable the buffer pool mode, the idle sessions release the receive buffer.
+// run the client with "idle" to compare the memory of the mostly-idle connections.
 
 decltype(std::chrono::steady_clock::now()) time1 = std::chrono::steady_clock::now();
 decltype(std::chrono::steady_clock::now()) time2 = std::chrono::steady_clock::now();
 std::atomic<std::size_t> recvd_bytes = 0;
 bool first = true;
 
-int main()
+// the resident memory of this process in MB.
+double get_rss_mb()
 {
+	std::size_t pages = 0, resident = 0;
+	std::ifstream file("/proc/self/statm");
+	file >> pages >> resident;
+	return double(resident) * 4096.0 / 1024.0 / 1024.0;
+}
+
+int main(int argc, char* argv[])
+{
+	bool pool = (argc > 1 && std::string_view(argv[1]) == "pool");
+
 	asio2::tcp_server server;
 
+	server.set_buffer_pool(pool);
+
+	printf("buffer pool : %s\n", pool ? "on" : "off");
+
 	server.bind_recv([&](std::shared_ptr<asio2::tcp_session>& session_ptr, std::string_view data)
 	{
 		if (first)
@@ -27,7 +47,8 @@ int main()
 			time2 = time3;
 			sec = std::chrono::duration_cast<std::chrono::seconds>(time3 - time1).count();
 			double speed = (double)recvd_bytes / (double)sec / double(1024) / double(1024);
-			printf("%.1lf MByte/Sec connection_count:%zu\n", speed, server.get_session_count());
+			printf("%.1lf MByte/Sec connection_count:%zu rss:%.1lf MB\n", speed,
+				server.get_session_count(), get_rss_mb());
 		}
 
 		session_ptr->async_send(asio::buffer(data)); // no allocate memory
@@ -37,6 +58,12 @@ int main()
 	if (!server.start("0.0.0.0", "18081"))
 		printf("start failed: %s\n", asio2::last_error_msg().data());
 
+	// print the memory of the idle connections, the recv callback is not called when idle.
+	server.start_timer(1, std::chrono::seconds(2), [&]()
+	{
+		printf("connection_count:%zu rss:%.1lf MB\n", server.get_session_count(), get_rss_mb());
+	});
+
 	while (std::getchar() != '\n');
 
 	return 0;
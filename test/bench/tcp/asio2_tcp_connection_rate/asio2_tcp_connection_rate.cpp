@@ -0,0 +1,95 @@
+#include <asio2/tcp/tcp_server.hpp>
+
+// Compare the accepted connections/sec of the single acceptor and the multi acceptors mode,
+// with and without the session pool, each connection is closed by the client immediately.
+// usage : bench_asio2_tcp_connection_rate [seconds] [connect threads]
+
+int main(int argc, char* argv[])
+{
+	int seconds = (argc > 1) ? std::atoi(argv[1]) : 5;
+	int threads = (argc > 2) ? std::atoi(argv[2]) : int(std::thread::hardware_concurrency());
+
+	threads = (std::max)(threads, 1);
+
+	for (int mode = 0; mode < 4; ++mode)
+	{
+		bool reuse_port = (mode & 1) != 0;
+		bool session_pool = (mode & 2) != 0;
+
+		asio2::tcp_server server;
+
+		server.set_reuse_port(reuse_port);
+		server.set_session_pool(session_pool);
+
+		std::atomic<std::size_t> accepted = 0;
+
+		server.bind_accept([&](std::shared_ptr<asio2::tcp_session>&)
+		{
+			accepted++;
+		});
+
+		if (!server.start("127.0.0.1", "18083"))
+		{
+			printf("start failed: %s\n", asio2::last_error_msg().data());
+			return 0;
+		}
+
+		asio::ip::tcp::endpoint endpoint(asio::ip::make_address("127.0.0.1"), 18083);
+
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+
+		std::atomic<std::size_t> connected = 0;
+
+		std::vector<std::thread> connectors;
+
+		for (int i = 0; i < threads; ++i)
+		{
+			connectors.emplace_back([&]()
+			{
+				asio::io_context ioc;
+
+				while (std::chrono::steady_clock::now() < deadline)
+				{
+					asio::ip::tcp::socket sock(ioc);
+
+					asio::error_code ec;
+					sock.connect(endpoint, ec);
+					if (ec)
+						continue;
+
+					connected++;
+
+					// close with RST, avoid to exhaust the local ports with TIME_WAIT.
+					sock.set_option(asio::socket_base::linger(true, 0), ec);
+					sock.close(ec);
+				}
+			});
+		}
+
+		for (auto& t : connectors)
+		{
+			t.join();
+		}
+
+		// wait the server to accept the remaining connections of the backlog.
+		for (int i = 0; i < 100 && accepted < connected; ++i)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+
+		// wait the sessions to be closed by the peer's RST.
+		for (int i = 0; i < 500 && server.get_session_count() > 0; ++i)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+
+		printf("%-16s %-15s : %10.0lf conns/sec (%zu connected, %zu accepted)\n",
+			reuse_port ? "multi acceptors" : "single acceptor",
+			session_pool ? "session pool" : "no session pool",
+			double(accepted.load()) / double(seconds), connected.load(), accepted.load());
+
+		server.stop();
+	}
+
+	return 0;
+}
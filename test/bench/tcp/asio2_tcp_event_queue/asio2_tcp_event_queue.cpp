@@ -0,0 +1,87 @@
+#include <asio2/tcp/tcp_server.hpp>
+#include <asio2/tcp/tcp_client.hpp>
+
+// Measure the events/sec when many threads push events to one client, the "post" uses one
+// asio::post for each event, the "queued event" and the "async_send" use the inbox of the
+// event queue, which posts only when the inbox becomes non-empty and drains the whole batch
+// in one wakeup.
+// usage : bench_asio2_tcp_event_queue [events per thread] [threads]
+
+int main(int argc, char* argv[])
+{
+	std::size_t count = (argc > 1) ? std::size_t(std::strtoull(argv[1], nullptr, 10)) : std::size_t(200000);
+	int threads = (argc > 2) ? std::atoi(argv[2]) : 8;
+
+	count = (std::max)(count, std::size_t(1));
+	threads = (std::max)(threads, 1);
+
+	asio2::tcp_server server;
+
+	std::atomic<std::size_t> recvd_bytes = 0;
+
+	server.bind_recv([&](std::shared_ptr<asio2::tcp_session>&, std::string_view data)
+	{
+		recvd_bytes += data.size();
+	});
+
+	if (!server.start("127.0.0.1", "18083"))
+	{
+		printf("start failed: %s\n", asio2::last_error_msg().data());
+		return 0;
+	}
+
+	asio2::tcp_client client;
+
+	if (!client.start("127.0.0.1", "18083"))
+	{
+		printf("connect failed: %s\n", asio2::last_error_msg().data());
+		return 0;
+	}
+
+	std::size_t total = count * std::size_t(threads);
+
+	printf("events per thread %zu, threads %d\n", count, threads);
+
+	for (int mode : { 0, 1, 2 })
+	{
+		std::atomic<std::size_t> done = 0;
+
+		auto t1 = std::chrono::steady_clock::now();
+
+		std::vector<std::thread> v;
+
+		for (int t = 0; t < threads; ++t)
+		{
+			v.emplace_back([&]()
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					if (mode == 0)
+						client.post([&done]() { done++; });
+					else if (mode == 1)
+						client.post_queued_event([&done]() { done++; });
+					else
+						client.async_send("0123456789abcdef", [&done]() { done++; });
+				}
+			});
+		}
+
+		for (std::thread& t : v)
+			t.join();
+
+		while (done < total)
+			std::this_thread::yield();
+
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t1).count();
+
+		const char* names[] = { "post", "queued event", "async_send" };
+
+		printf("%-14s %8.1f ms | %6.2f M events/s\n", names[mode], ms,
+			double(total) / ms / 1000.0);
+	}
+
+	client.stop();
+	server.stop();
+
+	return 0;
+}
@@ -0,0 +1,195 @@
+#include <asio2/tcp/tcp_server.hpp>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+// Compare the per session housekeeping timer cost of the asio::steady_timer and the timing wheel.
+// Every idle session holds one silence timer, the timer is armed, armed again after the data
+// transfer, and canceled when the session is stopped, this bench does the same operations for
+// a large number of timers in the io_context thread.
+// usage : bench_asio2_tcp_idle_timers [timers count...]
+
+struct idle_session : std::enable_shared_from_this<idle_session>
+{
+	explicit idle_session(asio::io_context& ioc) : timer(ioc) {}
+
+	asio::steady_timer                timer;
+};
+
+struct idle_session_wheel : std::enable_shared_from_this<idle_session_wheel>
+{
+	asio2::detail::timing_wheel::node node;
+};
+
+static std::size_t resident_memory()
+{
+#if defined(__linux__)
+	std::size_t pages = 0, resident = 0;
+	if (FILE* fp = std::fopen("/proc/self/statm", "r"))
+	{
+		if (std::fscanf(fp, "%zu %zu", &pages, &resident) != 2)
+			resident = 0;
+		std::fclose(fp);
+	}
+	return resident * std::size_t(::sysconf(_SC_PAGESIZE));
+#else
+	return 0;
+#endif
+}
+
+template<class Fun>
+static double elapsed_ms(Fun&& fun)
+{
+	auto t1 = std::chrono::steady_clock::now();
+	fun();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t1).count();
+}
+
+int main(int argc, char* argv[])
+{
+	std::vector<std::size_t> counts;
+
+	for (int i = 1; i < argc; ++i)
+		counts.emplace_back(std::size_t(std::strtoull(argv[i], nullptr, 10)));
+
+	if (counts.empty())
+		counts = { 100000, 1000000 };
+
+	asio2::iopool iopool(1);
+
+	iopool.start();
+
+	std::shared_ptr<asio2::io_t> iot = iopool.get(0);
+
+	// the sessions are connected at different time, so the timeouts are different.
+	auto timeout = [](std::size_t i)
+	{
+		return std::chrono::seconds(60) + std::chrono::milliseconds(i % 60000);
+	};
+
+	printf("%-14s %10s %10s %10s %10s %12s %12s\n",
+		"mode", "timers", "arm ms", "rearm ms", "cancel ms", "timer bytes", "arm bytes");
+
+	for (std::size_t count : counts)
+	{
+		// asio::steady_timer for each session
+		asio::post(iot->context(), [&]()
+		{
+			std::vector<std::shared_ptr<idle_session>> sessions;
+
+			sessions.reserve(count);
+
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				sessions.emplace_back(std::make_shared<idle_session>(iot->context()));
+			}
+
+			std::size_t mem1 = resident_memory();
+
+			double arm = elapsed_ms([&]()
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					std::shared_ptr<idle_session>& p = sessions[i];
+					p->timer.expires_after(timeout(i));
+					p->timer.async_wait([p](const asio::error_code&) {});
+				}
+			});
+
+			std::size_t mem2 = resident_memory();
+
+			// the data transfer, the timer is armed again with the rest of the timeout.
+			double rearm = elapsed_ms([&]()
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					std::shared_ptr<idle_session>& p = sessions[i];
+					p->timer.expires_after(timeout(i + 1));
+					p->timer.async_wait([p](const asio::error_code&) {});
+				}
+			});
+
+			double cancel = elapsed_ms([&]()
+			{
+				for (std::shared_ptr<idle_session>& p : sessions)
+				{
+					p->timer.cancel();
+				}
+			});
+
+			// the arm bytes is the memory allocated by the async_wait, the wait handler is allocated
+			// when the timer is armed, it is not included in the timer bytes.
+			printf("%-14s %10zu %10.1f %10.1f %10.1f %12zu %12.1f\n", "steady_timer", count, arm, rearm,
+				cancel, sizeof(asio::steady_timer), double(mem2 - mem1) / double(count));
+
+			// the canceled handlers will be called after this function returns.
+			asio::post(iot->context(), [sessions = std::move(sessions)]() mutable
+			{
+				sessions.clear();
+			});
+		});
+
+		// the timing wheel
+		std::promise<void> promise;
+
+		asio::post(iot->context(), [&]()
+		{
+			asio2::detail::timing_wheel& wheel = iot->timing_wheel();
+
+			std::vector<std::shared_ptr<idle_session_wheel>> sessions;
+
+			sessions.reserve(count);
+
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				sessions.emplace_back(std::make_shared<idle_session_wheel>());
+			}
+
+			std::size_t mem1 = resident_memory();
+
+			double arm = elapsed_ms([&]()
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					std::shared_ptr<idle_session_wheel>& p = sessions[i];
+					wheel.add(p->node, timeout(i), [p](const asio::error_code&) mutable {});
+				}
+			});
+
+			std::size_t mem2 = resident_memory();
+
+			double rearm = elapsed_ms([&]()
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					std::shared_ptr<idle_session_wheel>& p = sessions[i];
+					wheel.add(p->node, timeout(i + 1), [p](const asio::error_code&) mutable {});
+				}
+			});
+
+			double cancel = elapsed_ms([&]()
+			{
+				for (std::shared_ptr<idle_session_wheel>& p : sessions)
+				{
+					wheel.cancel(p->node);
+				}
+			});
+
+			printf("%-14s %10zu %10.1f %10.1f %10.1f %12zu %12.1f\n", "timing_wheel", count, arm, rearm,
+				cancel, sizeof(asio2::detail::timing_wheel::node), double(mem2 - mem1) / double(count));
+
+			asio::post(iot->context(), [sessions = std::move(sessions), &promise]() mutable
+			{
+				sessions.clear();
+				promise.set_value();
+			});
+		});
+
+		promise.get_future().wait();
+	}
+
+	iopool.stop();
+
+	return 0;
+}
@@ -0,0 +1,106 @@
+#include <asio2/tcp/tcp_server.hpp>
+#include <asio2/tcp/tcp_client.hpp>
+
+// Measure the round trip latency of a 64 bytes ping-pong between a client and a server in the
+// same process, first with the normal blocking io_context threads, then with the busy poll mode
+// enabled on the server and client threads, prints the p50/p99/p999 of each mode.
+// the busy poll mode spins on the cpu, so run it on a machine which has free cores for the
+// server and client threads, otherwise the spinning threads steal the cpu from each other.
+// usage : bench_asio2_tcp_pingpong_latency [messages] [spin us] [SO_BUSY_POLL us]
+
+int main(int argc, char* argv[])
+{
+	std::size_t count = (argc > 1) ? std::size_t(std::strtoull(argv[1], nullptr, 10)) : std::size_t(100000);
+	std::chrono::microseconds spin(argc > 2 ? std::atoll(argv[2]) : 200);
+	std::chrono::microseconds sobp(argc > 3 ? std::atoll(argv[3]) : 0);
+
+	count = (std::max)(count, std::size_t(100));
+
+	printf("backend : %s, messages %zu, spin %lld us, SO_BUSY_POLL %lld us\n",
+		asio2::get_io_backend_name().data(), count, (long long)spin.count(), (long long)sobp.count());
+
+	const std::size_t msgsize = 64;
+
+	for (bool busy : { false, true })
+	{
+		std::vector<std::int64_t> samples;
+		std::chrono::steady_clock::time_point send_time;
+		std::size_t recvd = 0;
+		std::promise<void> promise;
+
+		samples.reserve(count);
+
+		asio2::tcp_server server(1);
+		asio2::tcp_client client;
+
+		if (busy)
+		{
+			server.set_busy_poll(0, spin, sobp);
+			client.set_busy_poll(0, spin, sobp);
+		}
+
+		server.bind_recv([&](std::shared_ptr<asio2::tcp_session>& session_ptr, std::string_view data)
+		{
+			session_ptr->async_send(asio::buffer(data));
+		});
+
+		client.bind_connect([&]()
+		{
+			if (asio2::get_last_error())
+				return;
+
+			send_time = std::chrono::steady_clock::now();
+
+			client.async_send(std::string(msgsize, 'A'));
+
+		}).bind_recv([&](std::string_view data)
+		{
+			// the tcp stream maybe split or merge the messages, a message is completed when the
+			// recvd bytes reach the message size.
+			recvd += data.size();
+			if (recvd < msgsize)
+				return;
+			recvd -= msgsize;
+
+			auto now = std::chrono::steady_clock::now();
+
+			samples.emplace_back(std::chrono::duration_cast<std::chrono::nanoseconds>(now - send_time).count());
+
+			if (samples.size() == count)
+			{
+				promise.set_value();
+				return;
+			}
+
+			send_time = std::chrono::steady_clock::now();
+
+			client.async_send(std::string(msgsize, 'A'));
+		});
+
+		if (!server.start("127.0.0.1", "18084"))
+		{
+			printf("start failed: %s\n", asio2::last_error_msg().data());
+			return 0;
+		}
+
+		if (!client.start("127.0.0.1", "18084"))
+		{
+			printf("connect failed: %s\n", asio2::last_error_msg().data());
+			return 0;
+		}
+
+		promise.get_future().wait();
+
+		client.stop();
+		server.stop();
+
+		std::sort(samples.begin(), samples.end());
+
+		printf("%-10s p50 %8.1f us | p99 %8.1f us | p999 %8.1f us\n", busy ? "busy poll" : "blocking",
+			double(samples[samples.size() * 500 / 1000]) / 1000.0,
+			double(samples[samples.size() * 990 / 1000]) / 1000.0,
+			double(samples[samples.size() * 999 / 1000]) / 1000.0);
+	}
+
+	return 0;
+}
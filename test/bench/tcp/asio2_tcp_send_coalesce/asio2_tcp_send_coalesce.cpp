@@ -0,0 +1,70 @@
+#include <asio2/tcp/tcp_server.hpp>
+#include <asio2/tcp/tcp_client.hpp>
+
+// Compare the messages/sec of many small async_send calls with and without the send coalesce.
+// usage : bench_asio2_tcp_send_coalesce [message count]
+
+int main(int argc, char* argv[])
+{
+	std::size_t count = (argc > 1) ? std::size_t(std::strtoull(argv[1], nullptr, 10)) : std::size_t(200000);
+
+	asio2::tcp_server server;
+
+	std::atomic<std::size_t> recvd_bytes = 0;
+
+	server.bind_recv([&](std::shared_ptr<asio2::tcp_session>&, std::string_view data)
+	{
+		recvd_bytes += data.size();
+	});
+
+	if (!server.start("127.0.0.1", "18082"))
+	{
+		printf("start failed: %s\n", asio2::last_error_msg().data());
+		return 0;
+	}
+
+	for (std::size_t size : { 16, 64, 128, 256 })
+	{
+		for (bool coalesce : { false, true })
+		{
+			asio2::tcp_client client;
+
+			client.set_send_coalesce(coalesce);
+
+			if (!client.start("127.0.0.1", "18082"))
+			{
+				printf("connect failed: %s\n", asio2::last_error_msg().data());
+				return 0;
+			}
+
+			recvd_bytes = 0;
+
+			std::string msg(size, 'A');
+
+			auto t1 = std::chrono::steady_clock::now();
+
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				client.async_send(asio::buffer(msg)); // no allocate memory
+			}
+
+			while (recvd_bytes < count * size)
+			{
+				std::this_thread::sleep_for(std::chrono::microseconds(100));
+			}
+
+			auto t2 = std::chrono::steady_clock::now();
+
+			double secs = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
+
+			printf("payload %3zu bytes, coalesce %-3s : %10.0lf msgs/sec\n",
+				size, coalesce ? "on" : "off", double(count) / secs);
+
+			client.stop();
+		}
+	}
+
+	server.stop();
+
+	return 0;
+}
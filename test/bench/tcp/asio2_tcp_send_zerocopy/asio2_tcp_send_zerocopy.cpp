@@ -0,0 +1,125 @@
+#include <asio2/tcp/tcp_server.hpp>
+#include <asio2/tcp/tcp_client.hpp>
+
+// Compare the throughput of large async_send calls with the normal send (_tcp_send_general)
+// and with the MSG_ZEROCOPY send.
+// The kernel copies the data on the loopback device and reports it, then the zero copy send
+// turns back to the normal send, so run the server and the client on different hosts to
+// measure the zero copy send :
+// usage : bench_asio2_tcp_send_zerocopy server [port] [megabytes per payload size]
+//         bench_asio2_tcp_send_zerocopy [host] [port] [megabytes per payload size]
+// the megabytes must be the same on both sides. when the host is 127.0.0.1, the server is
+// started in this process too. press enter to stop the server.
+
+int main(int argc, char* argv[])
+{
+	bool server_only = (argc > 1 && std::string_view(argv[1]) == "server");
+
+	std::string host = (argc > 1 && !server_only) ? argv[1] : "127.0.0.1";
+	std::string port = (argc > 2) ? argv[2] : "18093";
+
+	std::size_t megabytes = (argc > 3) ? std::size_t(std::strtoull(argv[3], nullptr, 10)) : std::size_t(2048);
+
+	asio2::tcp_server server;
+
+	std::atomic<std::size_t> recvd_bytes = 0;
+
+	server.bind_recv([&](std::shared_ptr<asio2::tcp_session>& session_ptr, std::string_view data)
+	{
+		recvd_bytes += data.size();
+
+		// report the received bytes to the client with 8 bytes.
+		if (recvd_bytes >= session_ptr->get_user_data<std::size_t>())
+		{
+			std::size_t bytes = recvd_bytes.exchange(0);
+			session_ptr->async_send(std::string(reinterpret_cast<const char*>(&bytes), sizeof(bytes)));
+		}
+	}).bind_connect([&](std::shared_ptr<asio2::tcp_session>& session_ptr)
+	{
+		recvd_bytes = 0;
+		session_ptr->set_user_data(megabytes * 1024 * 1024);
+	});
+
+	if (server_only || host == "127.0.0.1")
+	{
+		if (!server.start("0.0.0.0", port))
+		{
+			printf("start failed: %s\n", asio2::last_error_msg().data());
+			return 0;
+		}
+	}
+
+	if (server_only)
+	{
+		std::getchar();
+
+		server.stop();
+
+		return 0;
+	}
+
+	for (std::size_t size : { 16 * 1024, 64 * 1024, 256 * 1024, 1024 * 1024 })
+	{
+		for (bool zerocopy : { false, true })
+		{
+			asio2::tcp_client client;
+
+			std::promise<void> finished;
+
+			client.set_send_zerocopy(zerocopy, 16 * 1024);
+
+			client.bind_recv([&](std::string_view data)
+			{
+				asio2::ignore_unused(data);
+
+				finished.set_value();
+			});
+
+			if (!client.start(host, port))
+			{
+				printf("connect failed: %s\n", asio2::last_error_msg().data());
+				return 0;
+			}
+
+			// the same memory is sent again and again, no allocation and no fill in the loop.
+			asio2::shared_buffer payload(std::string(size, 'A'));
+
+			std::size_t count = megabytes * 1024 * 1024 / size;
+
+			std::size_t posted = 0;
+
+			// keep a fixed number of sends in the event queue.
+			std::function<void()> send_next = [&]()
+			{
+				if (posted < count)
+				{
+					++posted;
+					client.async_send(payload, [&]() { send_next(); });
+				}
+			};
+
+			auto t1 = std::chrono::steady_clock::now();
+
+			client.post([&]()
+			{
+				for (int i = 0; i < 64; ++i)
+					send_next();
+			});
+
+			finished.get_future().wait();
+
+			auto t2 = std::chrono::steady_clock::now();
+
+			double secs = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
+
+			printf("payload %7zu bytes, zerocopy %-3s : %8.1lf MB/sec\n",
+				size, zerocopy ? "on" : "off", double(count * size) / 1024.0 / 1024.0 / secs);
+
+			client.stop();
+		}
+	}
+
+	server.stop();
+
+	return 0;
+}
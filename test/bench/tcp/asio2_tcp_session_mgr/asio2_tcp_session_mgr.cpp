@@ -0,0 +1,234 @@
+#include <asio2/tcp/tcp_server.hpp>
+
+// Compare the session_mgr_t with a single locked session map (the old implementation) under
+// many threads, the operations are : emplace, find, for_each, find with sessions churn, erase.
+// usage : bench_asio2_tcp_session_mgr [sessions] [threads]
+
+struct bench_args {};
+
+struct bench_session
+{
+	using args_type = bench_args;
+	using key_type  = std::size_t;
+
+	inline key_type hash_key() const noexcept { return reinterpret_cast<key_type>(this); }
+};
+
+// The session map with one rwlock, the for_each copies all the sessions on each call.
+class single_lock_mgr
+{
+public:
+	explicit single_lock_mgr(std::shared_ptr<asio2::io_t> iot) : io_(std::move(iot)) {}
+
+	template<class Fun>
+	inline void emplace(std::shared_ptr<bench_session> p, Fun&& callback)
+	{
+		asio::dispatch(io_->context(), [this, p = std::move(p), callback = std::forward<Fun>(callback)]() mutable
+		{
+			bool inserted = false;
+			{
+				asio2::unique_locker guard(this->mutex_);
+				inserted = this->sessions_.try_emplace(p->hash_key(), p).second;
+			}
+			callback(inserted);
+		});
+	}
+
+	template<class Fun>
+	inline void erase(std::shared_ptr<bench_session> p, Fun&& callback)
+	{
+		asio::dispatch(io_->context(), [this, p = std::move(p), callback = std::forward<Fun>(callback)]() mutable
+		{
+			bool erased = false;
+			{
+				asio2::unique_locker guard(this->mutex_);
+				erased = (this->sessions_.erase(p->hash_key()) > 0);
+			}
+			callback(erased);
+		});
+	}
+
+	inline asio2::io_t& io() noexcept { return *io_; }
+
+	inline std::shared_ptr<bench_session> find(std::size_t key)
+	{
+		asio2::shared_locker guard(this->mutex_);
+		auto iter = this->sessions_.find(key);
+		return (iter == this->sessions_.end() ? std::shared_ptr<bench_session>() : iter->second);
+	}
+
+	template<class Fun>
+	inline void for_each(Fun&& fn)
+	{
+		std::vector<std::shared_ptr<bench_session>> sessions;
+		{
+			asio2::shared_locker guard(this->mutex_);
+			sessions.reserve(this->sessions_.size());
+			for (auto& [k, p] : this->sessions_)
+			{
+				std::ignore = k;
+				sessions.emplace_back(p);
+			}
+		}
+		for (std::shared_ptr<bench_session>& p : sessions)
+			fn(p);
+	}
+
+	std::shared_ptr<asio2::io_t> io_;
+	asio2::shared_mutexer mutex_;
+	std::unordered_map<std::size_t, std::shared_ptr<bench_session>> sessions_;
+};
+
+template<class Fun>
+static double run_threads(int threads, Fun&& fun)
+{
+	auto t1 = std::chrono::steady_clock::now();
+	std::vector<std::thread> v;
+	for (int i = 0; i < threads; ++i)
+		v.emplace_back([&fun, i]() { fun(i); });
+	for (std::thread& t : v)
+		t.join();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t1).count();
+}
+
+template<class Mgr>
+static void bench(const char* name, Mgr& mgr, std::vector<std::shared_ptr<bench_session>>& sessions, int threads)
+{
+	std::size_t count = sessions.size();
+	std::size_t finds = 200000; // per thread
+	int loops = 3;              // for_each per thread
+	std::atomic<std::size_t> done = 0, found = 0;
+
+	// emplace
+	double emplace_ms = run_threads(threads, [&](int t)
+	{
+		for (std::size_t i = std::size_t(t); i < count; i += std::size_t(threads))
+			mgr.emplace(sessions[i], [&done](bool) { done++; });
+	});
+	while (done < count)
+		std::this_thread::yield();
+
+	// find
+	double find_ms = run_threads(threads, [&](int t)
+	{
+		std::minstd_rand rand(t);
+		std::size_t n = 0;
+		for (std::size_t i = 0; i < finds; ++i)
+			n += (mgr.find(sessions[rand() % count]->hash_key()) != nullptr);
+		found += n;
+	});
+
+	// find in the io_context thread, like the udp server finds the session for each datagram
+	std::promise<double> promise;
+	asio::post(mgr.io().context(), [&]()
+	{
+		std::minstd_rand rand(0);
+		std::size_t n = 0;
+		auto t1 = std::chrono::steady_clock::now();
+		for (std::size_t i = 0; i < finds; ++i)
+			n += (mgr.find(sessions[rand() % count]->hash_key()) != nullptr);
+		found += n;
+		promise.set_value(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t1).count());
+	});
+	double io_find_ms = promise.get_future().get();
+
+	// for_each
+	std::atomic<std::size_t> visited = 0;
+	double for_each_ms = run_threads(threads, [&](int)
+	{
+		for (int i = 0; i < loops; ++i)
+		{
+			std::size_t n = 0;
+			mgr.for_each([&n](std::shared_ptr<bench_session>&) { n++; });
+			visited += n;
+		}
+	});
+
+	// find while one thread is erasing and emplacing the sessions, the churn thread waits for
+	// each batch to complete, so the io_context queue doesn't grow without limit.
+	std::atomic<bool> churn_stop = false;
+	std::thread churn([&]()
+	{
+		std::size_t i = 0;
+		while (!churn_stop)
+		{
+			std::atomic<std::size_t> batch = 0;
+			for (std::size_t n = 0; n < 1000; ++n)
+			{
+				std::shared_ptr<bench_session>& p = sessions[i++ % count];
+				mgr.erase(p, [&mgr, &batch, p](bool) mutable
+				{
+					mgr.emplace(std::move(p), [&batch](bool) { batch++; });
+				});
+			}
+			while (batch < 1000)
+				std::this_thread::yield();
+		}
+	});
+	double churn_ms = run_threads((std::max)(threads - 1, 1), [&](int t)
+	{
+		std::minstd_rand rand(t + 100);
+		for (std::size_t i = 0; i < finds; ++i)
+			mgr.find(sessions[rand() % count]->hash_key());
+	});
+	churn_stop = true;
+	churn.join();
+
+	// erase
+	std::atomic<std::size_t> erased = 0;
+	double erase_ms = run_threads(threads, [&](int t)
+	{
+		for (std::size_t i = std::size_t(t); i < count; i += std::size_t(threads))
+			mgr.erase(sessions[i], [&erased](bool) { erased++; });
+	});
+	while (erased < count)
+		std::this_thread::yield();
+
+	double total_finds = double(finds) * double(threads);
+
+	printf("%-14s emplace %7.1f ms | find %6.2f Mops/s | io thread find %6.2f Mops/s | "
+		"for_each %7.2f ms/call | find+churn %6.2f Mops/s | erase %7.1f ms\n",
+		name, emplace_ms, total_finds / find_ms / 1000.0, double(finds) / io_find_ms / 1000.0,
+		for_each_ms / double(threads * loops),
+		double(finds) * double((std::max)(threads - 1, 1)) / churn_ms / 1000.0, erase_ms);
+}
+
+int main(int argc, char* argv[])
+{
+	std::size_t count = (argc > 1) ? std::size_t(std::strtoull(argv[1], nullptr, 10)) : 1000000;
+	int threads = (argc > 2) ? std::atoi(argv[2]) : 16;
+
+	count = (std::max)(count, std::size_t(1));
+	threads = (std::max)(threads, 1);
+
+	asio2::iopool iopool(1);
+
+	iopool.start();
+
+	std::vector<std::shared_ptr<bench_session>> sessions;
+
+	sessions.reserve(count);
+
+	for (std::size_t i = 0; i < count; ++i)
+		sessions.emplace_back(std::make_shared<bench_session>());
+
+	printf("sessions %zu, threads %d\n", count, threads);
+
+	{
+		single_lock_mgr mgr(iopool.get(0));
+
+		bench("single lock", mgr, sessions, threads);
+	}
+
+	{
+		std::atomic<asio2::detail::state_t> state = asio2::detail::state_t::started;
+
+		asio2::detail::session_mgr_t<bench_session> mgr(iopool.get(0), state);
+
+		bench("session_mgr_t", mgr, sessions, threads);
+	}
+
+	iopool.stop();
+
+	return 0;
+}
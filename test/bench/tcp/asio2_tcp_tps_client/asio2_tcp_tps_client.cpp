@@ -1,25 +1,77 @@
 #include <asio2/tcp/tcp_client.hpp>
 
-int main()
+// usage : bench_asio2_tcp_tps_client [latency]
+// default : send the received data back as fast as possible, the server prints the throughput.
+// latency : send a 64 bytes message and wait for the echo, then send the next message, prints
+//           the round trip p50/p99 latency every second.
+// build with -DASIO2_ENABLE_IO_URING=ON to compare the io_uring backend with the epoll backend.
+
+int main(int argc, char* argv[])
 {
+	bool latency = (argc > 1 && std::string_view(argv[1]) == "latency");
+
+	printf("backend : %s, mode : %s\n", asio2::get_io_backend_name().data(), latency ? "latency" : "tps");
+
+	std::vector<std::int64_t> samples;
+	std::chrono::steady_clock::time_point send_time, report_time;
+	std::size_t recvd = 0;
+	std::size_t msgsize = 64;
+
 	asio2::tcp_client client;
 
 	client.bind_connect([&]()
 	{
-		std::string strmsg(1024, 'A');
+		if (asio2::get_last_error())
+			return;
 
-		if (!asio2::get_last_error())
-			client.async_send(std::move(strmsg));
+		report_time = std::chrono::steady_clock::now();
+		send_time = std::chrono::steady_clock::now();
+
+		client.async_send(std::string(latency ? msgsize : std::size_t(1024), 'A'));
 
 	}).bind_recv([&](std::string_view data)
 	{
-		client.async_send(asio::buffer(data)); // no allocate memory
-		//client.async_send(data); // allocate memory
+		if (!latency)
+		{
+			client.async_send(asio::buffer(data)); // no allocate memory
+			//client.async_send(data); // allocate memory
+			return;
+		}
+
+		// the tcp stream maybe split or merge the messages, a message is completed when the
+		// recvd bytes reach the message size.
+		recvd += data.size();
+		if (recvd < msgsize)
+			return;
+		recvd -= msgsize;
+
+		auto now = std::chrono::steady_clock::now();
+
+		samples.emplace_back(std::chrono::duration_cast<std::chrono::nanoseconds>(now - send_time).count());
+
+		if (now - report_time >= std::chrono::seconds(1))
+		{
+			std::sort(samples.begin(), samples.end());
+
+			printf("%zu msg/sec, p50 %.1lf us, p99 %.1lf us\n", samples.size(),
+				double(samples[samples.size() * 50 / 100]) / 1000.0,
+				double(samples[samples.size() * 99 / 100]) / 1000.0);
+
+			samples.clear();
+
+			report_time = now;
+		}
+
+		send_time = std::chrono::steady_clock::now();
+
+		client.async_send(std::string(msgsize, 'A'));
 	});
 
 	client.start("127.0.0.1", "8080");
 
 	while (std::getchar() != '\n');
 
+	client.stop();
+
 	return 0;
 }
@@ -7,6 +7,8 @@ bool first = true;
 
 int main()
 {
+	printf("backend : %s\n", asio2::get_io_backend_name().data());
+
 	asio2::tcp_server server;
 
 	server.bind_recv([&](std::shared_ptr<asio2::tcp_session>& session_ptr, std::string_view data)
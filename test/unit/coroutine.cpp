@@ -0,0 +1,334 @@
+#include "unit_test.hpp"
+#include <asio2/tcp/tcp_server.hpp>
+#include <asio2/tcp/tcp_client.hpp>
+#include <asio2/udp/udp_server.hpp>
+#include <asio2/udp/udp_client.hpp>
+#include <asio2/rpc/rpc_server.hpp>
+#include <asio2/rpc/rpc_client.hpp>
+#include <asio2/http/http_server.hpp>
+#include <asio2/http/http_client.hpp>
+
+// the awaitable apis need the c++20 coroutine, this test is built with c++20.
+
+void coroutine_test()
+{
+	ASIO2_TEST_BEGIN_LOOP(test_loop_times);
+
+#if defined(ASIO_HAS_CO_AWAIT)
+	// tcp : async_start, async_send and async_recv of the client and the session
+	{
+		asio2::tcp_server server;
+
+		std::atomic<int> server_recv_counter = 0;
+
+		server.bind_accept([&](std::shared_ptr<asio2::tcp_session>& session_ptr)
+		{
+			// the messages maybe received before the coroutine calls async_recv.
+			session_ptr->set_async_recv(true);
+
+		}).bind_connect([&](std::shared_ptr<asio2::tcp_session>& session_ptr)
+		{
+			// echo the messages with a coroutine which runs on the session's io thread.
+			asio::co_spawn(session_ptr->io().context(),
+			[&server_recv_counter, session_ptr]() -> asio::awaitable<void>
+			{
+				for (;;)
+				{
+					auto [ec, msg] = co_await session_ptr->async_recv(asio::as_tuple(asio::use_awaitable));
+					if (ec)
+						break;
+
+					ASIO2_CHECK(session_ptr->io().running_in_this_thread());
+
+					server_recv_counter++;
+
+					auto [ec2, bytes] = co_await session_ptr->async_send(std::move(msg),
+						asio::as_tuple(asio::use_awaitable));
+					if (ec2)
+						break;
+
+					ASIO2_CHECK(session_ptr->io().running_in_this_thread());
+				}
+			}, asio::detached);
+		});
+
+		bool server_start_ret = server.start("127.0.0.1", 18070, '\n');
+
+		ASIO2_CHECK(server_start_ret);
+
+		asio2::tcp_client client;
+
+		client.set_async_recv(true);
+
+		std::atomic<int> client_step = 0;
+		std::string      client_error;
+
+		// the client's iopool isn't running before the start, so the coroutine which starts
+		// the client runs on the server's io_context.
+		asio::co_spawn(server.io().context(), [&]() -> asio::awaitable<void>
+		{
+			auto [ec] = co_await client.async_start("127.0.0.1", 18070, '\n', asio::as_tuple(asio::use_awaitable));
+			if (ec) { client_error = ec.message(); co_return; }
+
+			ASIO2_CHECK(client.is_started());
+
+			client_step = 1;
+
+			auto [ec2] = co_await client.async_start("127.0.0.1", 18070, '\n', asio::as_tuple(asio::use_awaitable));
+			ASIO2_CHECK_VALUE(ec2.message(), ec2 == asio::error::already_started);
+
+			client_step = 2;
+		}, asio::detached);
+
+		while (client_step < 2 && client_error.empty())
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		ASIO2_CHECK_VALUE(client_error, client_error.empty());
+
+		// the coroutine which runs on the client's io_context is resumed on the io thread.
+		asio::co_spawn(client.io().context(), [&]() -> asio::awaitable<void>
+		{
+			for (int i = 0; i < 10; ++i)
+			{
+				std::string s = std::to_string(i) + "\n";
+
+				std::size_t bytes = co_await client.async_send(s, asio::use_awaitable);
+				ASIO2_CHECK_VALUE(bytes, bytes == s.size());
+				ASIO2_CHECK(client.io().running_in_this_thread());
+
+				auto [ec, msg] = co_await client.async_recv(asio::as_tuple(asio::use_awaitable));
+				ASIO2_CHECK_VALUE(ec.message(), !ec);
+				ASIO2_CHECK_VALUE(msg, msg == s);
+				ASIO2_CHECK(client.io().running_in_this_thread());
+			}
+
+			char buf[] = { 'a', 'b', '\n' };
+			std::size_t bytes = co_await client.async_send(buf, 3, asio::use_awaitable);
+			ASIO2_CHECK_VALUE(bytes, bytes == 3);
+
+			auto [ec, msg] = co_await client.async_recv(asio::as_tuple(asio::use_awaitable));
+			ASIO2_CHECK_VALUE(msg, msg == "ab\n");
+
+			client_step = 3;
+
+			// the waiting async_recv is completed with error when the client is stopped.
+			auto [ec2, msg2] = co_await client.async_recv(asio::as_tuple(asio::use_awaitable));
+			ASIO2_CHECK(ec2);
+			ASIO2_CHECK(msg2.empty());
+
+			client_step = 4;
+		}, asio::detached);
+
+		while (client_step < 3)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		ASIO2_CHECK_VALUE(server_recv_counter.load(), server_recv_counter == 11);
+
+		client.stop();
+
+		while (client_step < 4)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		// connect failed
+		asio2::tcp_client client2;
+
+		std::atomic<int> client2_step = 0;
+
+		asio::co_spawn(server.io().context(), [&]() -> asio::awaitable<void>
+		{
+			auto [ec] = co_await client2.async_start("127.0.0.1", 18079, asio::as_tuple(asio::use_awaitable));
+			ASIO2_CHECK(ec);
+			ASIO2_CHECK(!client2.is_started());
+
+			// not connected
+			auto [ec2, bytes] = co_await client2.async_send("abc", asio::as_tuple(asio::use_awaitable));
+			ASIO2_CHECK(ec2);
+			ASIO2_CHECK(bytes == 0);
+
+			client2_step = 1;
+		}, asio::detached);
+
+		while (client2_step < 1)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		client2.stop();
+		server.stop();
+	}
+
+	// udp : async_start, async_send and async_recv
+	{
+		asio2::udp_server server;
+
+		server.bind_recv([&](std::shared_ptr<asio2::udp_session>& session_ptr, std::string_view data)
+		{
+			session_ptr->async_send(data);
+		});
+
+		bool server_start_ret = server.start("127.0.0.1", 18071);
+
+		ASIO2_CHECK(server_start_ret);
+
+		asio2::udp_client client;
+
+		client.set_async_recv(true);
+
+		std::atomic<int> client_step = 0;
+
+		asio::co_spawn(server.io().context(), [&]() -> asio::awaitable<void>
+		{
+			auto [ec] = co_await client.async_start("127.0.0.1", 18071, asio::as_tuple(asio::use_awaitable));
+			ASIO2_CHECK_VALUE(ec.message(), !ec);
+
+			for (int i = 0; i < 10; ++i)
+			{
+				std::string s = std::to_string(i);
+
+				co_await client.async_send(s, asio::use_awaitable);
+
+				auto [ec2, msg] = co_await client.async_recv(asio::as_tuple(asio::use_awaitable));
+				ASIO2_CHECK_VALUE(ec2.message(), !ec2);
+				ASIO2_CHECK_VALUE(msg, msg == s);
+			}
+
+			client_step = 1;
+		}, asio::detached);
+
+		while (client_step < 1)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		client.stop();
+		server.stop();
+	}
+
+	// rpc : async_call
+	{
+		asio2::rpc_server server;
+
+		server.bind("add", [](int a, int b) { return a + b; });
+		server.bind("echo", [](std::string s) { return s; });
+		server.bind("nop", []() {});
+
+		bool server_start_ret = server.start("127.0.0.1", 18072);
+
+		ASIO2_CHECK(server_start_ret);
+
+		asio2::rpc_client client;
+
+		std::atomic<int> client_step = 0;
+
+		asio::co_spawn(server.io().context(), [&]() -> asio::awaitable<void>
+		{
+			co_await client.async_start("127.0.0.1", 18072, asio::use_awaitable);
+
+			client_step = 1;
+		}, asio::detached);
+
+		while (client_step < 1)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		asio::co_spawn(client.io().context(), [&]() -> asio::awaitable<void>
+		{
+			for (int i = 0; i < 10; ++i)
+			{
+				auto [ec, sum] = co_await client.async_call<int>(asio::as_tuple(asio::use_awaitable), "add", i, 1);
+				ASIO2_CHECK_VALUE(ec.message(), !ec);
+				ASIO2_CHECK_VALUE(sum, sum == i + 1);
+				ASIO2_CHECK(client.io().running_in_this_thread());
+			}
+
+			std::string s = co_await client.async_call<std::string>(asio::use_awaitable,
+				std::chrono::seconds(5), "echo", std::string("abc"));
+			ASIO2_CHECK_VALUE(s, s == "abc");
+
+			auto [ec1] = co_await client.async_call<void>(asio::as_tuple(asio::use_awaitable), "nop");
+			ASIO2_CHECK_VALUE(ec1.message(), !ec1);
+
+			auto [ec2, n] = co_await client.async_call<int>(asio::as_tuple(asio::use_awaitable), "no_exists");
+			ASIO2_CHECK(ec2 == rpc::error::not_found);
+
+			asio::error_code ec3;
+			co_await client.async_call<int>(asio::redirect_error(asio::use_awaitable, ec3), "add", 1);
+			ASIO2_CHECK(ec3);
+
+			client_step = 2;
+		}, asio::detached);
+
+		while (client_step < 2)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		client.stop();
+		server.stop();
+	}
+
+	// http : async_call with a request
+	{
+		asio2::http_server server;
+
+		server.bind<http::verb::get>("/hello", [](http::web_request& req, http::web_response& rep)
+		{
+			asio2::ignore_unused(req);
+
+			rep.fill_text("hello world");
+		});
+
+		bool server_start_ret = server.start("127.0.0.1", 18073);
+
+		ASIO2_CHECK(server_start_ret);
+
+		asio2::http_client client;
+
+		std::atomic<int> client_step = 0;
+
+		asio::co_spawn(server.io().context(), [&]() -> asio::awaitable<void>
+		{
+			auto [ec] = co_await client.async_start("127.0.0.1", 18073, asio::as_tuple(asio::use_awaitable));
+			ASIO2_CHECK_VALUE(ec.message(), !ec);
+
+			for (int i = 0; i < 5; ++i)
+			{
+				http::web_request req(http::verb::get, "/hello", 11);
+				req.set(http::field::host, "127.0.0.1");
+				req.keep_alive(true);
+
+				auto [ec2, rep] = co_await client.async_call(req, asio::as_tuple(asio::use_awaitable));
+				ASIO2_CHECK_VALUE(ec2.message(), !ec2);
+				ASIO2_CHECK(rep.result() == http::status::ok);
+				ASIO2_CHECK_VALUE(rep.body().text(), rep.body().text() == "hello world");
+			}
+
+			client_step = 1;
+		}, asio::detached);
+
+		while (client_step < 1)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		client.stop();
+		server.stop();
+	}
+#endif
+
+	ASIO2_TEST_END_LOOP;
+}
+
+
+ASIO2_TEST_SUITE
+(
+	"coroutine",
+	ASIO2_TEST_CASE(coroutine_test)
+)
@@ -302,6 +302,88 @@ void http1_test()
 		// ......
 	}
 
+	// the file body is sent by async_send_file
+	{
+		std::filesystem::path filepath = std::filesystem::temp_directory_path() / "asio2_http_send_file_test.txt";
+
+		std::string content(200 * 1024 + 3, '\0');
+		for (std::size_t i = 0; i < content.size(); ++i)
+			content[i] = static_cast<char>('a' + (i * 3 + i / 17) % 26);
+
+		{
+			std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+			file.write(content.data(), std::streamsize(content.size()));
+		}
+
+		asio2::http_server server;
+
+		server.set_root_directory(std::filesystem::temp_directory_path());
+
+		server.bind<http::verb::get>("/file", [](http::web_request& req, http::web_response& rep)
+		{
+			asio2::ignore_unused(req);
+
+			rep.fill_file("/asio2_http_send_file_test.txt");
+		});
+
+		server.bind<http::verb::get>("/text", [](http::web_request& req, http::web_response& rep)
+		{
+			asio2::ignore_unused(req);
+
+			rep.fill_text("text");
+		});
+
+		bool server_start_ret = server.start("127.0.0.1", 18044);
+
+		ASIO2_CHECK(server_start_ret);
+
+		asio2::http_client client;
+
+		std::atomic<int> counter = 0;
+
+		client.bind_recv([&](http::web_request& req, http::web_response& rep)
+		{
+			asio2::ignore_unused(req);
+
+			if (counter == 0 || counter == 2)
+			{
+				ASIO2_CHECK(rep.result() == http::status::ok);
+				ASIO2_CHECK(rep.body().text() == content);
+			}
+			else
+			{
+				ASIO2_CHECK(rep.body().text() == "text");
+			}
+
+			// the keep alive connection is reused after the file body is sent.
+			if (++counter < 3)
+			{
+				client.async_send(counter == 1 ?
+					"GET /text HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n" :
+					"GET /file HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n");
+			}
+		}).bind_connect([&]()
+		{
+			if (!asio2::get_last_error())
+				client.async_send("GET /file HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n");
+		});
+
+		bool client_start_ret = client.start("127.0.0.1", 18044);
+
+		ASIO2_CHECK(client_start_ret);
+
+		while (client_start_ret && counter < 3)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		client.stop();
+		server.stop();
+
+		std::error_code ec;
+		std::filesystem::remove(filepath, ec);
+	}
+
 	ASIO2_TEST_END_LOOP;
 }
 
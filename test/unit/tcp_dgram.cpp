@@ -2158,6 +2158,81 @@ void tcp_dgram_test()
 		ASIO2_CHECK_VALUE(server_stop_counter.load(), server_stop_counter == 1);
 	}
 
+	// test send coalesce
+	{
+		asio2::tcp_server server;
+
+		std::vector<std::string> server_recv_msgs;
+		std::atomic<int> server_recv_counter = 0;
+		server.bind_accept([&](std::shared_ptr<asio2::tcp_session> & session_ptr)
+		{
+			session_ptr->set_send_coalesce(true);
+		});
+		server.bind_recv([&](std::shared_ptr<asio2::tcp_session> & session_ptr, std::string_view data)
+		{
+			server_recv_msgs.emplace_back(data);
+			server_recv_counter++;
+
+			session_ptr->async_send(data);
+		});
+
+		bool server_start_ret = server.start("127.0.0.1", 18027, asio2::use_dgram);
+
+		ASIO2_CHECK(server_start_ret);
+
+		asio2::tcp_client client;
+
+		client.set_send_coalesce(true);
+
+		std::vector<std::string> expected_msgs;
+		std::vector<std::string> client_recv_msgs;
+		std::atomic<int> client_recv_counter = 0;
+		std::atomic<int> client_send_counter = 0;
+		client.bind_recv([&](std::string_view data)
+		{
+			client_recv_msgs.emplace_back(data);
+			client_recv_counter++;
+		});
+
+		bool client_start_ret = client.start("127.0.0.1", 18027, asio2::use_dgram);
+
+		ASIO2_CHECK(client_start_ret);
+
+		// use different size to test the 1 byte, 3 bytes and 9 bytes head.
+		for (int i = 0; i < 300; i++)
+		{
+			std::size_t size = (i % 3 == 0) ? std::size_t(1 + i) : ((i % 3 == 1) ? std::size_t(300 + i) : std::size_t(65536 + i));
+			std::string msg(size, chars[i % chars.size()]);
+			expected_msgs.emplace_back(msg);
+
+			client.async_send(std::move(msg), [&, size](std::size_t bytes_sent)
+			{
+				ASIO2_CHECK(!asio2::get_last_error());
+				ASIO2_CHECK(bytes_sent == size);
+				client_send_counter++;
+			});
+		}
+
+		while (client_send_counter < 300)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		while (client_recv_counter < 300)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		client.stop();
+		ASIO2_CHECK(client.is_stopped());
+
+		server.stop();
+		ASIO2_CHECK(server.is_stopped());
+
+		ASIO2_CHECK(server_recv_msgs == expected_msgs);
+		ASIO2_CHECK(client_recv_msgs == expected_msgs);
+	}
+
 	ASIO2_TEST_END_LOOP;
 }
 
@@ -1,3 +1,6 @@
+#define ASIO2_ENABLE_METRICS
+#define ASIO2_ENABLE_TRACE
+
 #include "unit_test.hpp"
 #include <iostream>
 #include <asio2/external/asio.hpp>
@@ -25,6 +28,24 @@ namespace boost::asio
 #include <asio2/tcp/tcp_server.hpp>
 #include <asio2/tcp/tcp_client.hpp>
 
+class filter_tcp_session : public asio2::tcp_session_t<filter_tcp_session>
+{
+public:
+	template<class... Args>
+	filter_tcp_session(Args&&... args) : asio2::tcp_session_t<filter_tcp_session>(std::forward<Args>(args)...)
+	{
+	}
+
+	template<class T>
+	inline auto data_filter_before_send(T&& data)
+	{
+		filter_counter++;
+		return std::forward<T>(data);
+	}
+
+	inline static std::atomic<int> filter_counter = 0;
+};
+
 static std::string_view chars = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
 
 void tcp_general_test()
@@ -3855,6 +3876,1899 @@ void tcp_general_test()
 		ASIO2_CHECK_VALUE(server_stop_counter      .load(), server_stop_counter       == 1);
 	}
 
+	// test send coalesce
+	{
+		asio2::tcp_server server;
+
+		std::string server_recv_data;
+		std::atomic<std::size_t> server_recv_size = 0;
+		server.bind_accept([&](std::shared_ptr<asio2::tcp_session> & session_ptr)
+		{
+			session_ptr->set_send_coalesce(true);
+
+			ASIO2_CHECK(session_ptr->is_send_coalesce());
+		});
+		server.bind_recv([&](std::shared_ptr<asio2::tcp_session> & session_ptr, std::string_view data)
+		{
+			server_recv_data += data;
+			server_recv_size += data.size();
+
+			// the data will be copied into a std::string
+			session_ptr->async_send(data);
+		});
+
+		bool server_start_ret = server.start("127.0.0.1", 18028);
+
+		ASIO2_CHECK(server_start_ret);
+
+		asio2::tcp_client client;
+
+		client.set_send_coalesce(true);
+
+		ASIO2_CHECK(client.is_send_coalesce());
+
+		std::string expected_data;
+		std::string client_recv_data;
+		std::atomic<std::size_t> client_recv_size = 0;
+		std::atomic<int> client_send_counter = 0;
+		std::atomic<std::size_t> client_send_bytes = 0;
+		client.bind_connect([&]()
+		{
+			ASIO2_CHECK(!asio2::get_last_error());
+
+			// send in the io_context thread
+			for (int i = 0; i < 10; i++)
+			{
+				client.async_send(chars.substr(i, 1), [&](std::size_t bytes_sent)
+				{
+					ASIO2_CHECK(!asio2::get_last_error());
+					ASIO2_CHECK(bytes_sent == 1);
+					ASIO2_CHECK(client.io().running_in_this_thread());
+					client_send_counter++;
+					client_send_bytes += bytes_sent;
+				});
+			}
+		});
+		client.bind_recv([&](std::string_view data)
+		{
+			client_recv_data += data;
+			client_recv_size += data.size();
+		});
+
+		for (int i = 0; i < 10; i++)
+		{
+			expected_data += chars.substr(i, 1);
+		}
+
+		bool client_start_ret = client.start("127.0.0.1", 18028);
+
+		ASIO2_CHECK(client_start_ret);
+
+		// send in the user thread, the order must be kept.
+		for (int i = 0; i < 1000; i++)
+		{
+			std::string msg = std::to_string(i);
+			msg += ';';
+			expected_data += msg;
+
+			std::size_t size = msg.size();
+			client.async_send(std::move(msg), [&, size](std::size_t bytes_sent)
+			{
+				ASIO2_CHECK(!asio2::get_last_error());
+				ASIO2_CHECK(bytes_sent == size);
+				client_send_counter++;
+				client_send_bytes += bytes_sent;
+			});
+		}
+
+		auto future = client.async_send("xyz", asio::use_future);
+		expected_data += "xyz";
+		auto [ec, bytes] = future.get();
+		ASIO2_CHECK(!ec);
+		ASIO2_CHECK(bytes == std::size_t(3));
+
+		std::size_t sent = client.send("uvw");
+		expected_data += "uvw";
+		ASIO2_CHECK(sent == std::size_t(3));
+
+		while (client_send_counter < 1010)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		while (client_recv_size < expected_data.size())
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		client.stop();
+		ASIO2_CHECK(client.is_stopped());
+
+		// the datas can't be sent after stopped.
+		client.async_send("abc", [](std::size_t bytes_sent)
+		{
+			ASIO2_CHECK(asio2::get_last_error() == asio::error::not_connected);
+			ASIO2_CHECK(bytes_sent == 0);
+		});
+
+		server.stop();
+		ASIO2_CHECK(server.is_stopped());
+
+		ASIO2_CHECK_VALUE(client_send_bytes.load(), client_send_bytes + 6 == expected_data.size());
+		ASIO2_CHECK_VALUE(server_recv_size.load(), server_recv_size == expected_data.size());
+		ASIO2_CHECK(server_recv_data == expected_data);
+		ASIO2_CHECK(client_recv_data == expected_data);
+	}
+
+	// test shared buffer broadcast
+	{
+		asio2::tcp_server_t<filter_tcp_session> server;
+
+		bool server_start_ret = server.start("127.0.0.1", 18029);
+
+		ASIO2_CHECK(server_start_ret);
+
+		std::size_t test_client_count = 10;
+
+		std::vector<std::shared_ptr<asio2::tcp_client>> clients;
+		std::vector<std::string> client_recv_datas(test_client_count);
+		std::atomic<std::size_t> client_recv_size = 0;
+
+		for (std::size_t i = 0; i < test_client_count; ++i)
+		{
+			auto& client = clients.emplace_back(std::make_shared<asio2::tcp_client>());
+
+			client->bind_recv([&, i](std::string_view data)
+			{
+				client_recv_datas[i] += data;
+				client_recv_size += data.size();
+			});
+
+			bool client_start_ret = client->start("127.0.0.1", 18029);
+
+			ASIO2_CHECK(client_start_ret);
+		}
+
+		while (server.get_session_count() < test_client_count)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		filter_tcp_session::filter_counter = 0;
+
+		asio2::shared_buffer buffer(std::string("xyz"));
+
+		ASIO2_CHECK(buffer.size() == std::size_t(3));
+		ASIO2_CHECK(buffer.use_count() == 1);
+		ASIO2_CHECK(buffer.to_string_view() == "xyz");
+
+		server.async_send(std::string("abc"));
+		server.async_send("defg");
+		server.async_send("hijkl", 2);
+		server.async_send(buffer);
+
+		// the data filter is called once for each broadcast, not once for each session,
+		// and the shared buffer is sent as is.
+		ASIO2_CHECK_VALUE(filter_tcp_session::filter_counter.load(),
+			filter_tcp_session::filter_counter == 3);
+
+		std::string expected_data = "abcdefghixyz";
+
+		while (client_recv_size < expected_data.size() * test_client_count)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		for (std::size_t i = 0; i < test_client_count; ++i)
+		{
+			ASIO2_CHECK(client_recv_datas[i] == expected_data);
+		}
+
+		for (auto& client : clients)
+		{
+			client->stop();
+			ASIO2_CHECK(client->is_stopped());
+		}
+
+		server.stop();
+		ASIO2_CHECK(server.is_stopped());
+
+		// all the sessions has released the shared memory.
+		ASIO2_CHECK_VALUE(buffer.use_count(), buffer.use_count() == 1);
+	}
+
+	// test reuse port multi acceptors
+	{
+		// thread 0 is used for the server, the other 3 threads accept the connections.
+		asio2::tcp_server server(1024, 65536, 4);
+
+		server.set_reuse_port(true);
+
+		ASIO2_CHECK(server.is_reuse_port());
+
+		std::atomic<int> server_accept_counter = 0;
+		std::atomic<int> server_connect_counter = 0;
+		std::atomic<int> server_disconnect_counter = 0;
+		std::atomic<int> server_recv_counter = 0;
+		server.bind_accept([&](std::shared_ptr<asio2::tcp_session> & session_ptr)
+		{
+			ASIO2_CHECK(server.io().running_in_this_thread());
+			ASIO2_CHECK(!session_ptr->io().running_in_this_thread());
+			server_accept_counter++;
+		});
+		server.bind_connect([&](std::shared_ptr<asio2::tcp_session> & session_ptr)
+		{
+			ASIO2_CHECK(server.io().running_in_this_thread());
+			ASIO2_CHECK(session_ptr->remote_port() != 0);
+			server_connect_counter++;
+		});
+		server.bind_disconnect([&](std::shared_ptr<asio2::tcp_session> & session_ptr)
+		{
+			asio2::ignore_unused(session_ptr);
+			server_disconnect_counter++;
+		});
+		server.bind_recv([&](std::shared_ptr<asio2::tcp_session> & session_ptr, std::string_view data)
+		{
+			ASIO2_CHECK(session_ptr->io().running_in_this_thread());
+			ASIO2_CHECK(!server.io().running_in_this_thread());
+			server_recv_counter++;
+			session_ptr->async_send(data);
+		});
+
+		for (int loop = 0; loop < 2; ++loop)
+		{
+			server_accept_counter = 0;
+			server_connect_counter = 0;
+			server_disconnect_counter = 0;
+			server_recv_counter = 0;
+
+			bool server_start_ret = server.start("127.0.0.1", 18030);
+
+			ASIO2_CHECK(server_start_ret);
+			ASIO2_CHECK(server.is_started());
+
+			int test_client_count = 50;
+
+			std::atomic<int> client_recv_counter = 0;
+			std::vector<std::shared_ptr<asio2::tcp_client>> clients;
+
+			for (int i = 0; i < test_client_count; ++i)
+			{
+				auto& client = clients.emplace_back(std::make_shared<asio2::tcp_client>());
+
+				client->bind_connect([&, c = client.get()]()
+				{
+					ASIO2_CHECK(!asio2::get_last_error());
+					c->async_send("0123456789");
+				});
+				client->bind_recv([&](std::string_view data)
+				{
+					ASIO2_CHECK(data == "0123456789");
+					client_recv_counter++;
+				});
+
+				bool client_start_ret = client->async_start("127.0.0.1", 18030);
+
+				ASIO2_CHECK(client_start_ret);
+			}
+
+			while (client_recv_counter < test_client_count)
+			{
+				ASIO2_TEST_WAIT_CHECK();
+			}
+
+			ASIO2_CHECK_VALUE(server_accept_counter .load(), server_accept_counter  == test_client_count);
+			ASIO2_CHECK_VALUE(server_connect_counter.load(), server_connect_counter == test_client_count);
+			ASIO2_CHECK_VALUE(server_recv_counter   .load(), server_recv_counter    == test_client_count);
+			ASIO2_CHECK_VALUE(server.get_session_count(), server.get_session_count() == std::size_t(test_client_count));
+
+			for (auto& client : clients)
+			{
+				client->stop();
+				ASIO2_CHECK(client->is_stopped());
+			}
+
+			while (server_disconnect_counter < test_client_count)
+			{
+				ASIO2_TEST_WAIT_CHECK();
+			}
+
+			server.stop();
+			ASIO2_CHECK(server.is_stopped());
+		}
+	}
+
+	// test io placement
+	for (asio2::io_placement placement : {
+		asio2::io_placement::least_sessions,
+		asio2::io_placement::least_pending,
+		asio2::io_placement::power_of_two })
+	{
+		asio2::iopool iopool(4);
+
+		iopool.start();
+
+		// thread 0 is used for the server, the sessions are placed on the other 4 threads.
+		asio2::tcp_server server(1024, 65536, 5);
+
+		server.set_io_placement(placement);
+
+		ASIO2_CHECK(server.get_io_placement() == placement);
+
+		std::atomic<int> server_connect_counter = 0;
+		server.bind_connect([&](std::shared_ptr<asio2::tcp_session> & session_ptr)
+		{
+			ASIO2_CHECK(!session_ptr->io().running_in_this_thread());
+			server_connect_counter++;
+		});
+
+		bool server_start_ret = server.start("127.0.0.1", 18031);
+
+		ASIO2_CHECK(server_start_ret);
+
+		int test_client_count = 40;
+
+		std::atomic<int> client_connect_counter = 0;
+		std::vector<std::shared_ptr<asio2::tcp_client>> clients;
+
+		for (int i = 0; i < test_client_count; ++i)
+		{
+			// the clients are placed by the iopool with the same policy.
+			auto& client = clients.emplace_back(std::make_shared<asio2::tcp_client>(
+				1024, 65536, iopool.get(placement)));
+
+			client->bind_connect([&]()
+			{
+				client_connect_counter++;
+			});
+
+			client->start("127.0.0.1", 18031);
+		}
+
+		while (server_connect_counter < test_client_count || client_connect_counter < test_client_count)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		std::vector<asio2::io_stats> server_stats = server.get_io_stats();
+		std::vector<asio2::io_stats> client_stats = iopool.stats();
+
+		ASIO2_CHECK(server_stats.size() == std::size_t(5));
+		ASIO2_CHECK(client_stats.size() == std::size_t(4));
+
+		// the thread 0 has no sessions.
+		ASIO2_CHECK(server_stats[0].sessions == 0);
+
+		std::size_t server_sessions = 0, client_sessions = 0;
+		std::size_t server_min = std::size_t(-1), server_max = 0;
+		std::size_t client_min = std::size_t(-1), client_max = 0;
+
+		for (std::size_t i = 1; i < server_stats.size(); ++i)
+		{
+			server_sessions += server_stats[i].sessions;
+			server_min = (std::min)(server_min, server_stats[i].sessions);
+			server_max = (std::max)(server_max, server_stats[i].sessions);
+		}
+
+		for (asio2::io_stats& stat : client_stats)
+		{
+			client_sessions += stat.sessions;
+			client_min = (std::min)(client_min, stat.sessions);
+			client_max = (std::max)(client_max, stat.sessions);
+		}
+
+		// the server has created one more session for the next accept.
+		ASIO2_CHECK_VALUE(server_sessions, server_sessions >= std::size_t(test_client_count));
+		ASIO2_CHECK_VALUE(client_sessions, client_sessions == std::size_t(test_client_count));
+
+		if (placement == asio2::io_placement::least_sessions)
+		{
+			ASIO2_CHECK_VALUE(server_max - server_min, server_max - server_min <= std::size_t(1));
+			ASIO2_CHECK_VALUE(client_max - client_min, client_max - client_min <= std::size_t(1));
+		}
+
+		for (auto& client : clients)
+		{
+			client->stop();
+			ASIO2_CHECK(client->is_stopped());
+		}
+
+		clients.clear();
+
+		// the client objects maybe still held by the pending handlers for a while.
+		for (;;)
+		{
+			client_sessions = 0;
+			for (asio2::io_stats& stat : iopool.stats())
+			{
+				client_sessions += stat.sessions;
+			}
+			if (client_sessions == 0)
+				break;
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		server.stop();
+		ASIO2_CHECK(server.is_stopped());
+
+		iopool.stop();
+	}
+
+	// test timing wheel
+	{
+		asio2::tcp_server server;
+
+		server.set_timing_wheel(true);
+
+		ASIO2_CHECK(server.is_timing_wheel());
+
+		std::chrono::milliseconds silence_timeout(300);
+
+		std::atomic<int> server_connect_counter = 0;
+		std::atomic<int> server_disconnect_counter = 0;
+		std::atomic<int> server_timeout_counter = 0;
+		server.bind_connect([&](std::shared_ptr<asio2::tcp_session> & session_ptr)
+		{
+			session_ptr->set_silence_timeout(silence_timeout);
+
+			server_connect_counter++;
+		}).bind_disconnect([&](std::shared_ptr<asio2::tcp_session> &)
+		{
+			if (asio2::get_last_error() == asio::error::timed_out)
+				server_timeout_counter++;
+
+			server_disconnect_counter++;
+		});
+
+		bool server_start_ret = server.start("127.0.0.1", 18032);
+
+		ASIO2_CHECK(server_start_ret);
+
+		int test_client_count = 10;
+
+		std::atomic<int> client_connect_counter = 0;
+		std::vector<std::shared_ptr<asio2::tcp_client>> clients;
+
+		for (int i = 0; i < test_client_count; ++i)
+		{
+			auto& client = clients.emplace_back(std::make_shared<asio2::tcp_client>());
+
+			client->set_auto_reconnect(false);
+
+			client->bind_connect([&]()
+			{
+				client_connect_counter++;
+			});
+
+			client->start("127.0.0.1", 18032);
+		}
+
+		auto t1 = std::chrono::steady_clock::now();
+
+		while (client_connect_counter < test_client_count)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		// the half of the clients send data before the silence timeout, so the silence timer
+		// will be armed again with the rest of the timeout.
+		for (int i = 0; i < test_client_count / 2; ++i)
+		{
+			clients[i]->async_send("0123456789");
+		}
+
+		while (server_disconnect_counter < test_client_count)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - t1).count();
+
+		ASIO2_CHECK_VALUE(elapsed, elapsed >= 300);
+		ASIO2_CHECK_VALUE(server_timeout_counter.load(), server_timeout_counter == test_client_count);
+		ASIO2_CHECK_VALUE(server.get_session_count(), server.get_session_count() == std::size_t(0));
+
+		for (auto& client : clients)
+		{
+			client->stop();
+			ASIO2_CHECK(client->is_stopped());
+		}
+
+		// the server is stopped while the sessions are waiting in the timing wheel.
+		silence_timeout = std::chrono::milliseconds(60 * 1000);
+		server_connect_counter = 0;
+		server_disconnect_counter = 0;
+		client_connect_counter = 0;
+
+		for (auto& client : clients)
+		{
+			client->start("127.0.0.1", 18032);
+		}
+
+		while (server_connect_counter < test_client_count || client_connect_counter < test_client_count)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		server.stop();
+		ASIO2_CHECK(server.is_stopped());
+
+		ASIO2_CHECK_VALUE(server.get_session_count(), server.get_session_count() == std::size_t(0));
+
+		for (auto& client : clients)
+		{
+			client->stop();
+			ASIO2_CHECK(client->is_stopped());
+		}
+	}
+
+	// test session manager shards and for_each snapshot
+	{
+		asio2::tcp_server server;
+
+		std::atomic<int> server_connect_counter = 0;
+		std::atomic<int> server_disconnect_counter = 0;
+		server.bind_connect([&](std::shared_ptr<asio2::tcp_session> &)
+		{
+			server_connect_counter++;
+		}).bind_disconnect([&](std::shared_ptr<asio2::tcp_session> &)
+		{
+			server_disconnect_counter++;
+		});
+
+		bool server_start_ret = server.start("127.0.0.1", 18033);
+
+		ASIO2_CHECK(server_start_ret);
+
+		int test_client_count = 20;
+
+		std::vector<std::shared_ptr<asio2::tcp_client>> clients;
+
+		for (int i = 0; i < test_client_count; ++i)
+		{
+			auto& client = clients.emplace_back(std::make_shared<asio2::tcp_client>());
+
+			client->set_auto_reconnect(false);
+
+			client->start("127.0.0.1", 18033);
+		}
+
+		// the connect notification is fired before the session is joined to the session manager.
+		while (server_connect_counter < test_client_count ||
+			server.get_session_count() < std::size_t(test_client_count))
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		std::vector<std::size_t> keys;
+
+		server.foreach_session([&keys](std::shared_ptr<asio2::tcp_session>& session_ptr)
+		{
+			keys.emplace_back(session_ptr->hash_key());
+		});
+
+		ASIO2_CHECK_VALUE(keys.size(), keys.size() == std::size_t(test_client_count));
+		ASIO2_CHECK_VALUE(server.get_session_count(), server.get_session_count() == std::size_t(test_client_count));
+
+		// find in other thread
+		for (std::size_t key : keys)
+		{
+			ASIO2_CHECK(server.find_session(key) != nullptr);
+		}
+
+		ASIO2_CHECK(server.find_session(std::size_t(1)) == nullptr);
+
+		// find in the server io thread, it don't need lock
+		std::promise<int> promise;
+		server.post([&server, &keys, &promise]()
+		{
+			int found = 0;
+			for (std::size_t key : keys)
+			{
+				if (server.find_session(key))
+					found++;
+			}
+			promise.set_value(found);
+		});
+
+		int found = promise.get_future().get();
+
+		ASIO2_CHECK_VALUE(found, found == test_client_count);
+
+		// the snapshot of the for_each must be updated after the sessions changed
+		for (int i = 0; i < test_client_count / 2; ++i)
+		{
+			clients[i]->stop();
+		}
+
+		while (server_disconnect_counter < test_client_count / 2)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		while (server.get_session_count() != std::size_t(test_client_count / 2))
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		std::size_t count = 0;
+		server.foreach_session([&count](std::shared_ptr<asio2::tcp_session>&)
+		{
+			count++;
+		});
+
+		ASIO2_CHECK_VALUE(count, count == std::size_t(test_client_count / 2));
+
+		for (auto& client : clients)
+		{
+			client->stop();
+		}
+
+		while (server_disconnect_counter < test_client_count)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		while (server.get_session_count() != 0)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		count = 0;
+		server.foreach_session([&count](std::shared_ptr<asio2::tcp_session>&)
+		{
+			count++;
+		});
+
+		ASIO2_CHECK_VALUE(count, count == std::size_t(0));
+
+		server.stop();
+		ASIO2_CHECK(server.is_stopped());
+	}
+
+	// test the events posted by many threads are executed in order
+	{
+		asio2::tcp_server server;
+
+		const int thread_count = 8;
+		const int send_count = 2000;
+
+		std::atomic<int> server_recv_counter = 0;
+		std::atomic<int> server_order_error = 0;
+		std::vector<int> server_next_seq(thread_count, 0);
+		server.bind_recv([&](std::shared_ptr<asio2::tcp_session> &, std::string_view data)
+		{
+			// the data is "thread:seq\n"
+			std::size_t pos = data.find(':');
+			ASIO2_CHECK(pos != std::string_view::npos);
+
+			int t = std::stoi(std::string(data.substr(0, pos)));
+			int n = std::stoi(std::string(data.substr(pos + 1)));
+
+			if (server_next_seq[t] != n)
+				server_order_error++;
+
+			server_next_seq[t] = n + 1;
+			server_recv_counter++;
+		});
+
+		bool server_start_ret = server.start("127.0.0.1", 18034, '\n');
+
+		ASIO2_CHECK(server_start_ret);
+
+		asio2::tcp_client client;
+
+		client.set_auto_reconnect(false);
+
+		bool client_start_ret = client.start("127.0.0.1", 18034, '\n');
+
+		ASIO2_CHECK(client_start_ret);
+
+		std::atomic<int> event_counter = 0;
+		std::atomic<int> event_order_error = 0;
+		std::vector<int> event_next_seq(thread_count, 0);
+
+		std::vector<std::thread> threads;
+
+		for (int t = 0; t < thread_count; ++t)
+		{
+			threads.emplace_back([&, t]()
+			{
+				for (int n = 0; n < send_count; ++n)
+				{
+					client.async_send(std::to_string(t) + ":" + std::to_string(n) + "\n");
+
+					client.post_queued_event([&, t, n]()
+					{
+						if (event_next_seq[t] != n)
+							event_order_error++;
+
+						event_next_seq[t] = n + 1;
+						event_counter++;
+					});
+				}
+			});
+		}
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		while (event_counter < thread_count * send_count)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		while (server_recv_counter < thread_count * send_count)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		ASIO2_CHECK_VALUE(event_order_error.load(), event_order_error == 0);
+		ASIO2_CHECK_VALUE(server_order_error.load(), server_order_error == 0);
+		ASIO2_CHECK_VALUE(client.get_pending_event_count(), client.get_pending_event_count() == 0);
+
+		client.stop();
+		ASIO2_CHECK(client.is_stopped());
+
+		server.stop();
+		ASIO2_CHECK(server.is_stopped());
+	}
+
+	// test the backend of the io_context
+	{
+	#if defined(ASIO2_ENABLE_IO_URING) && defined(__linux__)
+		ASIO2_CHECK(asio2::get_io_backend() == asio2::io_backend::io_uring);
+		ASIO2_CHECK(asio2::get_io_backend_name() == "io_uring");
+	#elif defined(__linux__)
+		ASIO2_CHECK(asio2::get_io_backend() == asio2::io_backend::epoll);
+		ASIO2_CHECK(asio2::get_io_backend_name() == "epoll");
+	#elif defined(_WIN32)
+		ASIO2_CHECK(asio2::get_io_backend() == asio2::io_backend::iocp);
+	#endif
+	}
+
+	// test the cpu affinity and the name of the iopool threads
+	{
+		for (int mode = 0; mode < 3; ++mode)
+		{
+			asio2::tcp_server server(2);
+
+			if (mode == 0)
+				server.set_cpu_affinity(asio2::cpu_affinity::physical_core);
+			else if (mode == 1)
+				server.set_cpu_affinity(asio2::cpu_affinity::numa_node);
+			else
+				server.set_cpu_affinity({ {0} });
+
+			server.set_thread_name("tcp-io-");
+
+			bool server_start_ret = server.start("127.0.0.1", 18035);
+
+			ASIO2_CHECK(server_start_ret);
+
+		#if ASIO2_OS_LINUX
+			std::promise<std::tuple<std::string, int>> promise;
+			server.post([&promise]()
+			{
+				char name[16]{};
+				pthread_getname_np(pthread_self(), name, sizeof(name));
+
+				cpu_set_t set;
+				CPU_ZERO(&set);
+				sched_getaffinity(0, sizeof(set), &set);
+
+				promise.set_value({ std::string(name), CPU_COUNT(&set) });
+			});
+
+			auto [name, cpus] = promise.get_future().get();
+
+			ASIO2_CHECK_VALUE(name, name == "tcp-io-0");
+			ASIO2_CHECK_VALUE(cpus, cpus >= 1);
+
+			if (mode != 1)
+			{
+				ASIO2_CHECK_VALUE(cpus, cpus == 1);
+			}
+
+			for (std::size_t i = 0; i < server.iopool().size(); ++i)
+			{
+				ASIO2_CHECK(server.iopool().get(i)->get_numa_node() >= 0);
+			}
+		#endif
+
+			server.stop();
+			ASIO2_CHECK(server.is_stopped());
+		}
+	}
+
+	// test the busy poll mode of the iopool threads
+	{
+		asio2::tcp_server server(2);
+
+		// only the first thread spins.
+		server.set_busy_poll(0, std::chrono::microseconds(100), std::chrono::microseconds(50));
+
+		ASIO2_CHECK(server.get_busy_poll(0) == std::chrono::microseconds(100));
+		ASIO2_CHECK(server.get_busy_poll(1) == std::chrono::microseconds(0));
+
+		std::atomic<int> server_recv_counter = 0;
+		server.bind_recv([&](std::shared_ptr<asio2::tcp_session>& session_ptr, std::string_view data)
+		{
+			server_recv_counter++;
+			session_ptr->async_send(data);
+		});
+
+		bool server_start_ret = server.start("127.0.0.1", 18036, '\n');
+
+		ASIO2_CHECK(server_start_ret);
+
+		std::vector<std::shared_ptr<asio2::tcp_client>> clients;
+		std::atomic<int> client_recv_counter = 0;
+
+		for (int i = 0; i < 4; ++i)
+		{
+			auto& client = *clients.emplace_back(std::make_shared<asio2::tcp_client>());
+
+			client.set_busy_poll(0, std::chrono::microseconds(i % 2 ? 100 : 0));
+
+			client.bind_connect([&client]()
+			{
+				ASIO2_CHECK(!asio2::get_last_error());
+				client.async_send("ping\n");
+			}).bind_recv([&client, &client_recv_counter](std::string_view data)
+			{
+				ASIO2_CHECK(data == "ping\n");
+				if (++client_recv_counter < 4 * 100)
+					client.async_send("ping\n");
+			});
+
+			bool client_start_ret = client.async_start("127.0.0.1", 18036, '\n');
+
+			ASIO2_CHECK(client_start_ret);
+		}
+
+		while (client_recv_counter < 4 * 100)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		ASIO2_CHECK_VALUE(server_recv_counter.load(), server_recv_counter >= 4 * 100);
+
+		for (auto& client : clients)
+		{
+			client->stop();
+			ASIO2_CHECK(client->is_stopped());
+		}
+
+		server.stop();
+		ASIO2_CHECK(server.is_stopped());
+	}
+
+	// test the session pool
+	{
+		asio2::tcp_server server(1);
+
+		server.set_session_pool(true);
+
+		ASIO2_CHECK(server.is_session_pool());
+
+		std::atomic<int> server_accept_counter = 0;
+		std::atomic<int> server_disconnect_counter = 0;
+		std::atomic<int> server_recv_counter = 0;
+
+		server.bind_accept([&](std::shared_ptr<asio2::tcp_session>& session_ptr)
+		{
+			ASIO2_CHECK(server.find_session(session_ptr->hash_key()) == nullptr);
+			server_accept_counter++;
+		}).bind_recv([&](std::shared_ptr<asio2::tcp_session>& session_ptr, std::string_view data)
+		{
+			server_recv_counter++;
+			session_ptr->async_send(data);
+		}).bind_disconnect([&](std::shared_ptr<asio2::tcp_session>& session_ptr)
+		{
+			ASIO2_CHECK(session_ptr->get_local_port() == 18037);
+			server_disconnect_counter++;
+		});
+
+		bool server_start_ret = server.start("127.0.0.1", 18037);
+
+		ASIO2_CHECK(server_start_ret);
+
+		for (int i = 0; i < 20; ++i)
+		{
+			asio2::tcp_client client;
+
+			std::atomic<int> client_recv_counter = 0;
+
+			client.bind_recv([&](std::string_view data)
+			{
+				ASIO2_CHECK(data == "pool");
+				client_recv_counter++;
+			});
+
+			bool client_start_ret = client.start("127.0.0.1", 18037);
+
+			ASIO2_CHECK(client_start_ret);
+
+			client.async_send("pool");
+
+			while (client_recv_counter < 1)
+			{
+				ASIO2_TEST_WAIT_CHECK();
+			}
+
+			client.stop();
+			ASIO2_CHECK(client.is_stopped());
+
+			while (server_disconnect_counter < i + 1)
+			{
+				ASIO2_TEST_WAIT_CHECK();
+			}
+
+			// wait for the session to be destroyed, then its memory is returned to the pool.
+			for (;;)
+			{
+				std::size_t free_count = 0;
+				for (std::size_t k = 0; k < server.iopool().size(); ++k)
+				{
+					free_count += server.iopool().get(k)->session_pool()->free_count();
+				}
+				if (free_count > 0)
+					break;
+				ASIO2_TEST_WAIT_CHECK();
+			}
+		}
+
+		ASIO2_CHECK_VALUE(server_accept_counter.load(), server_accept_counter == 20);
+		ASIO2_CHECK_VALUE(server_recv_counter.load(), server_recv_counter == 20);
+
+		// a session is always waiting for the next accept, so only the first two sessions
+		// allocate new blocks, the others reuse the blocks of the destroyed sessions.
+		std::size_t hits = 0, misses = 0;
+		for (std::size_t k = 0; k < server.iopool().size(); ++k)
+		{
+			hits   += server.iopool().get(k)->session_pool()->hits();
+			misses += server.iopool().get(k)->session_pool()->misses();
+		}
+		ASIO2_CHECK_VALUE(hits, hits >= 19);
+		ASIO2_CHECK_VALUE(misses, misses <= 2);
+
+		server.stop();
+		ASIO2_CHECK(server.is_stopped());
+	}
+
+	// test the buffer pool mode, the idle sessions release the receive buffer
+	{
+		asio2::tcp_server server(2);
+
+		server.set_buffer_pool(true);
+
+		ASIO2_CHECK(server.is_buffer_pool());
+
+		std::atomic<int> server_recv_counter = 0;
+		std::atomic<int> server_error_counter = 0;
+		server.bind_recv([&](std::shared_ptr<asio2::tcp_session>& session_ptr, std::string_view data)
+		{
+			if (data != "hello world\n" && data != std::string(3000, 'x') + "\n")
+				server_error_counter++;
+			server_recv_counter++;
+			session_ptr->async_send(data);
+		});
+
+		bool server_start_ret = server.start("127.0.0.1", 18038, '\n');
+
+		ASIO2_CHECK(server_start_ret);
+
+		std::vector<std::shared_ptr<asio2::tcp_client>> clients;
+		std::atomic<int> client_recv_counter = 0;
+
+		for (int i = 0; i < 10; ++i)
+		{
+			auto& client = *clients.emplace_back(std::make_shared<asio2::tcp_client>());
+
+			client.bind_connect([&client]()
+			{
+				ASIO2_CHECK(!asio2::get_last_error());
+
+				// the message is split into two parts, the session must keep the first part
+				// in the buffer until the rest arrives.
+				client.async_send("hello ");
+				client.async_send("world\n");
+				client.async_send(std::string(3000, 'x') + "\n");
+			}).bind_recv([&client_recv_counter](std::string_view data)
+			{
+				client_recv_counter += int(std::count(data.begin(), data.end(), '\n'));
+			});
+
+			bool client_start_ret = client.async_start("127.0.0.1", 18038);
+
+			ASIO2_CHECK(client_start_ret);
+		}
+
+		while (client_recv_counter < 10 * 2)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		ASIO2_CHECK_VALUE(server_recv_counter.load(), server_recv_counter == 10 * 2);
+		ASIO2_CHECK_VALUE(server_error_counter.load(), server_error_counter == 0);
+
+		// all the sessions are idle now, each session only holds the small initial block of
+		// the streambuf, and the large buffers are returned to the pools.
+		std::size_t capacity = 0;
+		for (;;)
+		{
+			capacity = 0;
+			server.foreach_session([&capacity](std::shared_ptr<asio2::tcp_session>& session_ptr)
+			{
+				capacity += session_ptr->buffer().capacity();
+			});
+			if (capacity <= 10 * 128)
+				break;
+			ASIO2_TEST_WAIT_CHECK();
+		}
+		ASIO2_CHECK_VALUE(capacity, capacity <= 10 * 128);
+
+		std::size_t free_count = 0;
+		for (std::size_t k = 0; k < server.iopool().size(); ++k)
+		{
+			free_count += server.iopool().get(k)->buffer_pool()->free_count();
+		}
+		ASIO2_CHECK_VALUE(free_count, free_count > 0);
+
+		for (auto& client : clients)
+		{
+			client->stop();
+			ASIO2_CHECK(client->is_stopped());
+		}
+
+		server.stop();
+		ASIO2_CHECK(server.is_stopped());
+	}
+
+	// test the recv chunk mode, the chunks are kept after the recv callback returns
+	{
+		asio2::tcp_server server(2);
+
+		server.set_recv_chunk(true);
+
+		ASIO2_CHECK(server.is_recv_chunk());
+
+		std::mutex chunks_mutex;
+		std::vector<std::pair<std::string, asio2::recv_chunk>> chunks;
+
+		std::atomic<int> server_recv_counter = 0;
+		std::atomic<int> server_error_counter = 0;
+		server.bind_recv([&](std::shared_ptr<asio2::tcp_session>& session_ptr, std::string_view data)
+		{
+			ASIO2_CHECK(session_ptr->is_recv_chunk());
+
+			asio2::recv_chunk chunk = session_ptr->get_recv_chunk();
+
+			// the chunk shares the memory of the receive buffer.
+			if (chunk.view() != data || chunk.data() != data.data())
+				server_error_counter++;
+
+			{
+				std::lock_guard guard(chunks_mutex);
+				chunks.emplace_back(std::string(data), std::move(chunk));
+			}
+
+			server_recv_counter++;
+			session_ptr->async_send(data);
+		});
+
+		bool server_start_ret = server.start("127.0.0.1", 18039, '\n');
+
+		ASIO2_CHECK(server_start_ret);
+
+		std::vector<std::shared_ptr<asio2::tcp_client>> clients;
+		std::atomic<int> client_recv_counter = 0;
+
+		for (int i = 0; i < 10; ++i)
+		{
+			auto& client = *clients.emplace_back(std::make_shared<asio2::tcp_client>());
+
+			client.bind_connect([&client]()
+			{
+				ASIO2_CHECK(!asio2::get_last_error());
+
+				for (int n = 0; n < 20; ++n)
+				{
+					client.async_send(std::string(n * 211 % 3000, char('a' + n)) + "\n");
+				}
+			}).bind_recv([&client_recv_counter](std::string_view data)
+			{
+				client_recv_counter += int(std::count(data.begin(), data.end(), '\n'));
+			});
+
+			bool client_start_ret = client.async_start("127.0.0.1", 18039);
+
+			ASIO2_CHECK(client_start_ret);
+		}
+
+		while (client_recv_counter < 10 * 20)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		ASIO2_CHECK_VALUE(server_recv_counter.load(), server_recv_counter == 10 * 20);
+		ASIO2_CHECK_VALUE(server_error_counter.load(), server_error_counter == 0);
+
+		for (auto& client : clients)
+		{
+			client->stop();
+			ASIO2_CHECK(client->is_stopped());
+		}
+
+		server.stop();
+		ASIO2_CHECK(server.is_stopped());
+
+		// the data of the chunks is not overwritten by the later reads.
+		std::size_t mismatch = 0;
+		for (auto& [str, chunk] : chunks)
+		{
+			if (chunk.view() != str)
+				mismatch++;
+		}
+		ASIO2_CHECK_VALUE(chunks.size(), chunks.size() == 10 * 20);
+		ASIO2_CHECK_VALUE(mismatch, mismatch == 0);
+
+		// the blocks are returned to the pools after the last chunk is destroyed.
+		std::size_t free_count = 0;
+		for (std::size_t k = 0; k < server.iopool().size(); ++k)
+		{
+			free_count += server.iopool().get(k)->buffer_pool()->free_count();
+		}
+		chunks.clear();
+		std::size_t free_count_after = 0;
+		for (std::size_t k = 0; k < server.iopool().size(); ++k)
+		{
+			free_count_after += server.iopool().get(k)->buffer_pool()->free_count();
+		}
+		ASIO2_CHECK_VALUE(free_count_after, free_count_after > free_count);
+	}
+
+	// the data is copied into the chunk when the recv chunk mode is disabled
+	{
+		asio2::tcp_server server;
+
+		ASIO2_CHECK(!server.is_recv_chunk());
+
+		std::atomic<int> server_recv_counter = 0;
+		std::atomic<int> server_error_counter = 0;
+		server.bind_recv([&](std::shared_ptr<asio2::tcp_session>& session_ptr, std::string_view data)
+		{
+			asio2::recv_chunk chunk = session_ptr->get_recv_chunk();
+
+			if (chunk.view() != data || chunk.data() == data.data() || chunk.use_count() != 1)
+				server_error_counter++;
+
+			server_recv_counter++;
+			session_ptr->async_send(data);
+		});
+
+		bool server_start_ret = server.start("127.0.0.1", 18039, '\n');
+
+		ASIO2_CHECK(server_start_ret);
+
+		asio2::tcp_client client;
+		std::atomic<int> client_recv_counter = 0;
+
+		client.bind_connect([&client]()
+		{
+			client.async_send("hello world\n");
+		}).bind_recv([&client_recv_counter](std::string_view data)
+		{
+			client_recv_counter += int(std::count(data.begin(), data.end(), '\n'));
+		});
+
+		bool client_start_ret = client.start("127.0.0.1", 18039);
+
+		ASIO2_CHECK(client_start_ret);
+
+		while (client_recv_counter < 1)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		ASIO2_CHECK_VALUE(server_recv_counter.load(), server_recv_counter == 1);
+		ASIO2_CHECK_VALUE(server_error_counter.load(), server_error_counter == 0);
+
+		client.stop();
+		server.stop();
+		ASIO2_CHECK(server.is_stopped());
+	}
+
+	// the send watermark and the send budget of the server, the client is a slow consumer
+	for (asio2::send_policy policy : { asio2::send_policy::reject, asio2::send_policy::drop_oldest })
+	{
+		asio2::tcp_server server;
+
+		const std::size_t msg_size  = 512 * 1024;
+		const int         msg_count = 64;
+
+		std::atomic<int> server_pause_counter = 0;
+		std::atomic<int> server_resume_counter = 0;
+		std::atomic<int> server_sent_counter = 0;
+		std::atomic<int> server_reject_counter = 0;
+		std::atomic<bool> server_send_finished = false;
+
+		server.set_send_watermark(4 * 1024 * 1024, 1024 * 1024)
+			.set_send_budget(16 * 1024 * 1024, policy);
+
+		server.bind_send_pressure([&](std::shared_ptr<asio2::tcp_session>& session_ptr, bool paused)
+		{
+			asio2::ignore_unused(session_ptr);
+
+			if (paused)
+				server_pause_counter++;
+			else
+				server_resume_counter++;
+		});
+		server.bind_connect([&](std::shared_ptr<asio2::tcp_session>& session_ptr)
+		{
+			for (int i = 0; i < msg_count; i++)
+			{
+				session_ptr->async_send(std::string(msg_size, 'a'), [&]()
+				{
+					if (asio2::get_last_error() == asio::error::no_buffer_space)
+						server_reject_counter++;
+					else if (!asio2::get_last_error())
+						server_sent_counter++;
+				});
+			}
+
+			server_send_finished = true;
+		});
+
+		bool server_start_ret = server.start("127.0.0.1", 18040);
+
+		ASIO2_CHECK(server_start_ret);
+
+		asio2::tcp_client client;
+		std::atomic<bool> client_blocked = true;
+		std::atomic<std::size_t> client_recv_bytes = 0;
+
+		client.bind_recv([&](std::string_view data)
+		{
+			while (client_blocked)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+
+			client_recv_bytes += data.size();
+		});
+
+		bool client_start_ret = client.start("127.0.0.1", 18040);
+
+		ASIO2_CHECK(client_start_ret);
+
+		while (server_pause_counter < 1 || !server_send_finished)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		// the dropped sends are completed when they reach the head of the send queue.
+		if (policy == asio2::send_policy::reject)
+		{
+			ASIO2_CHECK_VALUE(server_reject_counter.load(), server_reject_counter > 0);
+		}
+		ASIO2_CHECK_VALUE(server.get_send_budget_used(), server.get_send_budget_used() <= 16 * 1024 * 1024);
+
+		client_blocked = false;
+
+		while (server_sent_counter + server_reject_counter < msg_count || server_resume_counter < 1)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		while (client_recv_bytes < std::size_t(server_sent_counter) * msg_size)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		ASIO2_CHECK_VALUE(server_reject_counter.load(), server_reject_counter > 0);
+		ASIO2_CHECK_VALUE(server_pause_counter.load(), server_pause_counter == 1);
+		ASIO2_CHECK_VALUE(server_resume_counter.load(), server_resume_counter == 1);
+		ASIO2_CHECK_VALUE(server.get_send_budget_used(), server.get_send_budget_used() == 0);
+		ASIO2_CHECK_VALUE(client_recv_bytes.load(), client_recv_bytes == std::size_t(server_sent_counter) * msg_size);
+
+		client.stop();
+		server.stop();
+		ASIO2_CHECK(server.is_stopped());
+	}
+
+	// the session is disconnected when the send budget is exhausted
+	{
+		asio2::tcp_server server;
+
+		const std::size_t msg_size  = 512 * 1024;
+		const int         msg_count = 64;
+
+		std::atomic<int> server_disconnect_counter = 0;
+		std::atomic<int> server_callback_counter = 0;
+
+		server.set_send_budget(16 * 1024 * 1024, asio2::send_policy::disconnect);
+
+		server.bind_disconnect([&](std::shared_ptr<asio2::tcp_session>& session_ptr)
+		{
+			asio2::ignore_unused(session_ptr);
+
+			ASIO2_CHECK(asio2::get_last_error() == asio::error::no_buffer_space);
+
+			server_disconnect_counter++;
+		});
+		server.bind_connect([&](std::shared_ptr<asio2::tcp_session>& session_ptr)
+		{
+			// send after the session is added into the session map, then the disconnect
+			// notification can be called.
+			session_ptr->post([&, session_ptr]()
+			{
+				for (int i = 0; i < msg_count; i++)
+				{
+					session_ptr->async_send(std::string(msg_size, 'a'), [&]()
+					{
+						server_callback_counter++;
+					});
+				}
+			}, std::chrono::milliseconds(100));
+		});
+
+		bool server_start_ret = server.start("127.0.0.1", 18040);
+
+		ASIO2_CHECK(server_start_ret);
+
+		asio2::tcp_client client;
+		std::atomic<bool> client_blocked = true;
+
+		client.bind_recv([&](std::string_view)
+		{
+			while (client_blocked)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		});
+
+		bool client_start_ret = client.start("127.0.0.1", 18040);
+
+		ASIO2_CHECK(client_start_ret);
+
+		while (server_disconnect_counter < 1 || server_callback_counter < msg_count)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		ASIO2_CHECK_VALUE(server.get_send_budget_used(), server.get_send_budget_used() == 0);
+
+		client_blocked = false;
+
+		client.stop();
+		server.stop();
+		ASIO2_CHECK(server.is_stopped());
+		ASIO2_CHECK_VALUE(server_disconnect_counter.load(), server_disconnect_counter == 1);
+	}
+
+	// the send watermark of the client, the server is a slow consumer
+	{
+		asio2::tcp_server server;
+
+		std::atomic<bool> server_blocked = true;
+		std::atomic<std::size_t> server_recv_bytes = 0;
+
+		server.bind_recv([&](std::shared_ptr<asio2::tcp_session>&, std::string_view data)
+		{
+			while (server_blocked)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+
+			server_recv_bytes += data.size();
+		});
+
+		bool server_start_ret = server.start("127.0.0.1", 18040);
+
+		ASIO2_CHECK(server_start_ret);
+
+		const std::size_t msg_size  = 512 * 1024;
+		const int         msg_count = 64;
+
+		asio2::tcp_client client;
+
+		std::atomic<int> client_pause_counter = 0;
+		std::atomic<int> client_resume_counter = 0;
+		std::atomic<int> client_sent_counter = 0;
+
+		client.set_send_watermark_count(16, 4);
+
+		client.bind_send_pressure([&](bool paused)
+		{
+			if (paused)
+				client_pause_counter++;
+			else
+				client_resume_counter++;
+		}).bind_connect([&]()
+		{
+			for (int i = 0; i < msg_count; i++)
+			{
+				client.async_send(std::string(msg_size, 'a'), [&]()
+				{
+					if (!asio2::get_last_error())
+						client_sent_counter++;
+				});
+			}
+		});
+
+		bool client_start_ret = client.start("127.0.0.1", 18040);
+
+		ASIO2_CHECK(client_start_ret);
+
+		while (client_pause_counter < 1)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		ASIO2_CHECK(client.is_send_paused());
+		ASIO2_CHECK_VALUE(client.get_send_queued_count(), client.get_send_queued_count() > 16);
+
+		server_blocked = false;
+
+		while (client_sent_counter < msg_count || client_resume_counter < 1)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		while (server_recv_bytes < msg_size * msg_count)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		ASIO2_CHECK(!client.is_send_paused());
+		ASIO2_CHECK_VALUE(client.get_send_queued_count(), client.get_send_queued_count() == 0);
+		ASIO2_CHECK_VALUE(client.get_send_queued_bytes(), client.get_send_queued_bytes() == 0);
+		ASIO2_CHECK_VALUE(client_pause_counter.load(), client_pause_counter == 1);
+		ASIO2_CHECK_VALUE(client_resume_counter.load(), client_resume_counter == 1);
+
+		client.stop();
+		server.stop();
+		ASIO2_CHECK(server.is_stopped());
+	}
+
+	// the metrics of the io_context, the session manager and the sessions
+	{
+		asio2::tcp_server server;
+
+		std::atomic<int> server_recv_counter = 0;
+		std::atomic<int> server_disconnect_counter = 0;
+		std::shared_ptr<asio2::tcp_session> server_session;
+
+		server.bind_accept([&](std::shared_ptr<asio2::tcp_session>& session_ptr)
+		{
+			server_session = session_ptr;
+		}).bind_recv([&](std::shared_ptr<asio2::tcp_session>& session_ptr, std::string_view data)
+		{
+			server_recv_counter++;
+			session_ptr->async_send(data);
+		}).bind_disconnect([&](std::shared_ptr<asio2::tcp_session>& session_ptr)
+		{
+			asio2::ignore_unused(session_ptr);
+			server_disconnect_counter++;
+		});
+
+		bool server_start_ret = server.start("127.0.0.1", 18041, '\n');
+
+		ASIO2_CHECK(server_start_ret);
+
+		asio2::tcp_client client;
+
+		std::atomic<int> client_recv_counter = 0;
+
+		client.bind_connect([&]()
+		{
+			client.async_send("metrics\n");
+		}).bind_recv([&](std::string_view data)
+		{
+			ASIO2_CHECK(data == "metrics\n");
+			if (++client_recv_counter < 10)
+				client.async_send("metrics\n");
+		});
+
+		bool client_start_ret = client.start("127.0.0.1", 18041, '\n');
+
+		ASIO2_CHECK(client_start_ret);
+
+		while (client_recv_counter < 10)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		// the sent bytes are counted after the write is completed.
+		while (server_session->get_metrics().bytes_sent < 10 * 8)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		asio2::connection_metrics sm = server_session->get_metrics();
+		ASIO2_CHECK_VALUE(sm.messages_recv, sm.messages_recv == 10);
+		ASIO2_CHECK_VALUE(sm.bytes_recv   , sm.bytes_recv    == 10 * 8);
+		ASIO2_CHECK_VALUE(sm.messages_sent, sm.messages_sent == 10);
+		ASIO2_CHECK_VALUE(sm.bytes_sent   , sm.bytes_sent    == 10 * 8);
+
+		asio2::connection_metrics cm = client.get_metrics();
+		ASIO2_CHECK_VALUE(cm.messages_recv, cm.messages_recv == 10);
+		ASIO2_CHECK_VALUE(cm.messages_sent, cm.messages_sent == 10);
+		ASIO2_CHECK_VALUE(cm.bytes_sent   , cm.bytes_sent    == 10 * 8);
+
+		asio2::server_metrics m1 = server.get_metrics();
+		asio2::io_metrics total = m1.total();
+		ASIO2_CHECK_VALUE(m1.ios.size(), m1.ios.size() == server.iopool().size());
+		ASIO2_CHECK_VALUE(m1.sessions.accepts, m1.sessions.accepts == 1);
+		ASIO2_CHECK_VALUE(m1.sessions.sessions, m1.sessions.sessions == 1);
+		ASIO2_CHECK_VALUE(m1.sessions.peak_sessions, m1.sessions.peak_sessions == 1);
+		ASIO2_CHECK_VALUE(total.messages_recv, total.messages_recv == 10);
+		ASIO2_CHECK_VALUE(total.bytes_recv, total.bytes_recv == 10 * 8);
+		ASIO2_CHECK_VALUE(total.handler_latency.count, total.handler_latency.count == 10);
+		ASIO2_CHECK(total.handler_latency.percentile_ns(0.5) <= total.handler_latency.percentile_ns(0.99));
+		ASIO2_CHECK(total.handler_latency.percentile_ns(0.99) <= total.handler_latency.max_ns);
+
+		std::string json = asio2::to_json(m1);
+		ASIO2_CHECK(json.find("\"accepts\":1") != std::string::npos);
+		ASIO2_CHECK(json.find("\"messages_recv\":10") != std::string::npos);
+
+		// each recv and send handler is allocated from the allocators of the session.
+		asio2::allocator_metrics am = server.get_allocator_metrics();
+		ASIO2_CHECK_VALUE(am.rallocator.hits, am.rallocator.hits + am.rallocator.misses >= 10);
+		ASIO2_CHECK_VALUE(am.wallocator.hits, am.wallocator.hits + am.wallocator.misses >= 10);
+		ASIO2_CHECK(am.rallocator.heap <= am.rallocator.misses);
+		ASIO2_CHECK(am.wallocator.heap <= am.wallocator.misses);
+		asio2::allocator_metrics sam = server_session->get_allocator_metrics();
+		ASIO2_CHECK_VALUE(sam.rallocator.hits, sam.rallocator.hits == am.rallocator.hits);
+		asio2::allocator_metrics cam = client.get_allocator_metrics();
+		ASIO2_CHECK_VALUE(cam.rallocator.hits, cam.rallocator.hits + cam.rallocator.misses >= 10);
+		ASIO2_CHECK(asio2::to_json(am).find("\"wallocator\":{\"hits\":") != std::string::npos);
+
+		client.stop();
+		ASIO2_CHECK(client.is_stopped());
+
+		while (server_disconnect_counter < 1)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		asio2::session_mgr_metrics m2 = server.get_metrics().sessions;
+		std::uint64_t disconnects = 0;
+		for (std::uint64_t n : m2.disconnects)
+			disconnects += n;
+		ASIO2_CHECK_VALUE(disconnects, disconnects == 1);
+		ASIO2_CHECK_VALUE(m2.get_disconnects(asio2::disconnect_reason::local),
+			m2.get_disconnects(asio2::disconnect_reason::local) == 0);
+		ASIO2_CHECK_VALUE(m2.sessions, m2.sessions == 0);
+		ASIO2_CHECK(m2.accept_rate(m1.sessions) == 0.0);
+
+		server_session.reset();
+
+		server.stop();
+		ASIO2_CHECK(server.is_stopped());
+	}
+
+
+	// test the handler allocator counters and the per thread memory pool
+	{
+		asio2::detail::handler_memory<std::true_type, asio2::detail::allocator_fixed_size_op<64>> m;
+
+		void* p1 = m.allocate(32);
+		ASIO2_CHECK(m.stats().hits == 1);
+
+		// the storage is in use, the larger blocks are rounded up to the size classes, so the
+		// block of 100 bytes can be reused by the allocation of 128 bytes.
+		void* p2 = m.allocate(100);
+		ASIO2_CHECK(p2 != p1);
+		ASIO2_CHECK(m.stats().misses == 1);
+
+		m.deallocate(p2, 100);
+
+		void* p3 = m.allocate(128);
+		ASIO2_CHECK(p3 == p2);
+		ASIO2_CHECK(m.stats().misses == 2);
+		ASIO2_CHECK(m.stats().heap <= 1);
+
+		m.deallocate(p3, 128);
+		m.deallocate(p1, 32);
+
+		void* p4 = m.allocate(32);
+		ASIO2_CHECK(p4 == p1);
+		ASIO2_CHECK(m.stats().hits == 2);
+		m.deallocate(p4, 32);
+
+		// the blocks larger than the max size class are not cached.
+		void* p5 = m.allocate(1024 * 1024);
+		ASIO2_CHECK(m.stats().heap == m.stats().misses - 1);
+		m.deallocate(p5, 1024 * 1024);
+
+		ASIO2_CHECK(asio2::detail::handler_memory_pool::class_index(1) == 0);
+		ASIO2_CHECK(asio2::detail::handler_memory_pool::class_index(64) == 0);
+		ASIO2_CHECK(asio2::detail::handler_memory_pool::class_index(65) == 1);
+		ASIO2_CHECK(asio2::detail::handler_memory_pool::class_index(64 * 1024) ==
+			asio2::detail::handler_memory_pool::class_count - 1);
+		ASIO2_CHECK(asio2::detail::handler_memory_pool::class_index(64 * 1024 + 1) ==
+			asio2::detail::handler_memory_pool::class_count);
+	}
+
+	// test the handler tracing
+	{
+		asio2::tracer::clear();
+		asio2::tracer::enable();
+
+		ASIO2_CHECK(asio2::tracer::is_enabled());
+		ASIO2_CHECK(asio2::tracer::get_sample_rate() == 1);
+
+		asio2::tcp_server server;
+
+		server.bind_recv([&](std::shared_ptr<asio2::tcp_session>& session_ptr, std::string_view data)
+		{
+			session_ptr->async_send(data);
+		});
+
+		bool server_start_ret = server.start("127.0.0.1", 18042, '\n');
+
+		ASIO2_CHECK(server_start_ret);
+
+		asio2::tcp_client client;
+
+		std::atomic<int> client_recv_counter = 0;
+
+		client.bind_connect([&]()
+		{
+			client.async_send("trace\n");
+		}).bind_recv([&](std::string_view data)
+		{
+			ASIO2_CHECK(data == "trace\n");
+			if (++client_recv_counter < 10)
+				client.async_send("trace\n");
+		});
+
+		bool client_start_ret = client.start("127.0.0.1", 18042, '\n');
+
+		ASIO2_CHECK(client_start_ret);
+
+		while (client_recv_counter < 10)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		asio2::tracer::disable();
+
+		ASIO2_CHECK(!asio2::tracer::is_enabled());
+
+		std::string json = asio2::tracer::dump();
+		ASIO2_CHECK(json.find("\"traceEvents\":[") != std::string::npos);
+		ASIO2_CHECK(json.find("\"name\":\"bind_recv\"") != std::string::npos);
+		ASIO2_CHECK(json.find("\"name\":\"bind_connect\"") != std::string::npos);
+		ASIO2_CHECK(json.find("tcp_recv_op") != std::string::npos);
+		ASIO2_CHECK(json.find("\"ph\":\"X\"") != std::string::npos);
+		ASIO2_CHECK(json.find("\"ph\":\"M\"") != std::string::npos);
+
+		std::size_t events = 0;
+		for (std::size_t pos = json.find("\"ph\":\"X\""); pos != std::string::npos;
+			pos = json.find("\"ph\":\"X\"", pos + 1))
+		{
+			++events;
+		}
+
+		// only one of every 1000 handlers is recorded, the handlers of the echo above are far
+		// less than 1000 * events.
+		asio2::tracer::clear();
+		asio2::tracer::enable(1000);
+
+		ASIO2_CHECK(asio2::tracer::get_sample_rate() == 1000);
+
+		client_recv_counter = 0;
+		client.async_send("trace\n");
+
+		while (client_recv_counter < 10)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		asio2::tracer::disable();
+
+		std::string json2 = asio2::tracer::dump();
+		std::size_t events2 = 0;
+		for (std::size_t pos = json2.find("\"ph\":\"X\""); pos != std::string::npos;
+			pos = json2.find("\"ph\":\"X\"", pos + 1))
+		{
+			++events2;
+		}
+		ASIO2_CHECK_VALUE(events2, events2 < events);
+
+		asio2::tracer::clear();
+
+		std::string json3 = asio2::tracer::dump();
+		ASIO2_CHECK(json3.find("\"ph\":\"X\"") == std::string::npos);
+
+		client.stop();
+		ASIO2_CHECK(client.is_stopped());
+
+		server.stop();
+		ASIO2_CHECK(server.is_stopped());
+	}
+
+	// test async_send_file
+	{
+		std::filesystem::path filepath = std::filesystem::temp_directory_path() / "asio2_send_file_test.bin";
+
+		std::string content(300 * 1024 + 17, '\0');
+		for (std::size_t i = 0; i < content.size(); ++i)
+			content[i] = static_cast<char>('a' + (i * 7 + i / 13) % 26);
+
+		{
+			std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+			file.write(content.data(), std::streamsize(content.size()));
+		}
+
+		asio2::tcp_server server;
+
+		std::atomic<std::size_t> file_sent = 0, part_sent = 0;
+		std::atomic<int> file_callback = 0;
+
+		server.bind_connect([&](std::shared_ptr<asio2::tcp_session>& session_ptr)
+		{
+			// the file is sent in the order of the async_send calls.
+			session_ptr->async_send("head");
+			session_ptr->async_send_file(filepath, 0, 0, [&](std::size_t bytes_sent)
+			{
+				file_sent = bytes_sent;
+				file_callback++;
+			});
+			session_ptr->async_send_file(filepath, 100, 1000, [&](std::size_t bytes_sent)
+			{
+				part_sent = bytes_sent;
+				file_callback++;
+			});
+			session_ptr->async_send_file(filepath.parent_path() / "asio2_send_file_not_exists.bin", 0, 0,
+			[&]()
+			{
+				ASIO2_CHECK(asio2::get_last_error());
+				file_callback++;
+			});
+			session_ptr->async_send("tail");
+		});
+
+		bool server_start_ret = server.start("127.0.0.1", 18043);
+
+		ASIO2_CHECK(server_start_ret);
+
+		asio2::tcp_client client;
+
+		std::string recvd;
+		std::atomic<std::size_t> recvd_size = 0;
+		std::size_t expected = 4 + content.size() + 1000 + 4;
+
+		client.bind_recv([&](std::string_view data)
+		{
+			recvd += data;
+			recvd_size += data.size();
+		});
+
+		bool client_start_ret = client.start("127.0.0.1", 18043);
+
+		ASIO2_CHECK(client_start_ret);
+
+		while (file_callback < 3)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		ASIO2_CHECK_VALUE(file_sent.load(), file_sent == content.size());
+		ASIO2_CHECK_VALUE(part_sent.load(), part_sent == 1000);
+
+		while (recvd_size < expected)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		client.stop();
+		ASIO2_CHECK(client.is_stopped());
+
+		ASIO2_CHECK_VALUE(recvd.size(), recvd.size() == expected);
+		ASIO2_CHECK(recvd == "head" + content + content.substr(100, 1000) + "tail");
+
+		server.stop();
+		ASIO2_CHECK(server.is_stopped());
+
+		std::error_code ec;
+		std::filesystem::remove(filepath, ec);
+	}
+
+	// test send zerocopy
+	{
+		std::string content(500 * 1024 + 13, '\0');
+		for (std::size_t i = 0; i < content.size(); ++i)
+			content[i] = static_cast<char>('a' + (i * 11 + i / 17) % 26);
+
+		asio2::shared_buffer shared(content);
+
+		asio2::tcp_server server;
+
+		std::atomic<std::size_t> shared_sent = 0;
+		std::atomic<int> send_callback = 0;
+
+		server.bind_accept([&](std::shared_ptr<asio2::tcp_session>& session_ptr)
+		{
+			session_ptr->set_send_zerocopy(true, 4096);
+
+			ASIO2_CHECK(session_ptr->is_send_zerocopy());
+			ASIO2_CHECK(session_ptr->get_send_zerocopy_threshold() == 4096);
+		}).bind_connect([&](std::shared_ptr<asio2::tcp_session>& session_ptr)
+		{
+			// the small datas and the datas which are not owned by the framework are sent
+			// by the normal way, and all the datas are still sent in order.
+			session_ptr->async_send("head");
+			session_ptr->async_send(shared, [&](std::size_t bytes_sent)
+			{
+				shared_sent = bytes_sent;
+				send_callback++;
+			});
+			session_ptr->async_send(content, [&]() { send_callback++; });
+			session_ptr->async_send(asio::buffer(content.data(), 10000), [&]() { send_callback++; });
+			session_ptr->async_send(std::vector<char>(content.begin(), content.begin() + 5000));
+			session_ptr->async_send("tail");
+		});
+
+		bool server_start_ret = server.start("127.0.0.1", 18045);
+
+		ASIO2_CHECK(server_start_ret);
+
+		asio2::tcp_client client;
+
+		std::string recvd;
+		std::atomic<std::size_t> recvd_size = 0;
+		std::size_t expected = 4 + content.size() * 2 + 10000 + 5000 + 4;
+
+		client.set_send_zerocopy(true, 4096);
+
+		client.bind_recv([&](std::string_view data)
+		{
+			recvd += data;
+			recvd_size += data.size();
+		});
+
+		bool client_start_ret = client.start("127.0.0.1", 18045);
+
+		ASIO2_CHECK(client_start_ret);
+
+		while (send_callback < 3)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		ASIO2_CHECK_VALUE(shared_sent.load(), shared_sent == content.size());
+
+		while (recvd_size < expected)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		ASIO2_CHECK_VALUE(recvd.size(), recvd.size() == expected);
+		ASIO2_CHECK(recvd == "head" + content + content + content.substr(0, 10000) +
+			content.substr(0, 5000) + "tail");
+
+		// the shared buffer is released after the kernel has released its pages.
+		while (shared.use_count() != 1)
+		{
+			ASIO2_TEST_WAIT_CHECK();
+		}
+
+		client.stop();
+		ASIO2_CHECK(client.is_stopped());
+
+		server.stop();
+		ASIO2_CHECK(server.is_stopped());
+	}
+
 	ASIO2_TEST_END_LOOP;
 }
 